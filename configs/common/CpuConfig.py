@@ -126,6 +126,11 @@ def config_scheme(cpu_cls, cpu_list, options):
                 cpu.moreTransmitInsts = options.moreTransmitInsts
             else:
                 cpu.moreTransmitInsts = 0
+
+            if options.invisible_spec:
+                cpu.invisibleSpec = True
+            else:
+                cpu.invisibleSpec = False
     else:
         print "not DerivO3CPU"
 
@@ -142,7 +147,9 @@ def config_etrace(cpu_cls, cpu_list, options):
             cpu.traceListener = m5.objects.ElasticTrace(
                                 instFetchTraceFile = options.inst_trace_file,
                                 dataDepTraceFile = options.data_trace_file,
-                                depWindowSize = 3 * cpu.numROBEntries)
+                                depWindowSize = 3 * cpu.numROBEntries,
+                                traceTaint = bool(getattr(options,
+                                    "elastic_trace_taint", False)))
             # Make the number of entries in the ROB, LQ and SQ very
             # large so that there are no stalls due to resource
             # limitation as such stalls will get captured in the trace
@@ -125,6 +125,10 @@ def addNoISAOptions(parser):
     parser.add_option("--maxtime", type="float", default=None,
                       help="Run to the specified absolute simulated time in "
                       "seconds")
+    parser.add_option("--eventq-impl", type="choice", default="list",
+                      choices=["list", "calendar"],
+                      help="Data structure used by the main event queues "
+                      "to hold pending events")
 
 # Add common options that assume a non-NULL ISA.
 def addCommonOptions(parser):
@@ -150,6 +154,9 @@ def addCommonOptions(parser):
     parser.add_option("--elastic-trace-en", action="store_true",
                       help="""Enable capture of data dependency and instruction
                       fetch traces using elastic trace probe.""")
+    parser.add_option("--elastic-trace-taint", action="store_true",
+                      help="""Also capture the taint dependencies and control
+                      instructions needed to replay the trace with --STT.""")
     # Trace file paths input to trace probe in a capture simulation and input
     # to Trace CPU in a replay simulation
     parser.add_option("--inst-trace-file", action="store", type="string",
@@ -165,6 +172,10 @@ def addCommonOptions(parser):
     parser.add_option("-V", "--virtualisation", action="store_true")
 
     parser.add_option("--fastmem", action="store_true")
+    parser.add_option("--fetch-block-cache", action="store_true",
+                      help="""Replay decoded basic blocks in the atomic CPU
+                      rather than decoding every instruction, needs
+                      --fastmem""")
 
     # dist-gem5 options
     parser.add_option("--dist", action="store_true",
@@ -281,6 +292,38 @@ def addCommonOptions(parser):
     parser.add_option("--fast-forward-pseudo-inst", action="store_true",
         default=False,
         help="Fast forward before switching until hitting switch_cup insts")
+    parser.add_option("--fast-forward-warmup", action="store", type="int",
+        default=0,
+        help="""Number of instructions at the end of --fast-forward during
+                which the atomic CPU warms the caches and the branch
+                predictor of the CPU switched in""")
+    parser.add_option("--smarts", action="store_true", default=False,
+        help="""Estimate the CPI of --cpu-type by sampling: the atomic CPU
+                warms the caches and the branch predictor functionally, and
+                a sample unit is simulated in detail every --smarts-interval
+                instructions, in a forked process""")
+    parser.add_option("--smarts-interval", action="store", type="int",
+        default=1000000,
+        help="Number of instructions between two sample units")
+    parser.add_option("--smarts-unit", action="store", type="int",
+        default=1000,
+        help="Number of instructions measured in a sample unit")
+    parser.add_option("--smarts-detailed-warmup", action="store", type="int",
+        default=2000,
+        help="Number of instructions simulated in detail before a unit")
+    parser.add_option("--smarts-max-units", action="store", type="int",
+        default=None,
+        help="Stop sampling after this many units")
+    parser.add_option("--smarts-jobs", action="store", type="int", default=1,
+        help="Number of sample units simulated in parallel")
+    parser.add_option("--smarts-threat-models", action="store",
+        type="string", default=None,
+        help="""Comma separated threat models every unit is simulated
+                with, the first one is the baseline the others are
+                compared to (default: --threat_model)""")
+    parser.add_option("--smarts-confidence", action="store", type="float",
+        default=0.997,
+        help="Confidence level of the reported intervals")
     parser.add_option("-S", "--simpoint", action="store_true", default=False,
         help="""Use workload simpoints as an instruction offset for
                 --checkpoint-restore or --take-checkpoint.""")
@@ -309,6 +352,9 @@ def addCommonOptions(parser):
             help="Enable printing ROB content at every cycle")
     parser.add_option("--moreTransmitInsts", default=None, action="store", type="int",
             help="Include more transmit instruction types.")
+    parser.add_option("--invisible_spec", default=None, action="store", type="int",
+            help="Use InvisiSpec spec loads instead of delaying unsafe "
+                 "loads (threat_model mustn't be Unsafe). Needs Ruby.")
 
 def addSEOptions(parser):
     # Benchmark options
@@ -326,6 +372,22 @@ def addSEOptions(parser):
     parser.add_option("--errout", default="",
                       help="Redirect stderr to a file.")
 
+    # Parallel simulation options
+    parser.add_option("--parallel-cores", action="store_true", default=False,
+                      help="Simulate every core and its private Ruby "
+                      "controllers on its own event queue and host thread")
+    parser.add_option("--sim-quantum", type="int", default=None,
+                      metavar="TICKS", help="Synchronization quantum for "
+                      "--parallel-cores (default: one Ruby cycle)")
+    parser.add_option("--nondeterministic-async", action="store_true",
+                      default=False, help="Merge events scheduled across "
+                      "event queues in host arrival order (--parallel-cores)")
+
+    # Decoder options
+    parser.add_option("--decode-cache-dir", default=None, metavar="DIR",
+                      help="Save the x86 decode caches to DIR at exit and "
+                      "load them in later runs of the same binaries")
+
 def addFSOptions(parser):
     from FSConfig import os_types
 
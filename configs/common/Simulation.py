@@ -39,6 +39,9 @@
 #
 # Authors: Lisa Hsu
 
+import copy
+import math
+import os
 import sys
 from os import getcwd
 from os.path import join as joinpath
@@ -78,7 +81,8 @@ def setCPUClass(options):
         if options.restore_with_cpu != options.cpu_type:
             CPUClass = TmpClass
             TmpClass, test_mem_mode = getCPUClass(options.restore_with_cpu)
-    elif options.fast_forward or options.fast_forward_pseudo_inst:
+    elif options.fast_forward or options.fast_forward_pseudo_inst or \
+            options.smarts:
         CPUClass = TmpClass
         TmpClass = AtomicSimpleCPU
         test_mem_mode = 'atomic'
@@ -426,6 +430,186 @@ def repeatSwitch(testsys, repeat_switch_cpu_list, maxtick, switch_freq):
             exit_event = m5.simulate(maxtick - m5.curTick())
             return exit_event
 
+def smartsVariants(options, testsys, cpu_class, switch_cpus):
+    """Returns the (threat model, detailed CPUs) every sample unit is
+    simulated with. The detailed CPUs share the branch predictor the
+    atomic CPU warms."""
+
+    if options.smarts_threat_models:
+        models = options.smarts_threat_models.split(',')
+    elif options.threat_model:
+        models = [options.threat_model]
+    else:
+        models = ['default']
+
+    variants = []
+    for model in models:
+        if model == options.threat_model or model == 'default':
+            cpus = switch_cpus
+        else:
+            if not issubclass(cpu_class, DerivO3CPU):
+                fatal("Threat models need DerivO3CPU")
+            cpus = [cpu_class(switched_out=True, cpu_id=0)]
+            cpus[0].system = testsys
+            cpus[0].workload = testsys.cpu[0].workload
+            cpus[0].clk_domain = testsys.cpu[0].clk_domain
+            cpus[0].isa = testsys.cpu[0].isa
+            # STT and InvisiSpec need a threat model to protect against
+            model_options = copy.copy(options)
+            model_options.threat_model = model
+            if model == 'UnsafeBaseline':
+                model_options.STT = 0
+                model_options.invisible_spec = 0
+            CpuConfig.config_scheme(cpu_class, cpus, model_options)
+            setattr(testsys, 'smarts_cpus_' + model.lower(), cpus)
+        variants.append((model, cpus))
+
+    testsys.cpu[0].warmup_all = True
+    if hasattr(switch_cpus[0], 'branchPred'):
+        testsys.cpu[0].branchPred = switch_cpus[0].branchPred
+        for model, cpus in variants:
+            cpus[0].branchPred = switch_cpus[0].branchPred
+    return variants
+
+def smartsMeasure(options, testsys, cpus, maxtick, path):
+    """Simulates a sample unit in a forked process and writes its number
+    of instructions and cycles to path, nothing if the workload exits
+    before its end. Never returns. The stats are not dumped, their
+    output is shared with the parent."""
+
+    m5.switchCpus(testsys, [(testsys.cpu[0], cpus[0])], verbose=False)
+    cpu = cpus[0]
+    result = None
+
+    cpu.scheduleInstStop(0, options.smarts_detailed_warmup, "smarts warmup")
+    exit_event = m5.simulate(maxtick - m5.curTick())
+    if exit_event.getCause() == "smarts warmup":
+        insts = cpu.totalInsts()
+        cycles = cpu.getCurrentCycleCount()
+        cpu.scheduleInstStop(0, options.smarts_unit, "smarts unit")
+        exit_event = m5.simulate(maxtick - m5.curTick())
+        if exit_event.getCause() == "smarts unit":
+            result = (cpu.totalInsts() - insts,
+                      cpu.getCurrentCycleCount() - cycles)
+
+    f = open(path, 'w')
+    if result:
+        f.write('%d %d\n' % result)
+    f.close()
+    sys.stdout.flush()
+    os._exit(0)
+
+def normalQuantile(p):
+    lo, hi = -10.0, 10.0
+    for i in xrange(100):
+        mid = (lo + hi) / 2
+        if 0.5 * (1 + math.erf(mid / math.sqrt(2))) < p:
+            lo = mid
+        else:
+            hi = mid
+    return lo
+
+def meanInterval(samples, z):
+    """Returns the mean of samples and the half width of its confidence
+    interval."""
+    n = len(samples)
+    mean = sum(samples) / n
+    if n < 2:
+        return mean, float('inf')
+    var = sum((x - mean) ** 2 for x in samples) / (n - 1)
+    return mean, z * math.sqrt(var / n)
+
+def smartsReport(options, models, cpis):
+    """Prints the CPI estimates of the threat models and their difference
+    with the first one, over the units measured with all of them."""
+
+    units = set(cpis[models[0]])
+    for model in models[1:]:
+        units &= set(cpis[model])
+    units = sorted(units)
+    z = normalQuantile(0.5 + options.smarts_confidence / 2)
+
+    lines = ["SMARTS: %d units, %.1f%% confidence" %
+             (len(units), 100 * options.smarts_confidence)]
+    if not units:
+        lines.append("no complete unit")
+    else:
+        base = [cpis[models[0]][u] for u in units]
+        base_mean, base_half = meanInterval(base, z)
+        for model in models:
+            samples = [cpis[model][u] for u in units]
+            mean, half = meanInterval(samples, z)
+            lines.append("%s: CPI %.4f +- %.4f (+- %.2f%%), IPC %.4f" %
+                         (model, mean, half, 100 * half / mean, 1 / mean))
+            if model == models[0]:
+                continue
+            # Paired units give a tighter interval than the two above
+            diffs = [cpis[model][u] - cpis[models[0]][u] for u in units]
+            diff, diff_half = meanInterval(diffs, z)
+            lines.append("%s: overhead over %s %.2f%% +- %.2f%%" %
+                         (model, models[0], 100 * diff / base_mean,
+                          100 * diff_half / base_mean))
+
+    f = open(joinpath(m5.options.outdir, 'smarts.txt'), 'w')
+    for line in lines:
+        print line
+        f.write(line + '\n')
+    f.close()
+
+def smartsSample(options, testsys, variants, maxtick):
+    """SMARTS-style sampling. The atomic CPU runs the workload and warms
+    the caches and the branch predictor; every --smarts-interval
+    instructions, a process is forked for each threat model to simulate
+    a detailed warmup and a measurement unit from the current state."""
+
+    models = [model for model, cpus in variants]
+    cpis = dict((model, {}) for model in models)
+    children = {}
+
+    def reap():
+        pid, status = os.waitpid(-1, 0)
+        unit, model, path = children.pop(pid)
+        try:
+            f = open(path)
+            result = f.read().split()
+            f.close()
+        except IOError:
+            result = None
+        if status != 0 or not result:
+            warn("SMARTS unit %d (%s) did not complete" % (unit, model))
+            return
+        insts, cycles = int(result[0]), int(result[1])
+        cpis[model][unit] = float(cycles) / insts
+
+    print "starting SMARTS sampling"
+    unit = 0
+    while options.smarts_max_units is None or \
+          unit < options.smarts_max_units:
+        testsys.cpu[0].scheduleInstStop(0, options.smarts_interval,
+                                        "smarts interval")
+        exit_event = m5.simulate(maxtick - m5.curTick())
+        if exit_event.getCause() != "smarts interval":
+            break
+
+        for model, cpus in variants:
+            while len(children) >= options.smarts_jobs:
+                reap()
+            sys.stdout.flush()
+            pid = m5.fork("%%(parent)s/smarts.%d.%s" % (unit, model))
+            if pid == 0:
+                smartsMeasure(options, testsys, cpus, maxtick,
+                              joinpath(m5.options.outdir, "unit.txt"))
+            children[pid] = (unit, model,
+                             joinpath(m5.options.outdir,
+                                      "smarts.%d.%s" % (unit, model),
+                                      "unit.txt"))
+        unit += 1
+
+    while children:
+        reap()
+    smartsReport(options, models, cpis)
+    return exit_event
+
 def run(options, root, testsys, cpu_class):
     if options.checkpoint_dir:
         cptdir = options.checkpoint_dir
@@ -449,6 +633,26 @@ def run(options, root, testsys, cpu_class):
     if options.repeat_switch and options.take_checkpoints:
         fatal("Can't specify both --repeat-switch and --take-checkpoints")
 
+    if options.smarts:
+        if options.fast_forward or options.fast_forward_pseudo_inst or \
+           options.standard_switch or options.repeat_switch or \
+           options.take_checkpoints or options.take_simpoint_checkpoints:
+            fatal("--smarts can only be combined with --checkpoint-restore")
+        if options.num_cpus != 1:
+            fatal("--smarts supports a single CPU")
+        if options.smarts_max_units is not None and \
+           options.smarts_max_units < 1:
+            fatal("--smarts-max-units must be positive")
+        # The atomic CPU warms Ruby with the warm-state hooks
+        if options.ruby and buildEnv['PROTOCOL'] != 'MESI_Two_Level':
+            fatal("--smarts with --ruby needs a protocol with functional "
+                  "warmup (MESI_Two_Level)")
+        # Host threads do not survive the forks of the sample units
+        if getattr(options, 'parallel_cores', False) or \
+           (options.ruby and (options.ruby_controller_threads or
+                              options.ruby_address_trace)):
+            fatal("--smarts can't be used with host threads")
+
     np = options.num_cpus
     switch_cpus = None
 
@@ -475,6 +679,15 @@ def run(options, root, testsys, cpu_class):
         for i in xrange(np):
             if options.fast_forward:
                 testsys.cpu[i].max_insts_any_thread = int(options.fast_forward)
+            if options.fast_forward_warmup:
+                if not options.fast_forward or \
+                   not isinstance(testsys.cpu[i], AtomicSimpleCPU):
+                    fatal("--fast-forward-warmup requires --fast-forward "
+                          "with the atomic CPU")
+                testsys.cpu[i].warmup_insts = options.fast_forward_warmup
+                # The predictor is shared, it needs no hand over
+                if hasattr(switch_cpus[i], 'branchPred'):
+                    testsys.cpu[i].branchPred = switch_cpus[i].branchPred
             switch_cpus[i].system = testsys
             switch_cpus[i].workload = testsys.cpu[i].workload
             switch_cpus[i].clk_domain = testsys.cpu[i].clk_domain
@@ -496,6 +709,13 @@ def run(options, root, testsys, cpu_class):
         testsys.switch_cpus = switch_cpus
         switch_cpu_list = [(testsys.cpu[i], switch_cpus[i]) for i in xrange(np)]
 
+    if options.smarts:
+        if not cpu_class or not isinstance(testsys.cpu[0], AtomicSimpleCPU):
+            fatal("--smarts needs the atomic CPU for functional warming, "
+                  "and another --cpu-type")
+        smarts_variants = smartsVariants(options, testsys, cpu_class,
+                                         switch_cpus)
+
     if options.repeat_switch:
         switch_class = getCPUClass(options.cpu_type)[0]
         if switch_class.require_caches() and \
@@ -606,6 +826,9 @@ def run(options, root, testsys, cpu_class):
     checkpoint_dir = None
     if options.checkpoint_restore:
         cpt_starttick, checkpoint_dir = findCptDir(options, cptdir, testsys)
+    if options.smarts:
+        # The simulator can't be forked with listeners enabled
+        m5.disableAllListeners()
     m5.instantiate(checkpoint_dir)
 
     # Initialization is complete.  If we're not in control of simulation
@@ -650,7 +873,7 @@ def run(options, root, testsys, cpu_class):
         fatal("Bad maxtick (%d) specified: " \
               "Checkpoint starts starts from tick: %d", maxtick, cpt_starttick)
 
-    if options.standard_switch or cpu_class:
+    if (options.standard_switch or cpu_class) and not options.smarts:
         if options.standard_switch:
             print "Switch at instruction count:%s" % \
                     str(testsys.cpu[0].max_insts_any_thread)
@@ -726,6 +949,9 @@ def run(options, root, testsys, cpu_class):
         if options.repeat_switch and maxtick > options.repeat_switch:
             exit_event = repeatSwitch(testsys, repeat_switch_cpu_list,
                                       maxtick, options.repeat_switch)
+        elif options.smarts:
+            exit_event = smartsSample(options, testsys, smarts_variants,
+                                      maxtick)
         else:
             exit_event = benchCheckpoints(options, maxtick, cptdir)
 
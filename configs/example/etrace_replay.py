@@ -113,6 +113,13 @@ for cpu in system.cpu:
 system.cpu.instTraceFile=options.inst_trace_file
 system.cpu.dataTraceFile=options.data_trace_file
 
+# Replay with STT, the data trace must have been captured with
+# --elastic-trace-taint
+if options.STT:
+    system.cpu.STT = True
+    if options.threat_model:
+        system.cpu.threatModel = options.threat_model
+
 # Configure the classic memory system options
 MemClass = Simulation.setMemClass(options)
 system.membus = SystemXBar()
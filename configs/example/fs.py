@@ -363,6 +363,8 @@ else:
 if options.timesync:
     root.time_sync_enable = True
 
+root.eventq_impl = options.eventq_impl
+
 if options.frame_capture:
     VncServer.frame_capture = True
 
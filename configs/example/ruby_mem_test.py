@@ -55,6 +55,9 @@ parser.add_option("--progress", type="int", default=1000,
 parser.add_option("--num-dmas", type="int", default=0, help="# of dma testers")
 parser.add_option("--functional", type="int", default=0,
                   help="percentage of accesses that should be functional")
+parser.add_option("--functional-range", action="store_true",
+                  help="send the functional accesses as ranges, which \
+                  the functional filter of Ruby can serve from memory")
 parser.add_option("--suppress-func-warnings", action="store_true",
                   help="suppress warnings when functional accesses fail")
 
@@ -99,6 +102,7 @@ cpus = [ MemTest(atomic = False,
                  issue_dmas = False,
                  percent_functional = options.functional,
                  percent_uncacheable = 0,
+                 functional_range = options.functional_range,
                  progress_interval = options.progress,
                  suppress_func_warnings = options.suppress_func_warnings) \
          for i in xrange(options.num_cpus) ]
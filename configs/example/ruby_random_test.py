@@ -51,6 +51,9 @@ parser.add_option("--maxloads", metavar="N", default=100,
                   help="Stop after N loads")
 parser.add_option("-f", "--wakeup_freq", metavar="N", default=10,
                   help="Wakeup every N cycles")
+parser.add_option("--spec-checks", action="store_true",
+                  help="Check speculative loads and their exposes too "
+                       "(protocols with GETSPEC/EXPOSE only)")
 
 #
 # Add the ruby specific and protocol specific options
@@ -89,7 +92,8 @@ if buildEnv['PROTOCOL'] == 'MOESI_hammer':
 
 tester = RubyTester(check_flush = check_flush,
                     checks_to_complete = options.maxloads,
-                    wakeup_frequency = options.wakeup_freq)
+                    wakeup_frequency = options.wakeup_freq,
+                    spec_checks = options.spec_checks)
 
 #
 # Create the M5 system.  Note that the Memory Object isn't
@@ -42,6 +42,7 @@
 #
 # "m5 test.py"
 
+import hashlib
 import optparse
 import sys
 import os
@@ -249,6 +250,25 @@ for i in xrange(np):
 
     system.cpu[i].createThreads()
 
+if options.decode_cache_dir:
+    if buildEnv['TARGET_ISA'] != 'x86':
+        fatal("--decode-cache-dir is only supported on x86")
+
+    # The caches of all the cores go in one file, named after the hash
+    # of the binaries that run on them. The file holds one cache per
+    # processor mode (m5Reg).
+    digest = hashlib.sha1()
+    for process in multiprocesses:
+        with open(process.executable, 'rb') as f:
+            digest.update(f.read())
+    if not os.path.isdir(options.decode_cache_dir):
+        os.makedirs(options.decode_cache_dir)
+    decode_cache = os.path.join(options.decode_cache_dir,
+                                digest.hexdigest() + ".dcache")
+    for cpu in system.cpu:
+        for isa in cpu.isa:
+            isa.decode_cache = decode_cache
+
 if options.ruby:
     Ruby.create_system(options, False, system)
     assert(options.num_cpus == len(system.ruby._cpu_ports))
@@ -283,5 +303,24 @@ else:
 if CPUClass == DerivO3CPU:
     CpuConfig.config_scheme(CPUClass, system.cpu, options)
 
-root = Root(full_system = False, system = system)
+root = Root(full_system = False, system = system,
+            eventq_impl = options.eventq_impl)
+
+if options.parallel_cores:
+    if not options.ruby:
+        fatal("--parallel-cores requires --ruby")
+    if len(multiprocesses) != np or options.smt:
+        fatal("--parallel-cores requires one process per core")
+
+    Ruby.assign_core_event_queues(system)
+    if options.sim_quantum:
+        root.sim_quantum = options.sim_quantum
+    else:
+        # One Ruby cycle is the shortest latency of any message buffer
+        # between a core's L1 and the shared part of the hierarchy.
+        m5.ticks.fixGlobalFrequency()
+        root.sim_quantum = m5.ticks.fromSeconds(
+            1.0 / m5.util.convert.toFrequency(options.ruby_clock))
+    root.deterministic_async = not options.nondeterministic_async
+
 Simulation.run(options, root, system, FutureClass)
@@ -339,6 +339,9 @@ if options.fastmem:
     if (options.caches or options.l2cache):
         fatal("You cannot use fastmem in combination with caches!")
 
+if options.fetch_block_cache and not options.fastmem:
+    fatal("The fetch block cache needs fastmem")
+
 if options.simpoint_profile:
     if not options.fastmem:
         # Atomic CPU checked with fastmem option already
@@ -359,6 +362,7 @@ for i in xrange(np):
 
     if options.fastmem:
         system.cpu[i].fastmem = True
+        system.cpu[i].fetch_block_cache = bool(options.fetch_block_cache)
 
     if options.simpoint_profile:
         system.cpu[i].addSimPointProbe(options.simpoint_interval)
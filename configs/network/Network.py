@@ -73,6 +73,11 @@ def define_options(parser):
     parser.add_option("--garnet-deadlock-threshold", action="store",
                       type="int", default=50000,
                       help="network-level deadlock threshold.")
+    parser.add_option("--no-garnet-active-scheduling", action="store_true",
+                      default=False,
+                      help="""schedule one event per garnet router, link
+                            and NI wakeup, instead of servicing them from
+                            a per-network active list.""")
 
 
 def create_network(options, ruby):
@@ -107,6 +112,8 @@ def init_network(options, network, InterfaceClass):
         network.ni_flit_size = options.link_width_bits / 8
         network.routing_algorithm = options.routing_algorithm
         network.garnet_deadlock_threshold = options.garnet_deadlock_threshold
+        network.active_scheduling = \
+            not options.no_garnet_active_scheduling
 
     if options.network == "simple":
         network.setup_buffers()
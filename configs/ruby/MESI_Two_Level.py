@@ -144,6 +144,7 @@ def create_system(options, full_system, system, dma_ports, ruby_system):
 
         l2_cntrl = L2Cache_Controller(version = i,
                                       L2cache = l2_cache,
+                                      l2_select_num_bits = l2_bits,
                                       transitions_per_cycle = options.ports,
                                       ruby_system = ruby_system)
 
@@ -176,6 +177,8 @@ def create_system(options, full_system, system, dma_ports, ruby_system):
     dir_cntrl_nodes = create_directories(options, system.mem_ranges,
                                          ruby_system)
     for dir_cntrl in dir_cntrl_nodes:
+        dir_cntrl.l2_select_num_bits = l2_bits
+
         # Connect the directory controllers and the network
         dir_cntrl.requestToDir = MessageBuffer()
         dir_cntrl.requestToDir.slave = ruby_system.network.master
@@ -230,5 +233,9 @@ def create_system(options, full_system, system, dma_ports, ruby_system):
         all_cntrls = all_cntrls + [io_controller]
 
     ruby_system.network.number_of_virtual_networks = 3
+
+    # The directory keeps no data of its own, so functional accesses to
+    # lines no cache holds can be served from the backing store.
+    ruby_system.functional_filter = True
     topology = create_topology(all_cntrls, options)
     return (cpu_sequencers, dir_cntrl_nodes, topology)
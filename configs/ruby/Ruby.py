@@ -79,11 +79,46 @@ def define_options(parser):
     parser.add_option("--enable-prefetch", action="store_true", default=False,
                       help="Enable Ruby HW Prefetcher")
 
+    parser.add_option("--ruby-warm-state", action="store", type="string",
+                      default="",
+                      help="Load the caches from a warm-state snapshot, "
+                           "e.g., the system.ruby.warm.gz of a checkpoint")
+
+    parser.add_option("--ruby-address-trace", action="store", type="string",
+                      default="",
+                      help="Write the requests and controller transitions "
+                           "to this file in the output directory, "
+                           "e.g., addr_trace.gz")
+    parser.add_option("--ruby-controller-threads", action="store",
+                      type="int", default=0,
+                      help="Evaluate the controllers woken up in the same "
+                           "cycle on this many host threads (0: serially, "
+                           "one event per wakeup)")
+    parser.add_option("--ruby-controller-check", action="store_true",
+                      default=False,
+                      help="Panic if the parallel evaluation of the "
+                           "controllers could differ from a serial one")
+
     protocol = buildEnv['PROTOCOL']
     exec "import %s" % protocol
     eval("%s.define_options(parser)" % protocol)
     Network.define_options(parser)
 
+def assign_core_event_queues(system):
+    """Put every CPU, together with its sequencer and the controller
+    owning that sequencer (i.e., its private L1), on an event queue of
+    its own. Shared controllers and the network stay on queue 0 and
+    communicate with the cores through message buffers, whose latency
+    must be at least one simulation quantum."""
+    for i, cpu in enumerate(system.cpu):
+        cpu.eventq_index = i + 1
+        seq = system.ruby._cpu_ports[i]
+        cntrl = seq.get_parent()
+        if not isinstance(cntrl, RubyController):
+            fatal("Sequencer %s is not owned by a controller, " \
+                  "can't run cores in parallel" % seq.get_name())
+        cntrl.eventq_index = i + 1
+
 def setup_memory_controllers(system, ruby, dir_cntrls, options):
     ruby.block_size_bytes = options.cacheline_size
     ruby.memory_size_bits = 48
@@ -189,9 +224,20 @@ def create_system(options, full_system, system, piobus = None, dma_ports = []):
             if buildEnv['TARGET_ISA'] == "x86":
                 cpu_seq.pio_slave_port = piobus.master
 
+    # [SafeSpec] The spec buffer of a sequencer is indexed by the load
+    # queue index of its core
+    for cpu_seq, cpu in zip(cpu_sequencers, getattr(system, 'cpu', [])):
+        lq_entries = getattr(cpu, 'LQEntries', None)
+        if lq_entries is not None:
+            cpu_seq.spec_buffer_size = int(lq_entries) + 1
+
     ruby.number_of_virtual_networks = ruby.network.number_of_virtual_networks
     ruby._cpu_ports = cpu_sequencers
     ruby.num_of_sequencers = len(cpu_sequencers)
+    ruby.warm_state = options.ruby_warm_state
+    ruby.address_trace = options.ruby_address_trace
+    ruby.controller_threads = options.ruby_controller_threads
+    ruby.controller_check = options.ruby_controller_check
 
     # Create a backing copy of physical memory in case required
     if options.access_backing_store:
@@ -35,9 +35,14 @@
 #
 # Authors: Andreas Sandberg
 
+from m5.params import *
 from m5.SimObject import SimObject
 
 class X86ISA(SimObject):
     type = 'X86ISA'
     cxx_class = 'X86ISA::ISA'
     cxx_header = "arch/x86/isa.hh"
+
+    decode_cache = Param.String("", "File to load decoded instructions "
+        "from, and to save them to at exit, to avoid decoding the same "
+        "binary again in every run")
@@ -30,11 +30,20 @@
 
 #include "arch/x86/decoder.hh"
 
+#include <unistd.h>
+
+#include <cstdio>
+#include <fstream>
+#include <map>
+
 #include "arch/x86/regs/misc.hh"
+#include "base/callback.hh"
+#include "base/cprintf.hh"
 #include "base/logging.hh"
 #include "base/trace.hh"
 #include "base/types.hh"
 #include "debug/Decoder.hh"
+#include "sim/core.hh"
 
 namespace X86ISA
 {
@@ -677,6 +686,205 @@ Decoder::doImmediateState()
 
 Decoder::InstBytes Decoder::dummy;
 Decoder::InstCacheMap Decoder::instCacheMap;
+Decoder::SavedCacheMap Decoder::savedCacheMap;
+std::string Decoder::cacheFile;
+std::set<Decoder *> Decoder::decoders;
+
+namespace
+{
+
+const char *cacheMagic = "gem5-x86-decode-cache";
+const int cacheVersion = 1;
+
+class SaveCacheCallback : public Callback
+{
+  public:
+    void process() { Decoder::saveCache(); delete this; }
+};
+
+} // anonymous namespace
+
+void
+Decoder::setCacheFile(const std::string &file)
+{
+    if (file == cacheFile)
+        return;
+    if (!cacheFile.empty())
+        fatal("Decode cache file set to both %s and %s.\n", cacheFile, file);
+
+    cacheFile = file;
+    registerExitCallback(new SaveCacheCallback);
+
+    std::ifstream is(file);
+    if (!is) {
+        inform("Decode cache %s will be created at exit.\n", file);
+        return;
+    }
+
+    std::string magic;
+    int version;
+    if (!(is >> magic >> version) || magic != cacheMagic ||
+            version != cacheVersion) {
+        warn("Ignoring decode cache %s with an unknown format.\n", file);
+        return;
+    }
+
+    // Each mode is a line "mode <m5Reg> <count>" followed by one line
+    // per instruction: address, last offset, the chunks and masks, and
+    // the fields of the ExtMachInst.
+    std::string tag;
+    CacheKey key;
+    size_t count;
+    size_t total = 0;
+    while (is >> tag >> std::hex >> key >> std::dec >> count) {
+        if (tag != "mode")
+            break;
+
+        std::vector<SavedInst> &insts = savedCacheMap[key];
+        for (size_t i = 0; i < count; i++) {
+            SavedInst inst;
+            size_t num_chunks;
+            is >> std::hex >> inst.addr >> std::dec >> inst.lastOffset >>
+                num_chunks;
+            inst.chunks.resize(num_chunks);
+            inst.masks.resize(num_chunks);
+            for (auto &chunk : inst.chunks)
+                is >> std::hex >> chunk;
+            for (auto &mask : inst.masks)
+                is >> std::hex >> mask;
+
+            uint64_t legacy, rex, vex, type, op, modrm, sib, mode;
+            unsigned op_size, addr_size, stack_size, disp_size;
+            is >> std::hex >> legacy >> rex >> vex >> type >> op >> modrm >>
+                sib >> inst.emi.immediate >> inst.emi.displacement >>
+                std::dec >> op_size >> addr_size >> stack_size >>
+                disp_size >> std::hex >> mode;
+            if (!is || num_chunks == 0) {
+                is.setstate(std::ios::failbit);
+                break;
+            }
+
+            inst.emi.legacy = legacy;
+            inst.emi.rex = rex;
+            inst.emi.vex = vex;
+            inst.emi.opcode.type = (OpcodeType)type;
+            inst.emi.opcode.op = op;
+            inst.emi.modRM = modrm;
+            inst.emi.sib = sib;
+            inst.emi.opSize = op_size;
+            inst.emi.addrSize = addr_size;
+            inst.emi.stackSize = stack_size;
+            inst.emi.dispSize = disp_size;
+            inst.emi.mode = mode;
+            insts.push_back(inst);
+        }
+        total += insts.size();
+    }
+
+    if (!is.eof()) {
+        warn("Ignoring decode cache %s, it is corrupt.\n", file);
+        savedCacheMap.clear();
+        return;
+    }
+
+    inform("Loaded %d instructions from decode cache %s.\n", total, file);
+}
+
+void
+Decoder::saveCache()
+{
+    // Merge the decode pages of all the decoders, ordered by mode and
+    // address so the file doesn't depend on the order of the hash
+    // maps.
+    std::map<CacheKey, std::map<Addr, SavedInst> > merged;
+    for (Decoder *decoder : decoders) {
+        for (const auto &am : decoder->addrCacheMap) {
+            InstCacheMap::const_iterator imIter = instCacheMap.find(am.first);
+            if (imIter == instCacheMap.end())
+                continue;
+
+            // Find the ExtMachInst each StaticInst was decoded from.
+            std::unordered_map<const StaticInst *, const ExtMachInst *> emis;
+            for (const auto &im : *imIter->second)
+                emis[im.second.get()] = &im.first;
+
+            std::map<Addr, SavedInst> &insts = merged[am.first];
+            am.second->forEach([&](Addr addr, const InstBytes &bytes) {
+                if (!bytes.si || bytes.chunks.empty() ||
+                        bytes.chunks.size() != bytes.masks.size() ||
+                        insts.count(addr)) {
+                    return;
+                }
+                auto emi = emis.find(bytes.si.get());
+                if (emi == emis.end())
+                    return;
+                insts[addr] = SavedInst{addr, bytes.chunks, bytes.masks,
+                                        bytes.lastOffset, *emi->second};
+            });
+        }
+    }
+
+    // Several simulations of the same binary may share a cache file,
+    // so write a temporary file and move it into place.
+    std::string tmp_file = csprintf("%s.%d", cacheFile, getpid());
+    std::ofstream os(tmp_file);
+    if (!os) {
+        warn("Unable to write decode cache %s.\n", tmp_file);
+        return;
+    }
+
+    os << cacheMagic << " " << cacheVersion << "\n";
+    for (const auto &mode : merged) {
+        os << "mode " << std::hex << mode.first << std::dec << " " <<
+            mode.second.size() << "\n";
+        for (const auto &entry : mode.second) {
+            const SavedInst &inst = entry.second;
+            const ExtMachInst &emi = inst.emi;
+            os << std::hex << inst.addr << std::dec << " " <<
+                inst.lastOffset << " " << inst.chunks.size() << std::hex;
+            for (MachInst chunk : inst.chunks)
+                os << " " << chunk;
+            for (MachInst mask : inst.masks)
+                os << " " << mask;
+            os << " " << (uint64_t)emi.legacy << " " << (uint64_t)emi.rex <<
+                " " << (uint64_t)emi.vex << " " <<
+                (uint64_t)emi.opcode.type << " " <<
+                (uint64_t)emi.opcode.op << " " << (uint64_t)emi.modRM <<
+                " " << (uint64_t)emi.sib << " " << emi.immediate << " " <<
+                emi.displacement << std::dec << " " <<
+                (unsigned)emi.opSize << " " << (unsigned)emi.addrSize <<
+                " " << (unsigned)emi.stackSize << " " <<
+                (unsigned)emi.dispSize << " " << std::hex <<
+                (uint64_t)emi.mode << std::dec << "\n";
+        }
+    }
+
+    os.close();
+    if (!os || std::rename(tmp_file.c_str(), cacheFile.c_str()) != 0) {
+        warn("Unable to write decode cache %s.\n", cacheFile);
+        std::remove(tmp_file.c_str());
+    }
+}
+
+void
+Decoder::warmCache(CacheKey key)
+{
+    SavedCacheMap::const_iterator it = savedCacheMap.find(key);
+    if (it == savedCacheMap.end())
+        return;
+
+    // The chunks are checked against memory before a cached
+    // instruction is used, so stale entries just miss.
+    for (const SavedInst &inst : it->second) {
+        InstBytes &bytes = decodePages->lookup(inst.addr);
+        bytes.chunks = inst.chunks;
+        bytes.masks = inst.masks;
+        bytes.lastOffset = inst.lastOffset;
+        bytes.si = decode(inst.emi, inst.addr);
+    }
+    DPRINTF(Decoder, "Warmed the decode cache with %d instructions.\n",
+            it->second.size());
+}
 
 StaticInstPtr
 Decoder::decode(ExtMachInst mach_inst, Addr addr)
@@ -32,6 +32,8 @@
 #define __ARCH_X86_DECODER_HH__
 
 #include <cassert>
+#include <set>
+#include <string>
 #include <unordered_map>
 #include <vector>
 
@@ -233,6 +235,29 @@ class Decoder
     typedef std::unordered_map<CacheKey, DecodeCache::InstMap *> InstCacheMap;
     static InstCacheMap instCacheMap;
 
+    /// Persistent decode caches. The decode pages of all decoders can
+    /// be saved to a file at exit and loaded in the next run of the
+    /// same binary, so decoding happens when the file is loaded
+    /// rather than during simulation. StaticInsts can't be stored, so
+    /// the file keeps the bytes and masks of each instruction along
+    /// with its ExtMachInst, which is decoded again when loaded.
+    struct SavedInst
+    {
+        Addr addr;
+        std::vector<MachInst> chunks;
+        std::vector<MachInst> masks;
+        int lastOffset;
+        ExtMachInst emi;
+    };
+    typedef std::unordered_map<CacheKey, std::vector<SavedInst> >
+        SavedCacheMap;
+    static SavedCacheMap savedCacheMap;
+    static std::string cacheFile;
+    static std::set<Decoder *> decoders;
+
+    /// Fill the decode pages of the current mode from the saved cache.
+    void warmCache(CacheKey key);
+
   public:
     Decoder(ISA* isa = nullptr) : basePC(0), origPC(0), offset(0),
         outOfBytes(true), instDone(false),
@@ -251,8 +276,20 @@ class Decoder
         instBytes = &dummy;
         decodePages = NULL;
         instMap = NULL;
+        decoders.insert(this);
+    }
+
+    ~Decoder()
+    {
+        decoders.erase(this);
     }
 
+    /// Load the decode caches from a file, if it exists, and save them
+    /// to the same file when the simulator exits.
+    static void setCacheFile(const std::string &file);
+    /// Save the decode caches of all decoders to the cache file.
+    static void saveCache();
+
     void setM5Reg(HandyM5Reg m5Reg)
     {
         mode = (X86Mode)(uint64_t)m5Reg.mode;
@@ -265,12 +302,14 @@ class Decoder
         defAddr = m5Reg.defAddr;
         stack = m5Reg.stack;
 
+        bool new_pages = false;
         AddrCacheMap::iterator amIter = addrCacheMap.find(m5Reg);
         if (amIter != addrCacheMap.end()) {
             decodePages = amIter->second;
         } else {
             decodePages = new DecodePages;
             addrCacheMap[m5Reg] = decodePages;
+            new_pages = true;
         }
 
         InstCacheMap::iterator imIter = instCacheMap.find(m5Reg);
@@ -280,6 +319,9 @@ class Decoder
             instMap = new DecodeCache::InstMap;
             instCacheMap[m5Reg] = instMap;
         }
+
+        if (new_pages && !savedCacheMap.empty())
+            warmCache(m5Reg);
     }
 
     void takeOverFrom(Decoder *old)
@@ -116,6 +116,9 @@ ISA::ISA(Params *p)
     : SimObject(p)
 {
     clear();
+
+    if (!p->decode_cache.empty())
+        Decoder::setCacheFile(p->decode_cache);
 }
 
 const X86ISAParams *
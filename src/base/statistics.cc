@@ -376,11 +376,31 @@ HistStor::add(HistStor *hs)
         cvec[i] += hs->cvec[i];
 }
 
+/** Number of the dump in progress, zero outside of dumps. */
+static uint64_t currentDump = 0;
+static uint64_t numDumps = 0;
+
+void
+beginDump()
+{
+    currentDump = ++numDumps;
+}
+
+void
+endDump()
+{
+    currentDump = 0;
+    for (Info *info : statsList())
+        info->clean();
+}
+
 Formula::Formula()
+    : memoTotal(0.0), memoResultDump(0), memoTotalDump(0)
 {
 }
 
 Formula::Formula(Temp r)
+    : memoTotal(0.0), memoResultDump(0), memoTotalDump(0)
 {
     root = r.getNodePtr();
     setInit();
@@ -424,14 +444,35 @@ Formula::operator/=(Temp r)
 void
 Formula::result(VResult &vec) const
 {
-    if (root)
+    if (!root)
+        return;
+
+    if (!currentDump) {
         vec = root->result();
+        return;
+    }
+
+    if (memoResultDump != currentDump) {
+        memoResult = root->result();
+        memoResultDump = currentDump;
+    }
+    vec = memoResult;
 }
 
 Result
 Formula::total() const
 {
-    return root ? root->total() : 0.0;
+    if (!root)
+        return 0.0;
+
+    if (!currentDump)
+        return root->total();
+
+    if (memoTotalDump != currentDump) {
+        memoTotal = root->total();
+        memoTotalDump = currentDump;
+    }
+    return memoTotal;
 }
 
 size_type
@@ -90,8 +90,16 @@ class InfoProxy : public Base
     InfoProxy(Stat &stat) : s(stat) {}
 
     bool check() const { return s.check(); }
-    void prepare() { s.prepare(); }
+    void
+    prepare()
+    {
+        // The prepared data of a clean stat is still up to date
+        if (s.dirty())
+            s.prepare();
+    }
     void reset() { s.reset(); }
+    bool dirty() const { return s.dirty(); }
+    void clean() { s.clean(); }
     void
     visit(Output &visitor)
     {
@@ -197,6 +205,17 @@ class InfoAccess
      */
     bool zero() const { return true; }
 
+    /**
+     * @return true if this stat may have changed since the end of the
+     * last dump. Stats without storage are always dirty.
+     */
+    bool dirty() const { return true; }
+
+    /**
+     * Called at the end of each dump to start tracking changes again.
+     */
+    void clean() { }
+
     /**
      * Check that this stat has been set up properly and is ready for
      * use
@@ -214,6 +233,13 @@ class DataWrap : public InfoAccess
   protected:
     Derived &self() { return *static_cast<Derived *>(this); }
 
+    /**
+     * Set whenever the storage of the stat is written and cleared at
+     * the end of each dump, so that dumps can skip the work for stats
+     * that haven't changed. Only used by stats with storage.
+     */
+    bool _dirty;
+
   protected:
     Info *
     info()
@@ -241,6 +267,7 @@ class DataWrap : public InfoAccess
 
   public:
     DataWrap()
+        : _dirty(true)
     {
         this->setInfo(new Info(self()));
     }
@@ -409,8 +436,19 @@ class DataWrapVec : public DataWrap<Derived, InfoProxyType>
         Info *info = this->info();
 
         size_t size = self.size();
-        for (off_type i = 0; i < size; ++i)
+        for (off_type i = 0; i < size; ++i) {
+            if (!self.data(i)->zero())
+                this->_dirty = true;
             self.data(i)->reset(info);
+        }
+    }
+
+    bool dirty() const { return this->_dirty; }
+
+    void
+    clean()
+    {
+        this->_dirty = Derived::Storage::timeDependent;
     }
 };
 
@@ -474,6 +512,9 @@ class StatStor
   public:
     struct Params : public StorageParams {};
 
+    /** The result only depends on the samples. */
+    static const bool timeDependent = false;
+
   public:
     /**
      * Builds this storage element and calls the base constructor of the
@@ -545,6 +586,9 @@ class AvgStor
   public:
     struct Params : public StorageParams {};
 
+    /** The result depends on the current tick, not only on the samples. */
+    static const bool timeDependent = true;
+
   public:
     /**
      * Build and initializes this stat storage.
@@ -688,12 +732,12 @@ class ScalarBase : public DataWrap<Derived, ScalarInfoProxy>
      * Increment the stat by 1. This calls the associated storage object inc
      * function.
      */
-    void operator++() { data()->inc(1); }
+    void operator++() { this->_dirty = true; data()->inc(1); }
     /**
      * Decrement the stat by 1. This calls the associated storage object dec
      * function.
      */
-    void operator--() { data()->dec(1); }
+    void operator--() { this->_dirty = true; data()->dec(1); }
 
     /** Increment the stat by 1. */
     void operator++(int) { ++*this; }
@@ -706,7 +750,7 @@ class ScalarBase : public DataWrap<Derived, ScalarInfoProxy>
      * @param v The new value.
      */
     template <typename U>
-    void operator=(const U &v) { data()->set(v); }
+    void operator=(const U &v) { this->_dirty = true; data()->set(v); }
 
     /**
      * Increment the stat by the given value. This calls the associated
@@ -714,7 +758,7 @@ class ScalarBase : public DataWrap<Derived, ScalarInfoProxy>
      * @param v The value to add.
      */
     template <typename U>
-    void operator+=(const U &v) { data()->inc(v); }
+    void operator+=(const U &v) { this->_dirty = true; data()->inc(v); }
 
     /**
      * Decrement the stat by the given value. This calls the associated
@@ -722,7 +766,7 @@ class ScalarBase : public DataWrap<Derived, ScalarInfoProxy>
      * @param v The value to substract.
      */
     template <typename U>
-    void operator-=(const U &v) { data()->dec(v); }
+    void operator-=(const U &v) { this->_dirty = true; data()->dec(v); }
 
     /**
      * Return the number of elements, always 1 for a scalar.
@@ -738,8 +782,18 @@ class ScalarBase : public DataWrap<Derived, ScalarInfoProxy>
 
     bool zero() { return result() == 0.0; }
 
-    void reset() { data()->reset(this->info()); }
+    void
+    reset()
+    {
+        if (!data()->zero())
+            this->_dirty = true;
+        data()->reset(this->info());
+    }
+
     void prepare() { data()->prepare(this->info()); }
+
+    bool dirty() const { return this->_dirty; }
+    void clean() { this->_dirty = Storage::timeDependent; }
 };
 
 class ProxyInfo : public ScalarInfo
@@ -854,6 +908,10 @@ class ValueBase : public DataWrap<Derived, ScalarInfoProxy>
     bool check() const { return proxy != NULL; }
     void prepare() { }
     void reset() { }
+
+    /** Values are read from the simulator, so they are never clean. */
+    bool dirty() const { return true; }
+    void clean() { }
 };
 
 //////////////////////////////////////////////////////////////////////
@@ -926,12 +984,12 @@ class ScalarProxy
      * Increment the stat by 1. This calls the associated storage object inc
      * function.
      */
-    void operator++() { stat.data(index)->inc(1); }
+    void operator++() { stat._dirty = true; stat.data(index)->inc(1); }
     /**
      * Decrement the stat by 1. This calls the associated storage object dec
      * function.
      */
-    void operator--() { stat.data(index)->dec(1); }
+    void operator--() { stat._dirty = true; stat.data(index)->dec(1); }
 
     /** Increment the stat by 1. */
     void operator++(int) { ++*this; }
@@ -947,6 +1005,7 @@ class ScalarProxy
     void
     operator=(const U &v)
     {
+        stat._dirty = true;
         stat.data(index)->set(v);
     }
 
@@ -959,6 +1018,7 @@ class ScalarProxy
     void
     operator+=(const U &v)
     {
+        stat._dirty = true;
         stat.data(index)->inc(v);
     }
 
@@ -971,6 +1031,7 @@ class ScalarProxy
     void
     operator-=(const U &v)
     {
+        stat._dirty = true;
         stat.data(index)->dec(v);
     }
 
@@ -1337,8 +1398,11 @@ class Vector2dBase : public DataWrapVec2d<Derived, Vector2dInfoProxy>
     {
         Info *info = this->info();
         size_type size = this->size();
-        for (off_type i = 0; i < size; ++i)
+        for (off_type i = 0; i < size; ++i) {
+            if (!data(i)->zero())
+                this->_dirty = true;
             data(i)->reset(info);
+        }
     }
 
     bool
@@ -1382,6 +1446,9 @@ class DistStor
                    buckets(0) {}
     };
 
+    /** The result only depends on the samples. */
+    static const bool timeDependent = false;
+
   private:
     /** The minimum value to track. */
     Counter min_track;
@@ -1526,6 +1593,9 @@ class HistStor
         Params() : DistParams(Hist), buckets(0) {}
     };
 
+    /** The result only depends on the samples. */
+    static const bool timeDependent = false;
+
   private:
     /** The minimum value to track. */
     Counter min_bucket;
@@ -1669,6 +1739,9 @@ class SampleStor
         Params() : DistParams(Deviation) {}
     };
 
+    /** The result only depends on the samples. */
+    static const bool timeDependent = false;
+
   private:
     /** The current sum. */
     Counter sum;
@@ -1749,6 +1822,9 @@ class AvgSampleStor
         Params() : DistParams(Deviation) {}
     };
 
+    /** The result depends on the current tick, not only on the samples. */
+    static const bool timeDependent = true;
+
   private:
     /** Current total. */
     Counter sum;
@@ -1866,7 +1942,12 @@ class DistBase : public DataWrap<Derived, DistInfoProxy>
      * @param n The number of times to add it, defaults to 1.
      */
     template <typename U>
-    void sample(const U &v, int n = 1) { data()->sample(v, n); }
+    void
+    sample(const U &v, int n = 1)
+    {
+        this->_dirty = true;
+        data()->sample(v, n);
+    }
 
     /**
      * Return the number of entries in this stat.
@@ -1892,13 +1973,23 @@ class DistBase : public DataWrap<Derived, DistInfoProxy>
     void
     reset()
     {
+        if (!data()->zero())
+            this->_dirty = true;
         data()->reset(this->info());
     }
 
     /**
      *  Add the argument distribution to the this distribution.
      */
-    void add(DistBase &d) { data()->add(d.data()); }
+    void
+    add(DistBase &d)
+    {
+        this->_dirty = true;
+        data()->add(d.data());
+    }
+
+    bool dirty() const { return this->_dirty; }
+    void clean() { this->_dirty = Storage::timeDependent; }
 
 };
 
@@ -2036,6 +2127,7 @@ class DistProxy
     void
     sample(const U &v, int n = 1)
     {
+        stat._dirty = true;
         data()->sample(v, n);
     }
 
@@ -2763,7 +2855,12 @@ class SparseHistBase : public DataWrap<Derived, SparseHistInfoProxy>
      * @param n The number of times to add it, defaults to 1.
      */
     template <typename U>
-    void sample(const U &v, int n = 1) { data()->sample(v, n); }
+    void
+    sample(const U &v, int n = 1)
+    {
+        this->_dirty = true;
+        data()->sample(v, n);
+    }
 
     /**
      * Return the number of entries in this stat.
@@ -2789,8 +2886,13 @@ class SparseHistBase : public DataWrap<Derived, SparseHistInfoProxy>
     void
     reset()
     {
+        if (!data()->zero())
+            this->_dirty = true;
         data()->reset(this->info());
     }
+
+    bool dirty() const { return this->_dirty; }
+    void clean() { this->_dirty = Storage::timeDependent; }
 };
 
 /**
@@ -2805,6 +2907,9 @@ class SparseHistStor
         Params() : DistParams(Hist) {}
     };
 
+    /** The result only depends on the samples. */
+    static const bool timeDependent = false;
+
   private:
     /** Counter for number of samples */
     Counter samples;
@@ -2899,6 +3004,16 @@ class Formula : public DataWrapVec<Formula, FormulaInfoProxy>
     NodePtr root;
     friend class Temp;
 
+    /**
+     * Results memoized during a dump, since formulas are typically
+     * evaluated several times per dump (result, total, zero and as
+     * part of other formulas). Tagged with the dump they belong to.
+     */
+    mutable VResult memoResult;
+    mutable Result memoTotal;
+    mutable uint64_t memoResultDump;
+    mutable uint64_t memoTotalDump;
+
   public:
     /**
      * Create and initialize thie formula, and register it with the database.
@@ -2971,6 +3086,13 @@ class Formula : public DataWrapVec<Formula, FormulaInfoProxy>
      */
     bool zero() const;
 
+    /**
+     * Formulas are computed from other stats, so they are never
+     * clean. Their results are memoized during dumps instead.
+     */
+    bool dirty() const { return true; }
+    void clean() { }
+
     std::string str() const;
 };
 
@@ -3229,6 +3351,14 @@ sum(Temp val)
 /** Dump all statistics data to the registered outputs */
 void dump();
 void reset();
+
+/**
+ * Bracket the work of a dump. Formulas are memoized between the two
+ * calls, and endDump() marks all stats as clean so that the next dump
+ * can tell which of them have changed.
+ */
+void beginDump();
+void endDump();
 void enable();
 bool enabled();
 
@@ -0,0 +1,279 @@
+/*
+ * Copyright (c) 2018 The University of Illinois at Urbana-Champaign
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "base/stats/binary.hh"
+
+#include <cstring>
+#include <iostream>
+
+#include "base/logging.hh"
+#include "base/output.hh"
+#include "base/stats/info.hh"
+
+using namespace std;
+
+namespace Stats {
+
+const uint32_t Binary::version;
+
+Binary::Binary()
+    : stream(NULL), firstDump(true)
+{
+}
+
+Binary::Binary(std::ostream &stream)
+    : stream(NULL), firstDump(true)
+{
+    open(stream);
+}
+
+void
+Binary::open(std::ostream &_stream)
+{
+    if (stream)
+        panic("stream already set!");
+
+    stream = &_stream;
+    if (!valid())
+        fatal("Unable to open output stream for writing\n");
+}
+
+bool
+Binary::valid() const
+{
+    return stream != NULL && stream->good();
+}
+
+bool
+Binary::noOutput(const Info &info)
+{
+    // Unlike the text output, prerequisites are ignored since every
+    // row needs to have the same columns.
+    return !info.flags.isSet(display);
+}
+
+void
+Binary::begin()
+{
+    row.clear();
+}
+
+void
+Binary::end()
+{
+    if (firstDump) {
+        writeSchema();
+        firstDump = false;
+    } else if (row.size() != columns.size()) {
+        panic("Number of statistics values changed between dumps "
+              "(%d, expected %d)\n", row.size(), columns.size());
+    }
+
+    stream->write(reinterpret_cast<const char *>(row.data()),
+                  row.size() * sizeof(Result));
+    stream->flush();
+}
+
+void
+Binary::writeSchema()
+{
+    const uint32_t byte_order = 0x01020304;
+    const uint32_t num_columns = columns.size();
+
+    stream->write("gem5stat", 8);
+    stream->write(reinterpret_cast<const char *>(&version), sizeof(version));
+    stream->write(reinterpret_cast<const char *>(&byte_order),
+                  sizeof(byte_order));
+    stream->write(reinterpret_cast<const char *>(&num_columns),
+                  sizeof(num_columns));
+
+    for (const auto &name : columns) {
+        const uint16_t len = name.size();
+        stream->write(reinterpret_cast<const char *>(&len), sizeof(len));
+        stream->write(name.data(), len);
+    }
+}
+
+void
+Binary::visit(const ScalarInfo &info)
+{
+    if (noOutput(info))
+        return;
+
+    add([&]{ return info.name; }, info.result());
+}
+
+void
+Binary::visit(const VectorInfo &info)
+{
+    if (noOutput(info))
+        return;
+
+    const size_type size = info.size();
+    const VResult &vec = info.result();
+
+    if (size == 1) {
+        add([&]{ return info.name; }, vec[0]);
+        return;
+    }
+
+    for (off_type i = 0; i < size; ++i) {
+        add([&]{
+                bool named = i < info.subnames.size() &&
+                    !info.subnames[i].empty();
+                return info.name + info.separatorString +
+                    (named ? info.subnames[i] : to_string(i));
+            }, vec[i]);
+    }
+
+    if (info.flags.isSet(total)) {
+        add([&]{ return info.name + info.separatorString + "total"; },
+            info.total());
+    }
+}
+
+void
+Binary::visit(const FormulaInfo &info)
+{
+    visit((const VectorInfo &)info);
+}
+
+void
+Binary::addDist(const Info &info, const string &sub, const DistData &data)
+{
+    auto column = [&](const string &field) {
+        return [&, field]{ return info.name + sub + info.separatorString +
+                                  field; };
+    };
+
+    add(column("samples"), data.samples);
+    add(column("sum"), data.sum);
+    add(column("squares"), data.squares);
+
+    if (data.type == Deviation)
+        return;
+
+    if (data.type == Hist)
+        add(column("logs"), data.logs);
+
+    add(column("bucket_size"), data.bucket_size);
+    add(column("min_bucket"), data.min);
+
+    if (data.type == Dist)
+        add(column("underflows"), data.underflow);
+
+    for (off_type i = 0; i < data.cvec.size(); ++i) {
+        if (firstDump)
+            add(column("bucket" + to_string(i)), data.cvec[i]);
+        else
+            row.push_back(data.cvec[i]);
+    }
+
+    if (data.type == Dist) {
+        add(column("overflows"), data.overflow);
+        add(column("min_value"), data.min_val);
+        add(column("max_value"), data.max_val);
+    }
+}
+
+void
+Binary::visit(const DistInfo &info)
+{
+    if (noOutput(info))
+        return;
+
+    addDist(info, "", info.data);
+}
+
+void
+Binary::visit(const VectorDistInfo &info)
+{
+    if (noOutput(info))
+        return;
+
+    for (off_type i = 0; i < info.size(); ++i) {
+        addDist(info, firstDump ? "_" + (info.subnames[i].empty() ?
+                                         to_string(i) : info.subnames[i])
+                                : "", info.data[i]);
+    }
+}
+
+void
+Binary::visit(const Vector2dInfo &info)
+{
+    if (noOutput(info))
+        return;
+
+    for (off_type i = 0; i < info.x; ++i) {
+        for (off_type j = 0; j < info.y; ++j) {
+            add([&]{
+                    bool xnamed = i < info.subnames.size() &&
+                        !info.subnames[i].empty();
+                    bool ynamed = j < info.y_subnames.size() &&
+                        !info.y_subnames[j].empty();
+                    return info.name + "_" +
+                        (xnamed ? info.subnames[i] : to_string(i)) +
+                        info.separatorString +
+                        (ynamed ? info.y_subnames[j] : to_string(j));
+                }, info.cvec[i * info.y + j]);
+        }
+    }
+
+    if (info.flags.isSet(total)) {
+        add([&]{ return info.name + info.separatorString + "total"; },
+            info.total());
+    }
+}
+
+void
+Binary::visit(const SparseHistInfo &info)
+{
+    if (noOutput(info))
+        return;
+
+    // The buckets of a sparse histogram change from dump to dump, so
+    // they don't fit in fixed width rows.
+    add([&]{ return info.name + info.separatorString + "samples"; },
+        info.data.samples);
+}
+
+Output *
+initBinary(const string &filename)
+{
+    static Binary binary;
+    static bool connected = false;
+
+    if (!connected) {
+        binary.open(*simout.findOrCreate(filename, true)->stream());
+        connected = true;
+    }
+
+    return &binary;
+}
+
+} // namespace Stats
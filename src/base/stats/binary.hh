@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2018 The University of Illinois at Urbana-Champaign
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __BASE_STATS_BINARY_HH__
+#define __BASE_STATS_BINARY_HH__
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include "base/stats/output.hh"
+#include "base/stats/types.hh"
+
+namespace Stats {
+
+struct DistData;
+
+/**
+ * Statistics output in a compact binary format meant for frequent
+ * periodic dumps.
+ *
+ * The first dump writes a header and a schema listing the name of
+ * every column (one per value in the text output). Every dump,
+ * including the first one, then appends a row of fixed width with
+ * one 64-bit floating point value per column. Column names follow
+ * the text output, except for distributions which store their raw
+ * data (samples, sum, squares, ...) and number their buckets, and
+ * sparse histograms of which only the number of samples is kept.
+ *
+ * File layout (host byte order, checked through the magic number):
+ *   char[8]  magic "gem5stat"
+ *   uint32   version
+ *   uint32   byte order marker (0x01020304)
+ *   uint32   number of columns N
+ *   N times: uint16 name length, name
+ *   rows:    double[N]
+ *
+ * See src/python/m5/stats/binary.py for a reader.
+ */
+class Binary : public Output
+{
+  protected:
+    std::ostream *stream;
+
+    /** Names of the columns, filled in during the first dump. */
+    std::vector<std::string> columns;
+
+    /** Values of the current dump. */
+    std::vector<Result> row;
+
+    /** True until the schema has been written. */
+    bool firstDump;
+
+    bool noOutput(const Info &info);
+
+    /**
+     * Add a value to the current row. The column name is only
+     * generated (by calling name()) during the first dump, so later
+     * dumps don't pay for any string handling.
+     */
+    template <class NameFn>
+    void
+    add(NameFn name, Result value)
+    {
+        if (firstDump)
+            columns.push_back(name());
+        row.push_back(value);
+    }
+
+    void addDist(const Info &info, const std::string &sub,
+                 const DistData &data);
+
+    void writeSchema();
+
+  public:
+    static const uint32_t version = 1;
+
+    Binary();
+    Binary(std::ostream &stream);
+
+    void open(std::ostream &stream);
+
+    // Implement Visit
+    void visit(const ScalarInfo &info) override;
+    void visit(const VectorInfo &info) override;
+    void visit(const DistInfo &info) override;
+    void visit(const VectorDistInfo &info) override;
+    void visit(const Vector2dInfo &info) override;
+    void visit(const FormulaInfo &info) override;
+    void visit(const SparseHistInfo &info) override;
+
+    // Implement Output
+    bool valid() const override;
+    void begin() override;
+    void end() override;
+};
+
+Output *initBinary(const std::string &filename);
+
+} // namespace Stats
+
+#endif // __BASE_STATS_BINARY_HH__
@@ -128,6 +128,17 @@ class Info
      */
     virtual bool zero() const = 0;
 
+    /**
+     * @return true if the stat may have changed since the end of the
+     * last dump.
+     */
+    virtual bool dirty() const { return true; }
+
+    /**
+     * Mark the stat as unchanged, called at the end of each dump.
+     */
+    virtual void clean() { }
+
     /**
      * Visitor entry for outputing statistics data
      */
@@ -45,6 +45,7 @@
 #endif
 #include "base/stats/text.hh"
 
+#include <algorithm>
 #include <cmath>
 #include <fstream>
 #include <iostream>
@@ -85,18 +86,21 @@ namespace Stats {
 std::list<Info *> &statsList();
 
 Text::Text()
-    : mystream(false), stream(NULL), descriptions(false)
+    : mystream(false), stream(NULL), descriptions(false), skipZero(false),
+      skipUnchanged(false)
 {
 }
 
 Text::Text(std::ostream &stream)
-    : mystream(false), stream(NULL), descriptions(false)
+    : mystream(false), stream(NULL), descriptions(false), skipZero(false),
+      skipUnchanged(false)
 {
     open(stream);
 }
 
 Text::Text(const std::string &file)
-    : mystream(false), stream(NULL), descriptions(false)
+    : mystream(false), stream(NULL), descriptions(false), skipZero(false),
+      skipUnchanged(false)
 {
     open(file);
 }
@@ -159,6 +163,9 @@ Text::noOutput(const Info &info)
     if (!info.flags.isSet(display))
         return true;
 
+    if (skipUnchanged && !info.dirty())
+        return true;
+
     if (info.prereq && info.prereq->zero())
         return true;
 
@@ -529,6 +536,14 @@ Text::visit(const VectorInfo &info)
         return;
 
     size_type size = info.size();
+    const VResult &vec = info.result();
+
+    if (skipZero && size > 1 &&
+        std::all_of(vec.begin(), vec.end(),
+                    [](Result r) { return r == 0.0; })) {
+        return;
+    }
+
     VectorPrint print;
 
     print.name = info.name;
@@ -537,7 +552,7 @@ Text::visit(const VectorInfo &info)
     print.flags = info.flags;
     print.descriptions = descriptions;
     print.precision = info.precision;
-    print.vec = info.result();
+    print.vec = vec;
     print.total = info.total();
     print.forceSubnames = false;
 
@@ -568,6 +583,11 @@ Text::visit(const Vector2dInfo &info)
     if (noOutput(info))
         return;
 
+    if (skipZero && std::all_of(info.cvec.begin(), info.cvec.end(),
+                                [](Counter c) { return c == 0; })) {
+        return;
+    }
+
     bool havesub = false;
     VectorPrint print;
 
@@ -634,6 +654,9 @@ Text::visit(const DistInfo &info)
     if (noOutput(info))
         return;
 
+    if (skipZero && info.data.samples == 0)
+        return;
+
     DistPrint print(this, info);
     print(*stream);
 }
@@ -644,6 +667,12 @@ Text::visit(const VectorDistInfo &info)
     if (noOutput(info))
         return;
 
+    if (skipZero && std::all_of(info.data.begin(), info.data.end(),
+                                [](const DistData &d) {
+                                    return d.samples == 0; })) {
+        return;
+    }
+
     for (off_type i = 0; i < info.size(); ++i) {
         DistPrint print(this, info, i);
         print(*stream);
@@ -731,12 +760,16 @@ Text::visit(const SparseHistInfo &info)
     if (noOutput(info))
         return;
 
+    if (skipZero && info.data.samples == 0)
+        return;
+
     SparseHistPrint print(this, info);
     print(*stream);
 }
 
 Output *
-initText(const string &filename, bool desc)
+initText(const string &filename, bool desc, bool skip_zero,
+         bool skip_unchanged)
 {
     static Text text;
     static bool connected = false;
@@ -744,6 +777,8 @@ initText(const string &filename, bool desc)
     if (!connected) {
         text.open(*simout.findOrCreate(filename)->stream());
         text.descriptions = desc;
+        text.skipZero = skip_zero;
+        text.skipUnchanged = skip_unchanged;
         connected = true;
     }
 
@@ -52,6 +52,12 @@ class Text : public Output
   public:
     bool descriptions;
 
+    /** Don't print vectors and distributions that are all zero. */
+    bool skipZero;
+
+    /** Only print the stats that changed since the previous dump. */
+    bool skipUnchanged;
+
   public:
     Text();
     Text(std::ostream &stream);
@@ -78,7 +84,8 @@ class Text : public Output
 
 std::string ValueToString(Result value, int precision);
 
-Output *initText(const std::string &filename, bool desc);
+Output *initText(const std::string &filename, bool desc,
+                 bool skip_zero = false, bool skip_unchanged = false);
 
 } // namespace Stats
 
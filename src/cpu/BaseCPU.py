@@ -111,6 +111,7 @@ class BaseCPU(MemObject):
         PyBindMethod("scheduleInstStop"),
         PyBindMethod("scheduleLoadStop"),
         PyBindMethod("getCurrentInstCount"),
+        PyBindMethod("getCurrentCycleCount"),
     ]
 
     @classmethod
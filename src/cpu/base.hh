@@ -476,6 +476,15 @@ class BaseCPU : public MemObject
      */
     uint64_t getCurrentInstCount(ThreadID tid);
 
+    /**
+     * Get the current cycle in the clock domain of this CPU, whether it
+     * is switched in or not. Used by Python to measure the CPI of a
+     * number of instructions.
+     *
+     * @return Current cycle
+     */
+    uint64_t getCurrentCycleCount() const { return curCycle(); }
+
   public:
     /**
      * @{
@@ -123,6 +123,18 @@ class AddrMap
         CachePage *page = getPage(addr);
         return page->items[addr & (TheISA::PageBytes - 1)];
     }
+
+    /// Call func(addr, value) for every entry of every allocated page,
+    /// including the entries that were never looked up.
+    template <class Func>
+    void
+    forEach(Func func) const
+    {
+        for (const auto &page : pageMap) {
+            for (Addr offset = 0; offset < TheISA::PageBytes; offset++)
+                func(page.first + offset, page.second->items[offset]);
+        }
+    }
 };
 
 } // namespace DecodeCache
@@ -165,6 +165,9 @@ class DerivO3CPU(BaseCPU):
     # [mengjia] add configuration variables
     needsTSO = Param.Bool(False, "Enable TSO Memory model")
     allowSpecBufHit = Param.Bool(True, "Enable hit/reuse spec buffer entries")
+    invisibleSpec = Param.Bool(False, "Issue unsafe loads as invisible spec "
+                               "loads, exposed or validated once safe "
+                               "(InvisiSpec), instead of delaying them")
     # [Jiyong, STT] STT configurations
     threatModel = Param.String('UnsafeBaseline', "The threat model specificed for simulation")
     STT = Param.Bool(False, "Apply STT protection mechanism")
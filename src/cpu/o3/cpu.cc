@@ -416,8 +416,8 @@ FullO3CPU<Impl>::FullO3CPU(DerivO3CPUParams *params)
         this->thread[tid]->setFuncExeInst(0);
 
     /*** [Jiyong,mengjia,InvisiSpec,STT] additional configurations ***/
-    isInvisibleSpec = false;
-    allowSpecBufHit = false;
+    isInvisibleSpec = params->invisibleSpec;
+    allowSpecBufHit = isInvisibleSpec && params->allowSpecBufHit;
 
     const std::string threatModel = params->threatModel;
     if (threatModel.compare("UnsafeBaseline") == 0) {
@@ -447,7 +447,7 @@ FullO3CPU<Impl>::FullO3CPU(DerivO3CPUParams *params)
     cprintf("applySTT = %d, implicit_channel = %d, ifPrintROB = %d, moreTransmitInsts = %d\n",
             STT, impChannel, ifPrintROB, moreTransmitInsts);
 
-    if (STT)
+    if (STT || isInvisibleSpec)
         assert (protectionEnabled);
     if (impChannel)
         assert (STT);
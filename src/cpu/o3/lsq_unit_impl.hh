@@ -1033,13 +1033,11 @@ LSQUnit<Impl>::updateVisibleState()
             }
             inst->readyToExpose(true);
         } else if (cpu->protectionEnabled && cpu->isInvisibleSpec){
-            assert (0); // not supported
             // invisiSpec (readyToExpose flag is effective)
             if (cpu->STT) {  // apply STT
-                if (inst->needPostFetch() &&
+                if (inst->needPostFetch() && !inst->isExposeSent() &&
                     !inst->isArgsTainted() && !inst->readyToExpose())
-                    ;
-                    //++loadsToVLD;
+                    ++loadsToVLD;
                 else if (inst->isArgsTainted() && inst->readyToExpose()) {
                     DPRINTF(LSQUnit, "The load can not be validated "
                             "[sn:%lli] PC %s\n", inst->seqNum, inst->pcState());
@@ -1052,10 +1050,8 @@ LSQUnit<Impl>::updateVisibleState()
                     if (!inst->readyToExpose()){
                         DPRINTF(LSQUnit, "Set readyToExpose for "
                                 "inst [sn:%lli] PC %s\n", inst->seqNum, inst->pcState());
-                        if (inst->needPostFetch()){
-                            ;
-                            //++loadsToVLD;
-                        }
+                        if (inst->needPostFetch() && !inst->isExposeSent())
+                            ++loadsToVLD;
                     }
                     inst->readyToExpose(true);
                 } else {
@@ -1063,7 +1059,6 @@ LSQUnit<Impl>::updateVisibleState()
                         DPRINTF(LSQUnit, "The load can not be validated "
                                 "[sn:%lli] PC %s\n", inst->seqNum, inst->pcState());
                         assert(0);
-                        //--loadsToVLD;
                     }
                     inst->readyToExpose(false);
                 }
@@ -1117,6 +1112,8 @@ LSQUnit<Impl>::exposeLoads()
             // load is executed, so it wait for expose complete
             // to send it to commit, regardless of whether it is ready
             // to expose
+            if (load_inst->readyToExpose())
+                --loadsToVLD;
             load_inst->setExposeCompleted();
             load_inst->setExposeSent();
             if (load_inst->isExecuted()){
@@ -1315,6 +1312,7 @@ LSQUnit<Impl>::exposeLoads()
             }
 
             load_inst->setExposeSent();
+            --loadsToVLD;
             incrLdIdx(loadVLDIdx);
             if (!split){
                 setSpecBuffState(req);
@@ -1332,7 +1330,7 @@ LSQUnit<Impl>::exposeLoads()
 
     //printf("expose loads end: loadsToVLD=%d\n", loadsToVLD);
     assert(loads>=0);
-    //assert(loadsToVLD >= 0);
+    assert(loadsToVLD >= 0);
 
     //return old_loadsToVLD-loadsToVLD;
     return 0;
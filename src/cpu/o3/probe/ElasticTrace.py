@@ -62,3 +62,7 @@ class ElasticTrace(ProbeListenerObject):
     # Whether to trace virtual addresses for memory accesses
     traceVirtAddr = Param.Bool(False, "Set to true if virtual addresses are " \
                                 "to be traced.")
+    # Whether to record the access roots of the loads and stores, and the
+    # control instructions, so that the trace can be replayed with STT
+    traceTaint = Param.Bool(False, "Set to true if taint dependencies are " \
+                            "to be traced.")
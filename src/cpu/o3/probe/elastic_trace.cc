@@ -58,7 +58,8 @@ ElasticTrace::ElasticTrace(const ElasticTraceParams* params)
        instTraceStream(nullptr),
        startTraceInst(params->startTraceInst),
        allProbesReg(false),
-       traceVirtAddr(params->traceVirtAddr)
+       traceVirtAddr(params->traceVirtAddr),
+       traceTaint(params->traceTaint)
 {
     cpu = dynamic_cast<FullO3CPU<O3CPUImpl>*>(params->manager);
     fatal_if(!cpu, "Manager of %s is not of type O3CPU and thus does not "\
@@ -90,6 +91,7 @@ ElasticTrace::ElasticTrace(const ElasticTraceParams* params)
     data_rec_header.set_obj_id(name());
     data_rec_header.set_tick_freq(SimClock::Frequency);
     data_rec_header.set_window_size(depWindowSize);
+    data_rec_header.set_taint(traceTaint);
     dataTraceStream->write(data_rec_header);
     // Register a callback to flush trace records and close the output streams.
     Callback* cb = new MakeCallback<ElasticTrace,
@@ -231,6 +233,7 @@ ElasticTrace::updateRegDep(const DynInstPtr &dyn_inst)
     // a new execution info object to track this instruction as it
     // progresses through the pipeline.
     InstExecInfo* exec_info_ptr = new InstExecInfo;
+    exec_info_ptr->isAccess = dyn_inst->isLoad();
     tempStore[seq_num] = exec_info_ptr;
 
     // Loop through the source registers and look up the dependency map. If
@@ -258,6 +261,12 @@ ElasticTrace::updateRegDep(const DynInstPtr &dyn_inst)
                 if (seq_num - last_writer < depWindowSize) {
                     // Record a physical register dependency.
                     exec_info_ptr->physRegDepSet.insert(last_writer);
+                    // The address of a store does not depend on the data
+                    // stored, its first source operand.
+                    if (traceTaint &&
+                        !(dyn_inst->isStore() && src_idx == 0)) {
+                        updateTaintRoots(exec_info_ptr, last_writer, seq_num);
+                    }
                 }
             }
 
@@ -287,6 +296,25 @@ ElasticTrace::updateRegDep(const DynInstPtr &dyn_inst)
                                     (std::size_t)maxPhysRegDepMapSize.value());
 }
 
+void
+ElasticTrace::updateTaintRoots(InstExecInfo* exec_info_ptr,
+                               InstSeqNum producer, InstSeqNum seq_num)
+{
+    auto itr_exec_info = tempStore.find(producer);
+    if (itr_exec_info == tempStore.end())
+        return;
+
+    const InstExecInfo* producer_info = itr_exec_info->second;
+    if (producer_info->isAccess) {
+        exec_info_ptr->taintRootSet.insert(producer);
+    }
+    for (auto root : producer_info->taintRootSet) {
+        if (seq_num - root < depWindowSize) {
+            exec_info_ptr->taintRootSet.insert(root);
+        }
+    }
+}
+
 void
 ElasticTrace::removeRegDepMapEntry(const SeqNumRegPair &inst_reg_pair)
 {
@@ -408,6 +436,7 @@ ElasticTrace::addDepTraceRecord(const DynInstPtr &head_inst,
     // Currently the tracing does not support split requests.
     new_record->size = head_inst->effSize;
     new_record->pc = head_inst->instAddr();
+    new_record->isControl = head_inst->isControl();
 
     // Assign the timing information stored in the execution info object
     new_record->executeTick = exec_info_ptr->executeTick;
@@ -435,6 +464,7 @@ ElasticTrace::addDepTraceRecord(const DynInstPtr &head_inst,
     // on squashed instructions and we do not add those to the trace.
     if (head_inst->isLoad() && !commit) {
          (exec_info_ptr->physRegDepSet).clear();
+         (exec_info_ptr->taintRootSet).clear();
     }
 
     // Assign the register dependencies stored in the execution info object
@@ -469,6 +499,20 @@ ElasticTrace::addDepTraceRecord(const DynInstPtr &head_inst,
         }
     }
 
+    // Assign the access roots tainting the address of a load/store. As for
+    // register dependencies, a root that was not added to the trace is
+    // skipped and the record does not wait for it during replay.
+    if (traceTaint && (head_inst->isLoad() || head_inst->isStore())) {
+        for (auto root : exec_info_ptr->taintRootSet) {
+            if (traceInfoMap.find(root) != traceInfoMap.end()) {
+                DPRINTF(ElasticTrace, "Inst %lli has taint dependency on "
+                        "%lli\n", new_record->instNum, root);
+                new_record->taintDepList.push_back(root);
+                ++numTaintDep;
+            }
+        }
+    }
+
     // Check for and assign an ROB dependency in addition to register
     // dependency before adding the record to the trace.
     // As stores have to commit in order a store is dependent on the last
@@ -785,6 +829,8 @@ ElasticTrace::writeDepTrace(uint32_t num_to_write)
     // Computational delay with respect to last completed dependency
     // List of physical register RAW dependencies - optional, repeated
     // Weight of a node equal to no. of filtered nodes before it - optional
+    // List of access roots tainting the address - optional, repeated
+    // If instruction is a control instruction - optional
     uint16_t num_filtered_nodes = 0;
     depTraceItr dep_trace_itr(depTrace.begin());
     depTraceItr dep_trace_itr_start = dep_trace_itr;
@@ -794,8 +840,10 @@ ElasticTrace::writeDepTrace(uint32_t num_to_write)
         // If no node dependends on a comp node then there is no reason to
         // track the comp node in the dependency graph. We filter out such
         // nodes but count them and add a weight field to the subsequent node
-        // that we do include in the trace.
-        if (!temp_ptr->isComp() || temp_ptr->numDepts != 0) {
+        // that we do include in the trace. Control instructions are kept in a
+        // taint trace as they are the visibility points of younger loads.
+        if (!temp_ptr->isComp() || temp_ptr->numDepts != 0 ||
+            (traceTaint && temp_ptr->isControl)) {
             DPRINTFR(ElasticTrace, "Instruction with seq. num %lli "
                      "is as follows:\n", temp_ptr->instNum);
             if (temp_ptr->isLoad() || temp_ptr->isStore()) {
@@ -854,6 +902,15 @@ ElasticTrace::writeDepTrace(uint32_t num_to_write)
                 dep_pkt.add_reg_dep(temp_ptr->physRegDepList.front());
                 temp_ptr->physRegDepList.pop_front();
             }
+            while (!temp_ptr->taintDepList.empty()) {
+                DPRINTFR(ElasticTrace, "\thas taint dependency on %lli\n",
+                         temp_ptr->taintDepList.front());
+                dep_pkt.add_taint_dep(temp_ptr->taintDepList.front());
+                temp_ptr->taintDepList.pop_front();
+            }
+            if (traceTaint && temp_ptr->isControl) {
+                dep_pkt.set_control(true);
+            }
             if (num_filtered_nodes != 0) {
                 // Set the weight of this node as the no. of filtered nodes
                 // between this node and the last node that we wrote to output
@@ -888,6 +945,12 @@ ElasticTrace::regStats() {
         .desc("Number of register dependencies recorded during tracing")
         ;
 
+    numTaintDep
+        .name(name() + ".numTaintDep")
+        .desc("Number of taint dependencies on access roots recorded during"
+              " tracing")
+        ;
+
     numOrderDepStores
         .name(name() + ".numOrderDepStores")
         .desc("Number of commit order (rob) dependencies for a store recorded"
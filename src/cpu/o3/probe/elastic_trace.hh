@@ -214,12 +214,21 @@ class ElasticTrace : public ProbeListenerObject
          * due to Read After Write data dependency based on physical register.
          */
         std::set<InstSeqNum> physRegDepSet;
+        /**
+         * Set of in-flight loads (access roots) whose data the source
+         * operands of this instruction depend on, directly or through
+         * other instructions. Only the address operands of a store count.
+         */
+        std::set<InstSeqNum> taintRootSet;
+        /** If the instruction is a load, i.e. an access root itself */
+        bool isAccess;
         /** @} */
 
         /** Constructor */
         InstExecInfo()
           : executeTick(MaxTick),
-            toCommitTick(MaxTick)
+            toCommitTick(MaxTick),
+            isAccess(false)
         { }
     };
 
@@ -277,6 +286,10 @@ class ElasticTrace : public ProbeListenerObject
         std::list<InstSeqNum> robDepList;
         /* List of physical register RAW dependencies. */
         std::list<InstSeqNum> physRegDepList;
+        /* List of access roots tainting a load/store address. */
+        std::list<InstSeqNum> taintDepList;
+        /* If the instruction is a control instruction. */
+        bool isControl;
         /**
          * Computational delay after the last dependent inst. completed.
          * A value of -1 which means instruction has no dependencies.
@@ -372,6 +385,12 @@ class ElasticTrace : public ProbeListenerObject
     /** Whether to trace virtual addresses for memory requests. */
     const bool traceVirtAddr;
 
+    /**
+     * Whether to trace the access roots of loads and stores and keep the
+     * control instructions in the trace, for replay with STT.
+     */
+    const bool traceTaint;
+
     /** Pointer to the O3CPU that is this listener's parent a.k.a. manager */
     FullO3CPU<O3CPUImpl>* cpu;
 
@@ -396,6 +415,20 @@ class ElasticTrace : public ProbeListenerObject
      */
     void clearTempStoreUntil(const DynInstPtr head_inst);
 
+    /**
+     * Propagate the taint of a producer to an instruction reading one of
+     * its destination registers. A producer that is a load is an access
+     * root, and the roots of the producer itself are inherited as long as
+     * they fall in the window. A producer no longer in the temporary store
+     * has committed and does not taint its consumers.
+     *
+     * @param exec_info_ptr execution info of the consumer
+     * @param producer sequence number of the producer
+     * @param seq_num sequence number of the consumer
+     */
+    void updateTaintRoots(InstExecInfo* exec_info_ptr, InstSeqNum producer,
+                          InstSeqNum seq_num);
+
     /**
      * Calculate the computational delay between an instruction and a
      * subsequent instruction that has an ROB (order) dependency on it
@@ -515,6 +548,9 @@ class ElasticTrace : public ProbeListenerObject
     /** Number of register dependencies recorded during tracing */
     Stats::Scalar numRegDep;
 
+    /** Number of taint dependencies recorded during tracing */
+    Stats::Scalar numTaintDep;
+
     /**
      * Number of stores that got assigned a commit order dependency
      * on a past load/store.
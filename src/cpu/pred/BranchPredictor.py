@@ -41,6 +41,8 @@ class BranchPredictor(SimObject):
     BTBTagSize = Param.Unsigned(16, "Size of the BTB tags, in bits")
     RASSize = Param.Unsigned(16, "RAS size")
     instShiftAmt = Param.Unsigned(2, "Number of bits to shift instructions by")
+    historyBufferSize = Param.Unsigned(256, "Initial capacity of the "
+        "per-thread buffer of in-flight branch histories, doubled when full")
 
     useIndirect = Param.Bool(True, "Use indirect branch predictor")
     indirectHashGHR = Param.Bool(True, "Hash branch predictor GHR")
@@ -110,4 +112,6 @@ class LTAGE(BranchPredictor):
     minHist = Param.Unsigned(4, "Minimum history size of LTAGE")
     maxHist = Param.Unsigned(640, "Maximum history size of LTAGE")
     minTagWidth = Param.Unsigned(7, "Minimum tag size in tag tables")
+    specializedKernel = Param.Bool(True, "Use the TAGE kernels specialized "
+            "for the default table geometry when it is configured")
 
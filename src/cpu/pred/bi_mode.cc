@@ -44,7 +44,8 @@ BiModeBP::BiModeBP(const BiModeBPParams *params)
       choicePredictorSize(params->choicePredictorSize),
       choiceCtrBits(params->choiceCtrBits),
       globalPredictorSize(params->globalPredictorSize),
-      globalCtrBits(params->globalCtrBits)
+      globalCtrBits(params->globalCtrBits),
+      historyPool(sizeof(BPHistory))
 {
     if (!isPowerOf2(choicePredictorSize))
         fatal("Invalid choice predictor size.\n");
@@ -80,7 +81,7 @@ BiModeBP::BiModeBP(const BiModeBPParams *params)
 void
 BiModeBP::uncondBranch(ThreadID tid, Addr pc, void * &bpHistory)
 {
-    BPHistory *history = new BPHistory;
+    BPHistory *history = new (historyPool.alloc()) BPHistory;
     history->globalHistoryReg = globalHistoryReg[tid];
     history->takenUsed = true;
     history->takenPred = true;
@@ -96,7 +97,7 @@ BiModeBP::squash(ThreadID tid, void *bpHistory)
     BPHistory *history = static_cast<BPHistory*>(bpHistory);
     globalHistoryReg[tid] = history->globalHistoryReg;
 
-    delete history;
+    historyPool.free(history);
 }
 
 /*
@@ -128,7 +129,7 @@ BiModeBP::lookup(ThreadID tid, Addr branchAddr, void * &bpHistory)
                                  > notTakenThreshold;
     bool finalPrediction;
 
-    BPHistory *history = new BPHistory;
+    BPHistory *history = new (historyPool.alloc()) BPHistory;
     history->globalHistoryReg = globalHistoryReg[tid];
     history->takenUsed = choicePrediction;
     history->takenPred = takenGHBPrediction;
@@ -226,7 +227,7 @@ BiModeBP::update(ThreadID tid, Addr branchAddr, bool taken, void *bpHistory,
         }
     }
 
-    delete history;
+    historyPool.free(history);
 }
 
 unsigned
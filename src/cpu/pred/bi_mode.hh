@@ -109,6 +109,9 @@ class BiModeBP : public BPredUnit
     unsigned choiceThreshold;
     unsigned takenThreshold;
     unsigned notTakenThreshold;
+
+    // storage of the BPHistory objects
+    HistoryPool historyPool;
 };
 
 #endif // __CPU_PRED_BI_MODE_PRED_HH__
@@ -56,7 +56,7 @@
 BPredUnit::BPredUnit(const Params *params)
     : SimObject(params),
       numThreads(params->numThreads),
-      predHist(numThreads),
+      predHist(numThreads, History(params->historyBufferSize)),
       BTB(params->BTBEntries,
           params->BTBTagSize,
           params->instShiftAmt,
@@ -407,7 +407,7 @@ BPredUnit::squash(const InstSeqNum &squashed_sn,
     // fix up the entry.
     if (!pred_hist.empty()) {
 
-        auto hist_it = pred_hist.begin();
+        PredictorHistory *hist_it = &pred_hist.front();
         //HistoryIt hist_it = find(pred_hist.begin(), pred_hist.end(),
         //                       squashed_sn);
 
@@ -493,17 +493,14 @@ BPredUnit::dump()
     int i = 0;
     for (const auto& ph : predHist) {
         if (!ph.empty()) {
-            auto pred_hist_it = ph.begin();
-
             cprintf("predHist[%i].size(): %i\n", i++, ph.size());
 
-            while (pred_hist_it != ph.end()) {
+            for (size_t idx = 0; idx < ph.size(); ++idx) {
+                const PredictorHistory &hist = ph[idx];
                 cprintf("[sn:%lli], PC:%#x, tid:%i, predTaken:%i, "
                         "bpHistory:%#x\n",
-                        pred_hist_it->seqNum, pred_hist_it->pc,
-                        pred_hist_it->tid, pred_hist_it->predTaken,
-                        pred_hist_it->bpHistory);
-                pred_hist_it++;
+                        hist.seqNum, hist.pc, hist.tid, hist.predTaken,
+                        hist.bpHistory);
             }
 
             cprintf("\n");
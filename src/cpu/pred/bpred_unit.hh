@@ -47,11 +47,10 @@
 #ifndef __CPU_PRED_BPRED_UNIT_HH__
 #define __CPU_PRED_BPRED_UNIT_HH__
 
-#include <deque>
-
 #include "base/statistics.hh"
 #include "base/types.hh"
 #include "cpu/pred/btb.hh"
+#include "cpu/pred/history_buffer.hh"
 #include "cpu/pred/indirect.hh"
 #include "cpu/pred/ras.hh"
 #include "cpu/inst_seq.hh"
@@ -194,6 +193,8 @@ class BPredUnit : public SimObject
 
   private:
     struct PredictorHistory {
+        PredictorHistory() = default;
+
         /**
          * Makes a predictor history struct that contains any
          * information needed to update the predictor, BTB, and RAS.
@@ -250,7 +251,7 @@ class BPredUnit : public SimObject
         bool wasIndirect;
     };
 
-    typedef std::deque<PredictorHistory> History;
+    typedef HistoryBuffer<PredictorHistory> History;
 
     /** Number of the threads for which the branch history is maintained. */
     const unsigned numThreads;
@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2018 The University of Illinois at Urbana-Champaign
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Storage for the in-flight branch histories: a ring buffer of the
+ * histories kept by BPredUnit, and a pool of the history objects of the
+ * direction predictors. Neither allocates memory in the steady state.
+ */
+
+#ifndef __CPU_PRED_HISTORY_BUFFER_HH__
+#define __CPU_PRED_HISTORY_BUFFER_HH__
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "base/intmath.hh"
+
+/**
+ * Double-ended ring buffer of the in-flight histories of a thread,
+ * youngest at the front. The capacity is a power of two; it is doubled
+ * if more histories are in flight, which never happens if it covers
+ * the branches the CPU can hold.
+ */
+template <class T>
+class HistoryBuffer
+{
+  public:
+    explicit HistoryBuffer(size_t capacity = 64)
+        : buf(ceilPow2(capacity < 2 ? 2 : capacity)), head(0), count(0)
+    {}
+
+    bool empty() const { return count == 0; }
+    size_t size() const { return count; }
+    size_t capacity() const { return buf.size(); }
+
+    /** @param idx Age of the history, 0 for the youngest. */
+    T &operator[](size_t idx) { return buf[(head + idx) & mask()]; }
+    const T &
+    operator[](size_t idx) const
+    {
+        return buf[(head + idx) & mask()];
+    }
+
+    T &front() { assert(count); return buf[head]; }
+    T &back() { assert(count); return (*this)[count - 1]; }
+
+    void
+    push_front(const T &val)
+    {
+        if (count == buf.size())
+            grow();
+        head = (head - 1) & mask();
+        buf[head] = val;
+        ++count;
+    }
+
+    void
+    pop_front()
+    {
+        assert(count);
+        head = (head + 1) & mask();
+        --count;
+    }
+
+    void pop_back() { assert(count); --count; }
+
+  private:
+    size_t mask() const { return buf.size() - 1; }
+
+    void
+    grow()
+    {
+        std::vector<T> next(buf.size() * 2);
+        for (size_t i = 0; i < count; ++i)
+            next[i] = (*this)[i];
+        buf.swap(next);
+        head = 0;
+    }
+
+    std::vector<T> buf;
+    size_t head;
+    size_t count;
+};
+
+/**
+ * Pool of the history objects of a direction predictor, which are
+ * recycled rather than allocated for every prediction. Objects are
+ * carved out of chunks that never move, so the predictors can keep
+ * pointers to them.
+ */
+class HistoryPool
+{
+  public:
+    /**
+     * @param object_size Size of the history objects, including any
+     *                    array stored after them.
+     * @param chunk_objects Number of objects allocated at once.
+     */
+    explicit HistoryPool(size_t object_size, size_t chunk_objects = 256)
+        : objectSize(roundUp(std::max(object_size, sizeof(Node)),
+                             alignof(std::max_align_t))),
+          chunkObjects(chunk_objects), freeList(NULL)
+    {}
+
+    HistoryPool(const HistoryPool &) = delete;
+    HistoryPool &operator=(const HistoryPool &) = delete;
+
+    /** Storage for an object, to be constructed with placement new. */
+    void *
+    alloc()
+    {
+        if (!freeList)
+            refill();
+        Node *node = freeList;
+        freeList = node->next;
+        return node;
+    }
+
+    /** Return the storage of an object, after its destruction. */
+    void
+    free(void *p)
+    {
+        Node *node = static_cast<Node *>(p);
+        node->next = freeList;
+        freeList = node;
+    }
+
+  private:
+    struct Node
+    {
+        Node *next;
+    };
+
+    void
+    refill()
+    {
+        char *chunk = new char[objectSize * chunkObjects];
+        chunks.emplace_back(chunk);
+        for (size_t i = chunkObjects; i-- > 0; )
+            free(chunk + i * objectSize);
+    }
+
+    const size_t objectSize;
+    const size_t chunkObjects;
+    Node *freeList;
+    std::vector<std::unique_ptr<char[]>> chunks;
+};
+
+#endif // __CPU_PRED_HISTORY_BUFFER_HH__
@@ -47,6 +47,10 @@
 #include "debug/Fetch.hh"
 #include "debug/LTage.hh"
 
+constexpr int LTAGE::DefaultGeometry::histLengths[];
+constexpr int LTAGE::DefaultGeometry::tagWidths[];
+constexpr int LTAGE::DefaultGeometry::tableSizes[];
+
 LTAGE::LTAGE(const LTAGEParams *params)
   : BPredUnit(params),
     logSizeBiMP(params->logSizeBiMP),
@@ -58,7 +62,8 @@ LTAGE::LTAGE(const LTAGEParams *params)
     minHist(params->minHist),
     maxHist(params->maxHist),
     minTagWidth(params->minTagWidth),
-    threadHistory(params->numThreads)
+    threadHistory(params->numThreads),
+    historyPool(BranchInfo::storageSize(params->nHistoryTables + 1))
 {
     assert(params->histBufferSize > params->maxHist * 2);
     useAltPredForNewlyAllocated = 0;
@@ -132,6 +137,27 @@ LTAGE::LTAGE(const LTAGEParams *params)
     tableIndices = new int [nHistoryTables+1];
     tableTags = new int [nHistoryTables+1];
 
+    runtimeGeometry.numTables = nHistoryTables;
+    runtimeGeometry.histLengths = histLengths;
+    runtimeGeometry.tagWidths = tagWidths;
+    runtimeGeometry.tableSizes = tagTableSizes;
+
+    // Use the specialized kernels if the tables are those of the
+    // default configuration
+    typedef DefaultGeometry D;
+    fixedGeometry = params->specializedKernel &&
+        nHistoryTables == D::numTables &&
+        logSizeTagTables == D::logSizeTagTables &&
+        minHist == D::minHist && maxHist == D::maxHist &&
+        minTagWidth == D::minTagWidth;
+    for (int i = 1; fixedGeometry && i <= nHistoryTables; i++) {
+        fixedGeometry = histLengths[i] == D::histLengths[i] &&
+            tagWidths[i] == D::tagWidths[i] &&
+            tagTableSizes[i] == D::tableSizes[i];
+    }
+    DPRINTF(LTage, "Using the %s TAGE kernels\n",
+            fixedGeometry ? "specialized" : "generic");
+
     loopUseCounter = 0;
 }
 
@@ -147,46 +173,106 @@ LTAGE::lindex(Addr pc_in) const
     return (((pc_in) & ((ULL(1) << (logSizeLoopPred - 2)) - 1)) << 2);
 }
 
+template <class G>
 int
-LTAGE::F(int A, int size, int bank) const
+LTAGE::F(const G &g, int A, int size, int bank) const
 {
     int A1, A2;
 
     A = A & ((ULL(1) << size) - 1);
-    A1 = (A & ((ULL(1) << tagTableSizes[bank]) - 1));
-    A2 = (A >> tagTableSizes[bank]);
-    A2 = ((A2 << bank) & ((ULL(1) << tagTableSizes[bank]) - 1))
-       + (A2 >> (tagTableSizes[bank] - bank));
+    A1 = (A & ((ULL(1) << g.tableSizes[bank]) - 1));
+    A2 = (A >> g.tableSizes[bank]);
+    A2 = ((A2 << bank) & ((ULL(1) << g.tableSizes[bank]) - 1))
+       + (A2 >> (g.tableSizes[bank] - bank));
     A = A1 ^ A2;
-    A = ((A << bank) & ((ULL(1) << tagTableSizes[bank]) - 1))
-      + (A >> (tagTableSizes[bank] - bank));
+    A = ((A << bank) & ((ULL(1) << g.tableSizes[bank]) - 1))
+      + (A >> (g.tableSizes[bank] - bank));
     return (A);
 }
 
 
 // gindex computes a full hash of pc, ghist and pathHist
+template <class G>
 int
-LTAGE::gindex(ThreadID tid, Addr pc, int bank) const
+LTAGE::gindex(const G &g, ThreadID tid, Addr pc, int bank) const
 {
     int index;
-    int hlen = (histLengths[bank] > 16) ? 16 : histLengths[bank];
+    int hlen = (g.histLengths[bank] > 16) ? 16 : g.histLengths[bank];
     index =
-        (pc) ^ ((pc) >> ((int) abs(tagTableSizes[bank] - bank) + 1)) ^
+        (pc) ^ ((pc) >> ((int) abs(g.tableSizes[bank] - bank) + 1)) ^
         threadHistory[tid].computeIndices[bank].comp ^
-        F(threadHistory[tid].pathHist, hlen, bank);
+        F(g, threadHistory[tid].pathHist, hlen, bank);
 
-    return (index & ((ULL(1) << (tagTableSizes[bank])) - 1));
+    return (index & ((ULL(1) << (g.tableSizes[bank])) - 1));
 }
 
 
 // Tag computation
+template <class G>
 uint16_t
-LTAGE::gtag(ThreadID tid, Addr pc, int bank) const
+LTAGE::gtag(const G &g, ThreadID tid, Addr pc, int bank) const
 {
     int tag = (pc) ^ threadHistory[tid].computeTags[0][bank].comp
                    ^ (threadHistory[tid].computeTags[1][bank].comp << 1);
 
-    return (tag & ((ULL(1) << tagWidths[bank]) - 1));
+    return (tag & ((ULL(1) << g.tagWidths[bank]) - 1));
+}
+
+
+// Table indices and tags, and lookup of the matching tables. With
+// DefaultGeometry the loops have a constant trip count and all the
+// shifts and masks are constants.
+template <class G>
+void
+LTAGE::tageLookup(const G &g, ThreadID tid, Addr pc, BranchInfo *bi)
+{
+    // computes the table addresses and the partial tags
+    for (int i = 1; i <= g.numTables; i++) {
+        tableIndices[i] = gindex(g, tid, pc, i);
+        bi->tableIndices[i] = tableIndices[i];
+        tableTags[i] = gtag(g, tid, pc, i);
+        bi->tableTags[i] = tableTags[i];
+    }
+
+    bi->hitBank = 0;
+    bi->altBank = 0;
+    //Look for the bank with longest matching history
+    for (int i = g.numTables; i > 0; i--) {
+        if (gtable[i][tableIndices[i]].tag == tableTags[i]) {
+            bi->hitBank = i;
+            bi->hitBankIndex = tableIndices[bi->hitBank];
+            break;
+        }
+    }
+    //Look for the alternate bank
+    for (int i = bi->hitBank - 1; i > 0; i--) {
+        if (gtable[i][tableIndices[i]].tag == tableTags[i]) {
+            bi->altBank = i;
+            bi->altBankIndex = tableIndices[bi->altBank];
+            break;
+        }
+    }
+}
+
+
+template <class G>
+void
+LTAGE::updateFoldedHistories(const G &g, ThreadHistory &tHist)
+{
+    for (int i = 1; i <= g.numTables; i++) {
+        if (G::fixed) {
+            tHist.computeIndices[i].update(tHist.gHist, g.histLengths[i],
+                                           g.tableSizes[i]);
+            tHist.computeTags[0][i].update(tHist.gHist, g.histLengths[i],
+                                           g.tagWidths[i]);
+            tHist.computeTags[1][i].update(tHist.gHist, g.histLengths[i],
+                                           g.tagWidths[i] - 1);
+        } else {
+            tHist.computeIndices[i].update(tHist.gHist);
+            tHist.computeTags[0][i].update(tHist.gHist);
+            tHist.computeTags[1][i].update(tHist.gHist);
+        }
+    }
 }
 
 
@@ -402,7 +488,7 @@ LTAGE::getGHR(ThreadID tid, void *bp_history) const
 bool
 LTAGE::predict(ThreadID tid, Addr branch_pc, bool cond_branch, void* &b)
 {
-    BranchInfo *bi = new BranchInfo(nHistoryTables+1);
+    BranchInfo *bi = new (historyPool.alloc()) BranchInfo(nHistoryTables+1);
     b = (void*)(bi);
     Addr pc = branch_pc;
     bool pred_taken = true;
@@ -410,35 +496,13 @@ LTAGE::predict(ThreadID tid, Addr branch_pc, bool cond_branch, void* &b)
 
     if (cond_branch) {
         // TAGE prediction
-
-        // computes the table addresses and the partial tags
-        for (int i = 1; i <= nHistoryTables; i++) {
-            tableIndices[i] = gindex(tid, pc, i);
-            bi->tableIndices[i] = tableIndices[i];
-            tableTags[i] = gtag(tid, pc, i);
-            bi->tableTags[i] = tableTags[i];
-        }
+        if (fixedGeometry)
+            tageLookup(DefaultGeometry(), tid, pc, bi);
+        else
+            tageLookup(runtimeGeometry, tid, pc, bi);
 
         bi->bimodalIndex = bindex(pc);
 
-        bi->hitBank = 0;
-        bi->altBank = 0;
-        //Look for the bank with longest matching history
-        for (int i = nHistoryTables; i > 0; i--) {
-            if (gtable[i][tableIndices[i]].tag == tableTags[i]) {
-                bi->hitBank = i;
-                bi->hitBankIndex = tableIndices[bi->hitBank];
-                break;
-            }
-        }
-        //Look for the alternate bank
-        for (int i = bi->hitBank - 1; i > 0; i--) {
-            if (gtable[i][tableIndices[i]].tag == tableTags[i]) {
-                bi->altBank = i;
-                bi->altBankIndex = tableIndices[bi->altBank];
-                break;
-            }
-        }
         //computes the prediction and the alternate prediction
         if (bi->hitBank > 0) {
             if (bi->altBank > 0) {
@@ -620,7 +684,7 @@ LTAGE::update(ThreadID tid, Addr branch_pc, bool taken, void* bp_history,
         //END PREDICTOR UPDATE
     }
     if (!squashed) {
-        delete bi;
+        historyPool.free(bi);
     }
 }
 
@@ -645,10 +709,11 @@ LTAGE::updateHistories(ThreadID tid, Addr branch_pc, bool taken, void* b)
         bi->ci[i]  = tHist.computeIndices[i].comp;
         bi->ct0[i] = tHist.computeTags[0][i].comp;
         bi->ct1[i] = tHist.computeTags[1][i].comp;
-        tHist.computeIndices[i].update(tHist.gHist);
-        tHist.computeTags[0][i].update(tHist.gHist);
-        tHist.computeTags[1][i].update(tHist.gHist);
     }
+    if (fixedGeometry)
+        updateFoldedHistories(DefaultGeometry(), tHist);
+    else
+        updateFoldedHistories(runtimeGeometry, tHist);
     DPRINTF(LTage, "Updating global histories with branch:%lx; taken?:%d, "
             "path Hist: %x; pointer:%d\n", branch_pc, taken, tHist.pathHist,
             tHist.ptGhist);
@@ -669,10 +734,11 @@ LTAGE::squash(ThreadID tid, bool taken, void *bp_history)
         tHist.computeIndices[i].comp = bi->ci[i];
         tHist.computeTags[0][i].comp = bi->ct0[i];
         tHist.computeTags[1][i].comp = bi->ct1[i];
-        tHist.computeIndices[i].update(tHist.gHist);
-        tHist.computeTags[0][i].update(tHist.gHist);
-        tHist.computeTags[1][i].update(tHist.gHist);
     }
+    if (fixedGeometry)
+        updateFoldedHistories(DefaultGeometry(), tHist);
+    else
+        updateFoldedHistories(runtimeGeometry, tHist);
 
     if (bi->condBranch) {
         if (bi->loopHit >= 0) {
@@ -695,7 +761,7 @@ LTAGE::squash(ThreadID tid, void *bp_history)
         }
     }
 
-    delete bi;
+    historyPool.free(bi);
 }
 
 bool
@@ -723,10 +789,11 @@ LTAGE::btbUpdate(ThreadID tid, Addr branch_pc, void* &bp_history)
         tHist.computeIndices[i].comp = bi->ci[i];
         tHist.computeTags[0][i].comp = bi->ct0[i];
         tHist.computeTags[1][i].comp = bi->ct1[i];
-        tHist.computeIndices[i].update(tHist.gHist);
-        tHist.computeTags[0][i].update(tHist.gHist);
-        tHist.computeTags[1][i].update(tHist.gHist);
     }
+    if (fixedGeometry)
+        updateFoldedHistories(DefaultGeometry(), tHist);
+    else
+        updateFoldedHistories(runtimeGeometry, tHist);
 }
 
 void
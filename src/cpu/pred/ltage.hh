@@ -98,13 +98,13 @@ class LTAGE: public BPredUnit
         BimodalEntry() : pred(0), hyst(1) { }
     };
 
-    // Tage Entry
+    // Tage Entry, packed in 4 bytes
     struct TageEntry
     {
-        int8_t ctr;
         uint16_t tag;
+        int8_t ctr;
         int8_t u;
-        TageEntry() : ctr(0), tag(0), u(0) { }
+        TageEntry() : tag(0), ctr(0), u(0) { }
     };
 
     // Folded History Table - compressed history
@@ -132,6 +132,46 @@ class LTAGE: public BPredUnit
             comp ^= (comp >> compLength);
             comp &= (ULL(1) << compLength) - 1;
         }
+
+        // Same, with the lengths known at compile time
+        void update(uint8_t * h, int original_length, int compressed_length)
+        {
+            comp = (comp << 1) | h[0];
+            comp ^= h[original_length] <<
+                (original_length % compressed_length);
+            comp ^= (comp >> compressed_length);
+            comp &= (ULL(1) << compressed_length) - 1;
+        }
+    };
+
+    // Geometry of the tagged tables (index 0 is unused). The
+    // prediction kernels are templates on it: DefaultGeometry is the
+    // default configuration as compile-time constants, which lets the
+    // compiler unroll the loops over the tables and fold the widths and
+    // lengths, RuntimeGeometry any other configuration.
+    struct DefaultGeometry
+    {
+        static const bool fixed = true;
+        static constexpr unsigned numTables = 12;
+        static constexpr unsigned logSizeTagTables = 11;
+        static constexpr unsigned minHist = 4;
+        static constexpr unsigned maxHist = 640;
+        static constexpr unsigned minTagWidth = 7;
+        static constexpr int histLengths[13] =
+            { 0, 4, 6, 10, 16, 25, 40, 64, 101, 160, 254, 403, 640 };
+        static constexpr int tagWidths[13] =
+            { 0, 7, 7, 8, 8, 9, 10, 11, 12, 12, 13, 14, 15 };
+        static constexpr int tableSizes[13] =
+            { 0, 10, 10, 11, 11, 11, 11, 10, 10, 10, 10, 9, 9 };
+    };
+
+    struct RuntimeGeometry
+    {
+        static const bool fixed = false;
+        unsigned numTables;
+        const int *histLengths;
+        const int *tagWidths;
+        const int *tableSizes;
     };
 
     // Primary branch history entry
@@ -158,13 +198,9 @@ class LTAGE: public BPredUnit
         bool pseudoNewAlloc;
         Addr branchPC;
 
-        // Pointer to dynamically allocated storage
-        // to save table indices and folded histories.
-        // To do one call to new instead of five.
-        int *storage;
-
-        // Pointers to actual saved array within the dynamically
-        // allocated storage.
+        // Pointers to the saved table indices and folded
+        // histories, stored after the BranchInfo in the
+        // same history pool object (see historyPool).
         int *tableIndices;
         int *tableTags;
         int *ci;
@@ -181,17 +217,18 @@ class LTAGE: public BPredUnit
               condBranch(false), longestMatchPred(false),
               pseudoNewAlloc(false), branchPC(0)
         {
-            storage = new int [sz * 5];
-            tableIndices = storage;
-            tableTags = storage + sz;
+            tableIndices = reinterpret_cast<int *>(this + 1);
+            tableTags = tableIndices + sz;
             ci = tableTags + sz;
             ct0 = ci + sz;
             ct1 = ct0 + sz;
         }
 
-        ~BranchInfo()
+        // Size of a BranchInfo and its arrays
+        static size_t
+        storageSize(int sz)
         {
-            delete[] storage;
+            return sizeof(BranchInfo) + sz * 5 * sizeof(int);
         }
     };
 
@@ -212,30 +249,57 @@ class LTAGE: public BPredUnit
     /**
      * Computes the index used to access a
      * partially tagged table.
+     * @param g The geometry of the tables.
      * @param tid The thread ID used to select the
      * global histories to use.
      * @param pc The unshifted branch PC.
      * @param bank The partially tagged table to access.
      */
-    inline int gindex(ThreadID tid, Addr pc, int bank) const;
+    template <class G>
+    inline int gindex(const G &g, ThreadID tid, Addr pc, int bank) const;
 
     /**
      * Utility function to shuffle the path history
      * depending on which tagged table we are accessing.
+     * @param g The geometry of the tables.
      * @param phist The path history.
      * @param size Number of path history bits to use.
      * @param bank The partially tagged table to access.
      */
-    int F(int phist, int size, int bank) const;
+    template <class G>
+    int F(const G &g, int phist, int size, int bank) const;
 
     /**
      * Computes the partial tag of a tagged table.
+     * @param g The geometry of the tables.
      * @param tid the thread ID used to select the
      * global histories to use.
      * @param pc The unshifted branch PC.
      * @param bank The partially tagged table to access.
      */
-    inline uint16_t gtag(ThreadID tid, Addr pc, int bank) const;
+    template <class G>
+    inline uint16_t gtag(const G &g, ThreadID tid, Addr pc, int bank) const;
+
+    /**
+     * Computes the indices and tags of all the tagged tables, and looks
+     * up the longest and alternate matching tables.
+     * @param g The geometry of the tables.
+     * @param tid The thread ID used to select the
+     * global histories to use.
+     * @param pc The unshifted branch PC.
+     * @param bi Pointer to information on the prediction.
+     */
+    template <class G>
+    void tageLookup(const G &g, ThreadID tid, Addr pc, BranchInfo *bi);
+
+    /**
+     * Updates the folded histories of a thread with the most recent
+     * branch outcome.
+     * @param g The geometry of the tables.
+     */
+    struct ThreadHistory;
+    template <class G>
+    void updateFoldedHistories(const G &g, ThreadHistory &tHist);
 
     /**
      * Updates a direction counter based on the actual
@@ -399,10 +463,17 @@ class LTAGE: public BPredUnit
     int *tableIndices;
     int *tableTags;
 
+    // Geometry of this predictor, and whether it is DefaultGeometry
+    RuntimeGeometry runtimeGeometry;
+    bool fixedGeometry;
+
     int8_t loopUseCounter;
     int8_t useAltPredForNewlyAllocated;
     int tCounter;
     int logTick;
+
+    // Storage of the BranchInfo objects
+    HistoryPool historyPool;
 };
 
 #endif // __CPU_PRED_LTAGE
@@ -60,7 +60,8 @@ TournamentBP::TournamentBP(const TournamentBPParams *params)
           ceilLog2(params->globalPredictorSize) :
           ceilLog2(params->choicePredictorSize)),
       choicePredictorSize(params->choicePredictorSize),
-      choiceCtrBits(params->choiceCtrBits)
+      choiceCtrBits(params->choiceCtrBits),
+      historyPool(sizeof(BPHistory))
 {
     if (!isPowerOf2(localPredictorSize)) {
         fatal("Invalid local predictor size!\n");
@@ -212,7 +213,7 @@ TournamentBP::lookup(ThreadID tid, Addr branch_addr, void * &bp_history)
       choiceCtrs[globalHistory[tid] & choiceHistoryMask].read();
 
     // Create BPHistory and pass it back to be recorded.
-    BPHistory *history = new BPHistory;
+    BPHistory *history = new (historyPool.alloc()) BPHistory;
     history->globalHistory = globalHistory[tid];
     history->localPredTaken = local_prediction;
     history->globalPredTaken = global_prediction;
@@ -252,7 +253,7 @@ void
 TournamentBP::uncondBranch(ThreadID tid, Addr pc, void * &bp_history)
 {
     // Create BPHistory and pass it back to be recorded.
-    BPHistory *history = new BPHistory;
+    BPHistory *history = new (historyPool.alloc()) BPHistory;
     history->globalHistory = globalHistory[tid];
     history->localPredTaken = true;
     history->globalPredTaken = true;
@@ -339,7 +340,8 @@ TournamentBP::update(ThreadID tid, Addr branch_addr, bool taken,
     }
 
     // We're done with this history, now delete it.
-    delete history;
+    history->~BPHistory();
+    historyPool.free(history);
 }
 
 void
@@ -356,7 +358,8 @@ TournamentBP::squash(ThreadID tid, void *bp_history)
     }
 
     // Delete this BPHistory now that we're done with it.
-    delete history;
+    history->~BPHistory();
+    historyPool.free(history);
 }
 
 TournamentBP*
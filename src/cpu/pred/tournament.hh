@@ -239,6 +239,9 @@ class TournamentBP : public BPredUnit
     unsigned localThreshold;
     unsigned globalThreshold;
     unsigned choiceThreshold;
+
+    /** Storage of the BPHistory objects. */
+    HistoryPool historyPool;
 };
 
 #endif // __CPU_PRED_TOURNAMENT_PRED_HH__
@@ -39,6 +39,7 @@
 # Authors: Nathan Binkert
 
 from m5.params import *
+from m5.SimObject import *
 from BaseSimpleCPU import BaseSimpleCPU
 from SimPoint import SimPoint
 
@@ -50,6 +51,10 @@ class AtomicSimpleCPU(BaseSimpleCPU):
     type = 'AtomicSimpleCPU'
     cxx_header = "cpu/simple/atomic.hh"
 
+    cxx_exports = [
+        PyBindMethod("scheduleWarmup"),
+    ]
+
     @classmethod
     def memory_mode(cls):
         return 'atomic'
@@ -62,6 +67,21 @@ class AtomicSimpleCPU(BaseSimpleCPU):
     simulate_data_stalls = Param.Bool(False, "Simulate dcache stall cycles")
     simulate_inst_stalls = Param.Bool(False, "Simulate icache stall cycles")
     fastmem = Param.Bool(False, "Access memory directly")
+    fetch_block_cache = Param.Bool(False, "Replay decoded basic blocks "
+        "rather than decoding every instruction, needs "
+        "fastmem (x86 SE mode only)")
+    fetch_block_cache_size = Param.Unsigned(65536, "Number of blocks "
+        "after which the fetch block cache is flushed")
+    fetch_block_insts = Param.Unsigned(64, "Maximum number of "
+        "instructions in a fetch block")
+    warmup_insts = Param.Counter(0, "Number of instructions before "
+        "max_insts_any_thread during which the branch predictor is used "
+        "and memory is accessed through the caches (not fastmem), to warm "
+        "them for the CPU switched in (the whole run without "
+        "max_insts_any_thread); 0 to disable. Later windows are opened "
+        "with scheduleWarmup() and every window ends at switchOut()")
+    warmup_all = Param.Bool(False, "Warm up during the whole run of the "
+        "CPU instead of warmup_insts, every time it is switched in")
 
     def addSimPointProbe(self, interval):
         simpoint = SimPoint()
@@ -72,6 +72,37 @@ AtomicSimpleCPU::init()
     ifetch_req.setContext(cid);
     data_read_req.setContext(cid);
     data_write_req.setContext(cid);
+
+    if (fetchBlockCache) {
+        // The blocks are keyed by pc, which only identifies the decoded
+        // instruction if the decoder has no other context.
+        fatal_if(FullSystem || THE_ISA != X86_ISA,
+                 "%s: The fetch block cache is only supported for x86 in "
+                 "SE mode\n", name());
+        fatal_if(!fastmem, "%s: The fetch block cache needs fastmem\n",
+                 name());
+        for (ThreadID tid = 0; tid < numThreads; tid++) {
+            fetchBlocks.push_back(new FetchBlockCache(system->getPhysMem(),
+                                                      fetchBlockCacheSize,
+                                                      fetchBlockInsts));
+        }
+    }
+}
+
+void
+AtomicSimpleCPU::regStats()
+{
+    BaseSimpleCPU::regStats();
+
+    if (fetchBlocks.empty())
+        return;
+
+    for (ThreadID tid = 0; tid < numThreads; tid++) {
+        std::string thread_str = name();
+        if (numThreads > 1)
+            thread_str += ".thread" + std::to_string(tid);
+        fetchBlocks[tid]->regStats(thread_str);
+    }
 }
 
 AtomicSimpleCPU::AtomicSimpleCPU(AtomicSimpleCPUParams *p)
@@ -83,10 +114,28 @@ AtomicSimpleCPU::AtomicSimpleCPU(AtomicSimpleCPUParams *p)
       simulate_inst_stalls(p->simulate_inst_stalls),
       icachePort(name() + ".icache_port", this),
       dcachePort(name() + ".dcache_port", this),
-      fastmem(p->fastmem), dcache_access(false), dcache_latency(0),
+      fastmem(p->fastmem), fastmemParam(p->fastmem),
+      fetchBlockCache(p->fetch_block_cache),
+      fetchBlockCacheSize(p->fetch_block_cache_size),
+      fetchBlockInsts(p->fetch_block_insts),
+      warmupInsts(p->warmup_insts), warmupAll(p->warmup_all),
+      warmupBranchPred(NULL),
+      warmingUp(false), dcache_access(false), dcache_latency(0),
       ppCommit(nullptr)
 {
     _status = Idle;
+
+    if (warmupInsts != 0 || warmupAll) {
+        warmupBranchPred = branchPred;
+        branchPred = NULL;
+    }
+    if (warmupAll) {
+        if (!p->switched_out)
+            scheduleWarmup(0);
+    } else if (warmupInsts != 0) {
+        scheduleWarmup(p->max_insts_any_thread > warmupInsts ?
+                       p->max_insts_any_thread - warmupInsts : 0);
+    }
 }
 
 
@@ -95,6 +144,8 @@ AtomicSimpleCPU::~AtomicSimpleCPU()
     if (tickEvent.scheduled()) {
         deschedule(tickEvent);
     }
+    for (auto fbc : fetchBlocks)
+        delete fbc;
 }
 
 DrainState
@@ -195,6 +246,13 @@ AtomicSimpleCPU::switchOut()
     assert(!tickEvent.scheduled());
     assert(_status == BaseSimpleCPU::Running || _status == Idle);
     assert(isDrained());
+
+    // The CPU switched in has been warmed up
+    stopWarmup();
+
+    // Another CPU runs until we take over again
+    for (auto fbc : fetchBlocks)
+        fbc->flush();
 }
 
 
@@ -205,6 +263,52 @@ AtomicSimpleCPU::takeOverFrom(BaseCPU *oldCPU)
 
     // The tick event should have been descheduled by drain()
     assert(!tickEvent.scheduled());
+
+    if (warmupAll)
+        startWarmup();
+}
+
+void
+AtomicSimpleCPU::startWarmup()
+{
+    if (warmingUp)
+        return;
+
+    DPRINTF(SimpleCPU, "Warming up the branch predictor and caches\n");
+    warmingUp = true;
+    branchPred = warmupBranchPred;
+
+    // The fetch blocks are only replayed with fastmem, as their bytes
+    // are checked against memory.
+    fastmem = false;
+    for (auto fbc : fetchBlocks)
+        fbc->flush();
+}
+
+void
+AtomicSimpleCPU::stopWarmup()
+{
+    if (!warmingUp)
+        return;
+
+    DPRINTF(SimpleCPU, "Warmup done\n");
+    warmingUp = false;
+    branchPred = NULL;
+    fastmem = fastmemParam;
+}
+
+void
+AtomicSimpleCPU::scheduleWarmup(Counter insts)
+{
+    fatal_if(warmupInsts == 0 && !warmupAll,
+             "%s: Warmup needs warmup_insts or warmup_all\n", name());
+
+    for (ThreadID tid = 0; tid < numThreads; ++tid) {
+        Event *event = new EventFunctionWrapper([this]{ startWarmup(); },
+                                                name() + ".warmup", true);
+        comInstEventQueue[tid]->schedule(event,
+            comInstEventQueue[tid]->getCurTick() + insts);
+    }
 }
 
 void
@@ -360,6 +464,8 @@ AtomicSimpleCPU::readMem(Addr addr, uint8_t * data, unsigned size,
         if (fault == NoFault && !req->getFlags().isSet(Request::NO_ACCESS)) {
             Packet pkt(req, Packet::makeReadCmd(req));
             pkt.dataStatic(data);
+            if (warmingUp)
+                pkt.setWarmup();
 
             if (req->isMmappedIpr())
                 dcache_latency += TheISA::handleIprRead(thread->getTC(), &pkt);
@@ -475,6 +581,8 @@ AtomicSimpleCPU::writeMem(uint8_t *data, unsigned size, Addr addr,
             if (do_access && !req->getFlags().isSet(Request::NO_ACCESS)) {
                 Packet pkt(req, Packet::makeWriteCmd(req));
                 pkt.dataStatic(data);
+                if (warmingUp)
+                    pkt.setWarmup();
 
                 if (req->isMmappedIpr()) {
                     dcache_latency +=
@@ -487,6 +595,10 @@ AtomicSimpleCPU::writeMem(uint8_t *data, unsigned size, Addr addr,
 
                     // Notify other threads on this CPU of write
                     threadSnoop(&pkt, curThread);
+
+                    // Leave the blocks this write modifies
+                    for (auto fbc : fetchBlocks)
+                        fbc->notifyWrite(req->getPaddr(), size);
                 }
                 dcache_access = true;
                 assert(!pkt.isError());
@@ -576,6 +688,7 @@ AtomicSimpleCPU::tick()
 
         bool needToFetch = !isRomMicroPC(pcState.microPC()) &&
                            !curMacroStaticInst;
+
         if (needToFetch) {
             ifetch_req.taskId(taskId());
             setupFetchRequest(&ifetch_req);
@@ -583,6 +696,23 @@ AtomicSimpleCPU::tick()
                                                  BaseTLB::Execute);
         }
 
+        // An instruction of the fetch block cache is still translated
+        // and fetched, in as many parts as when it was decoded, so that
+        // only the decoding is saved and the TLB, memory and cycle
+        // counts are unchanged.
+        FetchBlockCache *fbc =
+            fetchBlocks.empty() || !fastmem ? NULL : fetchBlocks[curThread];
+        const FetchBlockCache::Inst *cached_inst = NULL;
+        if (needToFetch && fbc && fault == NoFault) {
+            if (t_info.fetchOffset != 0) {
+                cached_inst = fbc->fetching();
+            } else {
+                cached_inst = fbc->next(pcState);
+                if (!cached_inst && !fbc->recording())
+                    cached_inst = fbc->enter(pcState, ifetch_req.getPaddr());
+            }
+        }
+
         if (fault == NoFault) {
             Tick icache_latency = 0;
             bool icache_access = false;
@@ -599,6 +729,8 @@ AtomicSimpleCPU::tick()
                     icache_access = true;
                     Packet ifetch_pkt = Packet(&ifetch_req, MemCmd::ReadReq);
                     ifetch_pkt.dataStatic(&inst);
+                    if (warmingUp)
+                        ifetch_pkt.setWarmup();
 
                     if (fastmem && system->isMemAddr(ifetch_pkt.getAddr()))
                         system->getPhysMem().access(&ifetch_pkt);
@@ -610,9 +742,26 @@ AtomicSimpleCPU::tick()
                     // ifetch_req is initialized to read the instruction directly
                     // into the CPU object's inst field.
                 //}
+
+                if (fbc && !cached_inst)
+                    fbc->fetched(t_info.fetchOffset, ifetch_req.getPaddr());
             }
 
-            preExecute();
+            if (cached_inst) {
+                bool more_bytes = t_info.fetchOffset +
+                    sizeof(TheISA::MachInst) < cached_inst->fetchSize;
+                if (!more_bytes)
+                    thread->pcState(cached_inst->decodedPC);
+                preExecute(cached_inst->staticInst, more_bytes);
+                fbc->fetching(more_bytes ? cached_inst : NULL);
+            } else {
+                preExecute();
+                if (fbc && needToFetch && !t_info.stayAtPC) {
+                    fbc->record(pcState, thread->pcState(),
+                                curMacroStaticInst ? curMacroStaticInst :
+                                curStaticInst);
+                }
+            }
 
             Tick stall_ticks = 0;
             if (curStaticInst) {
@@ -658,6 +807,8 @@ AtomicSimpleCPU::tick()
             }
 
         }
+        if (fault != NoFault && fbc)
+            fbc->stop();
         if (fault != NoFault || !t_info.stayAtPC)
             advancePC(fault);
     }
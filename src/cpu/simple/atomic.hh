@@ -45,6 +45,7 @@
 
 #include "cpu/simple/base.hh"
 #include "cpu/simple/exec_context.hh"
+#include "cpu/simple/fetch_block_cache.hh"
 #include "mem/request.hh"
 #include "params/AtomicSimpleCPU.hh"
 #include "sim/probe/probe.hh"
@@ -57,6 +58,7 @@ class AtomicSimpleCPU : public BaseSimpleCPU
     virtual ~AtomicSimpleCPU();
 
     void init() override;
+    void regStats() override;
 
   private:
 
@@ -159,6 +161,36 @@ class AtomicSimpleCPU : public BaseSimpleCPU
     AtomicCPUDPort dcachePort;
 
     bool fastmem;
+    /** The fastmem parameter, restored at the end of a warmup window. */
+    const bool fastmemParam;
+
+    /**
+     * Decoded basic blocks of each thread, empty if the fetch block
+     * cache is disabled. The blocks are replayed rather than fetching
+     * and decoding every instruction.
+     */
+    const bool fetchBlockCache;
+    const unsigned fetchBlockCacheSize;
+    const unsigned fetchBlockInsts;
+    std::vector<FetchBlockCache *> fetchBlocks;
+
+    /**
+     * Warmup of the predictors and caches of the CPU switched in, which
+     * shares its branch predictor with this CPU. In a warmup window the
+     * branch predictor is used, fastmem is disabled and the memory
+     * accesses are flagged as warmup accesses, which Ruby installs in
+     * its caches. The first window covers the last warmupInsts
+     * instructions before max_insts_any_thread, or the whole run
+     * without it, and every window ends when the CPU is switched out.
+     * With warmupAll, a window opens every time the CPU is switched in.
+     */
+    const Counter warmupInsts;
+    const bool warmupAll;
+    BPredUnit *warmupBranchPred;
+    bool warmingUp;
+    void startWarmup();
+    void stopWarmup();
+
     Request ifetch_req;
     Request data_read_req;
     Request data_write_req;
@@ -188,6 +220,12 @@ class AtomicSimpleCPU : public BaseSimpleCPU
     void switchOut() override;
     void takeOverFrom(BaseCPU *oldCPU) override;
 
+    /**
+     * Open a new warmup window after insts more instructions of any
+     * thread, e.g., before switching out again after a switch back.
+     */
+    void scheduleWarmup(Counter insts);
+
     void verifyMemoryMode() const override;
 
     void activateContext(ThreadID thread_num) override;
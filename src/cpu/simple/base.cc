@@ -485,7 +485,7 @@ BaseSimpleCPU::setupFetchRequest(Request *req)
 
 
 void
-BaseSimpleCPU::preExecute()
+BaseSimpleCPU::preExecute(const StaticInstPtr &predecoded, bool more_bytes)
 {
     SimpleExecContext &t_info = *threadInfo[curThread];
     SimpleThread* thread = t_info.thread;
@@ -513,25 +513,34 @@ BaseSimpleCPU::preExecute()
         //We're not in the middle of a macro instruction
         StaticInstPtr instPtr = NULL;
 
-        TheISA::Decoder *decoder = &(thread->decoder);
-
-        //Predecode, ie bundle up an ExtMachInst
-        //If more fetch data is needed, pass it in.
-        Addr fetchPC = (pcState.instAddr() & PCMask) + t_info.fetchOffset;
-        //if (decoder->needMoreBytes())
-            decoder->moreBytes(pcState, fetchPC, inst);
-        //else
-        //    decoder->process();
-
-        //Decode an instruction if one is ready. Otherwise, we'll have to
-        //fetch beyond the MachInst at the current pc.
-        instPtr = decoder->decode(pcState);
-        if (instPtr) {
-            t_info.stayAtPC = false;
-            thread->pcState(pcState);
-        } else {
+        if (predecoded && more_bytes) {
             t_info.stayAtPC = true;
             t_info.fetchOffset += sizeof(MachInst);
+        } else if (predecoded) {
+            //The caller has already set the pc after decoding
+            instPtr = predecoded;
+            t_info.stayAtPC = false;
+        } else {
+            TheISA::Decoder *decoder = &(thread->decoder);
+
+            //Predecode, ie bundle up an ExtMachInst
+            //If more fetch data is needed, pass it in.
+            Addr fetchPC = (pcState.instAddr() & PCMask) + t_info.fetchOffset;
+            //if (decoder->needMoreBytes())
+                decoder->moreBytes(pcState, fetchPC, inst);
+            //else
+            //    decoder->process();
+
+            //Decode an instruction if one is ready. Otherwise, we'll have
+            //to fetch beyond the MachInst at the current pc.
+            instPtr = decoder->decode(pcState);
+            if (instPtr) {
+                t_info.stayAtPC = false;
+                thread->pcState(pcState);
+            } else {
+                t_info.stayAtPC = true;
+                t_info.fetchOffset += sizeof(MachInst);
+            }
         }
 
         //If we decoded an instruction and it's microcoded, start pulling
@@ -130,7 +130,14 @@ class BaseSimpleCPU : public BaseCPU
 
     void checkForInterrupts();
     void setupFetchRequest(Request *req);
-    void preExecute();
+    /**
+     * Decode the instruction at the current pc from the fetched bytes,
+     * unless it is given already decoded. With more_bytes, the given
+     * instruction was decoded from more bytes than fetched so far, and
+     * the thread waits for them at its pc as the decoder would.
+     */
+    void preExecute(const StaticInstPtr &predecoded =
+                    StaticInst::nullStaticInstPtr, bool more_bytes = false);
     void postExecute();
     void advancePC(const Fault &fault);
 
@@ -0,0 +1,250 @@
+/*
+ * Copyright (c) 2018 The University of Illinois at Urbana-Champaign
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cpu/simple/fetch_block_cache.hh"
+
+#include <cstring>
+
+#include "arch/isa_traits.hh"
+#include "base/intmath.hh"
+#include "base/logging.hh"
+#include "cpu/base.hh"
+
+using namespace std;
+
+FetchBlockCache::FetchBlockCache(const PhysicalMemory &mem,
+                                 unsigned max_blocks,
+                                 unsigned max_block_insts)
+    : backingStore(mem.getBackingStore()), maxBlocks(max_blocks),
+      maxBlockInsts(max_block_insts), curBlock(NULL), curIdx(0),
+      recBlock(NULL), fetchingInst(), fetchStart(0), fetchSize(0), fetchContig(false)
+{
+    fatal_if(max_blocks == 0 || max_block_insts == 0,
+             "The fetch block cache needs at least one block and "
+             "instruction\n");
+}
+
+const uint8_t *
+FetchBlockCache::hostAddr(Addr paddr) const
+{
+    for (const auto &entry : backingStore) {
+        if (entry.pmem && !entry.range.interleaved() &&
+            entry.range.contains(paddr)) {
+            return entry.pmem + (paddr - entry.range.start());
+        }
+    }
+    return NULL;
+}
+
+bool
+FetchBlockCache::validBlock(const Block *blk, const TheISA::PCState &pc,
+                            Addr paddr) const
+{
+    // The bytes are compared last, the other checks only fail if the
+    // block was reset or the page was remapped.
+    return !blk->insts.empty() && blk->insts[0].pc == pc &&
+        blk->paddr == paddr &&
+        memcmp(blk->host, blk->bytes.data(), blk->bytes.size()) == 0;
+}
+
+const FetchBlockCache::Inst *
+FetchBlockCache::enter(const TheISA::PCState &pc, Addr paddr)
+{
+    Block *prev = curBlock;
+    curBlock = NULL;
+
+    // Follow the chain of the last block before looking up the map
+    Block *blk = NULL;
+    if (prev) {
+        for (auto succ : prev->succ) {
+            if (succ && !succ->insts.empty() && succ->insts[0].pc == pc) {
+                blk = succ;
+                break;
+            }
+        }
+    }
+    if (!blk) {
+        auto it = blocks.find(pc.instAddr());
+        if (it != blocks.end())
+            blk = &it->second;
+    }
+
+    if (blk) {
+        if (validBlock(blk, pc, paddr)) {
+            if (prev && prev->succ[0] != blk) {
+                prev->succ[1] = prev->succ[0];
+                prev->succ[0] = blk;
+            }
+            curBlock = blk;
+            curIdx = 0;
+            ++numHits;
+            ++numInsts;
+            return &blk->insts[0];
+        }
+        if (!blk->insts.empty())
+            ++numInvalidations;
+    }
+
+    ++numMisses;
+    startRecord(pc, paddr);
+    return NULL;
+}
+
+void
+FetchBlockCache::startRecord(const TheISA::PCState &pc, Addr paddr)
+{
+    // Blocks are reset in place rather than erased, the blocks chained
+    // to them check their first pc when they are followed.
+    if (blocks.size() >= maxBlocks && !blocks.count(pc.instAddr()))
+        flush();
+
+    Block &blk = blocks[pc.instAddr()];
+    blk.insts.clear();
+    blk.vaddr = pc.instAddr();
+    blk.paddr = paddr;
+    blk.bytesStart = paddr;
+    blk.bytes.clear();
+    blk.host = hostAddr(paddr);
+    blk.succ[0] = blk.succ[1] = NULL;
+    recBlock = blk.host ? &blk : NULL;
+}
+
+void
+FetchBlockCache::record(const TheISA::PCState &pc,
+                        const TheISA::PCState &decoded_pc,
+                        const StaticInstPtr &inst)
+{
+    if (!recBlock || !inst)
+        return;
+
+    Block *blk = recBlock;
+    Addr page = roundDown(blk->paddr, TheISA::PageBytes);
+    Addr fetch_end = fetchStart + fetchSize;
+    Addr bytes_end = blk->bytesStart + blk->bytes.size();
+
+    // The instruction must follow the last one, and be fetched from
+    // the page of the block with the same mapping.
+    bool fall_through = blk->insts.empty() ?
+        pc.instAddr() == blk->vaddr :
+        pc.instAddr() == blk->insts.back().decodedPC.npc();
+    bool fits = fall_through && fetchContig &&
+        blk->insts.size() < maxBlockInsts &&
+        roundDown(fetchStart, TheISA::PageBytes) == page &&
+        roundDown(fetch_end - 1, TheISA::PageBytes) == page &&
+        fetchStart - blk->paddr ==
+            (pc.instAddr() & BaseCPU::PCMask) -
+            (blk->vaddr & BaseCPU::PCMask) &&
+        fetchStart >= blk->bytesStart && fetchStart <= bytes_end;
+
+    const uint8_t *host = NULL;
+    if (fits) {
+        // Bytes already in the block must not have changed since they
+        // were decoded.
+        Addr offset = fetchStart - blk->bytesStart;
+        host = blk->host + offset;
+        fits = memcmp(host, blk->bytes.data() + offset,
+                      min(fetch_end, bytes_end) - fetchStart) == 0;
+    }
+
+    if (!fits) {
+        endRecord();
+        // Record a new block from a branch target, unless there is one
+        if (!fall_through && fetchContig) {
+            auto it = blocks.find(pc.instAddr());
+            if (it == blocks.end() ||
+                !validBlock(&it->second, pc, fetchStart)) {
+                startRecord(pc, fetchStart);
+                record(pc, decoded_pc, inst);
+            }
+        }
+        return;
+    }
+
+    if (fetch_end > bytes_end) {
+        blk->bytes.insert(blk->bytes.end(), host + (bytes_end - fetchStart),
+                          host + fetchSize);
+    }
+    blk->insts.push_back({ pc, decoded_pc, inst, fetchSize });
+
+    if (inst->isControl() || blk->insts.size() == maxBlockInsts)
+        endRecord();
+}
+
+bool
+FetchBlockCache::overlaps(const Block *blk, Addr paddr, unsigned size) const
+{
+    return paddr < blk->bytesStart + blk->bytes.size() &&
+        paddr + size > blk->bytesStart;
+}
+
+void
+FetchBlockCache::notifyWrite(Addr paddr, unsigned size)
+{
+    if (curBlock && overlaps(curBlock, paddr, size))
+        curBlock = NULL;
+    if (recBlock && overlaps(recBlock, paddr, size))
+        endRecord();
+}
+
+void
+FetchBlockCache::flush()
+{
+    blocks.clear();
+    curBlock = NULL;
+    recBlock = NULL;
+    ++numFlushes;
+}
+
+void
+FetchBlockCache::regStats(const string &name)
+{
+    numInsts
+        .name(name + ".fetchBlockInsts")
+        .desc("Number of instructions executed from the fetch block cache")
+        ;
+
+    numHits
+        .name(name + ".fetchBlockHits")
+        .desc("Number of blocks entered in the fetch block cache")
+        ;
+
+    numMisses
+        .name(name + ".fetchBlockMisses")
+        .desc("Number of fetch block cache misses")
+        ;
+
+    numInvalidations
+        .name(name + ".fetchBlockInvalidations")
+        .desc("Number of blocks invalidated by a write or a remapping")
+        ;
+
+    numFlushes
+        .name(name + ".fetchBlockFlushes")
+        .desc("Number of times the fetch block cache was flushed")
+        ;
+}
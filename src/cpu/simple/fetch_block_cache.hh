@@ -0,0 +1,215 @@
+/*
+ * Copyright (c) 2018 The University of Illinois at Urbana-Champaign
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Cache of decoded basic blocks for the atomic CPU. Blocks are recorded
+ * as the CPU fetches and decodes instructions the usual way, and are
+ * then replayed without decoding them. The CPU still translates and
+ * fetches every instruction it replays, so that its statistics are
+ * those of a run without the cache. A block lies within a single page;
+ * its page mapping is checked when its first instruction is translated,
+ * and the bytes it was decoded from are compared to memory, every time
+ * it is entered.
+ */
+
+#ifndef __CPU_SIMPLE_FETCH_BLOCK_CACHE_HH__
+#define __CPU_SIMPLE_FETCH_BLOCK_CACHE_HH__
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "arch/types.hh"
+#include "base/statistics.hh"
+#include "base/types.hh"
+#include "cpu/static_inst.hh"
+#include "mem/physical.hh"
+
+class FetchBlockCache
+{
+  public:
+    struct Inst
+    {
+        //! The pc before and after decoding the instruction
+        TheISA::PCState pc;
+        TheISA::PCState decodedPC;
+        StaticInstPtr staticInst;
+        //! Bytes fetched to decode it, one MachInst at a time
+        unsigned fetchSize;
+    };
+
+    /**
+     * @param mem Memory the instructions are fetched from, only
+     *            instructions in its backing store are cached.
+     * @param max_blocks Number of blocks after which the cache is
+     *                   flushed.
+     * @param max_block_insts Maximum number of instructions in a block.
+     */
+    FetchBlockCache(const PhysicalMemory &mem, unsigned max_blocks,
+                    unsigned max_block_insts);
+
+    /**
+     * Next instruction of the block being executed.
+     *
+     * @param pc The pc of the thread, before decoding.
+     * @return NULL if pc does not continue the block, a block must then
+     *         be entered.
+     */
+    const Inst *
+    next(const TheISA::PCState &pc)
+    {
+        if (!curBlock || curIdx + 1 >= curBlock->insts.size())
+            return NULL;
+        const Inst *inst = &curBlock->insts[curIdx + 1];
+        if (!(inst->pc == pc))
+            return NULL;
+        ++curIdx;
+        ++numInsts;
+        return inst;
+    }
+
+    /**
+     * Enter the block starting at pc. If there is no valid block, start
+     * recording one.
+     *
+     * @param pc The pc of the thread, before decoding.
+     * @param paddr Physical address of the first fetch for pc.
+     * @return The first instruction of the block, NULL on a miss.
+     */
+    const Inst *enter(const TheISA::PCState &pc, Addr paddr);
+
+    bool recording() const { return recBlock != NULL; }
+
+    /**
+     * The instruction whose bytes the CPU is still fetching, set by the
+     * CPU between the fetches of an instruction that takes several. It
+     * is kept as a copy, which a flush in between does not free.
+     */
+    const Inst *
+    fetching() const
+    {
+        return fetchingInst.staticInst ? &fetchingInst : NULL;
+    }
+
+    void fetching(const Inst *inst) { fetchingInst = inst ? *inst : Inst(); }
+
+    /**
+     * Track the bytes fetched by the CPU for the instruction it is
+     * decoding.
+     *
+     * @param offset Offset of the fetch from the first one.
+     */
+    void
+    fetched(Addr offset, Addr paddr)
+    {
+        if (offset == 0) {
+            fetchStart = paddr;
+            fetchContig = true;
+        } else if (paddr != fetchStart + offset) {
+            fetchContig = false;
+        }
+        fetchSize = offset + sizeof(TheISA::MachInst);
+    }
+
+    /**
+     * Record an instruction decoded by the CPU from the bytes it last
+     * fetched. The block ends after a control instruction, and before
+     * an instruction it cannot hold; if that instruction is not the
+     * fall through of the block, a new block is recorded from it.
+     */
+    void record(const TheISA::PCState &pc, const TheISA::PCState &decoded_pc,
+                const StaticInstPtr &inst);
+
+    /** Stop executing and recording blocks, e.g., on a fault. */
+    void
+    stop()
+    {
+        curBlock = NULL;
+        fetchingInst = Inst();
+        endRecord();
+    }
+
+    /**
+     * A write to memory. The block being executed is left if the write
+     * hits it; the next instruction then enters a block, and its bytes
+     * are checked.
+     */
+    void notifyWrite(Addr paddr, unsigned size);
+
+    void flush();
+
+    void regStats(const std::string &name);
+
+  private:
+    struct Block
+    {
+        std::vector<Inst> insts;
+        //! Address of the first instruction, physical address of the
+        //! first fetch for it
+        Addr vaddr;
+        Addr paddr;
+        //! Fetched bytes the instructions were decoded from
+        Addr bytesStart;
+        std::vector<uint8_t> bytes;
+        const uint8_t *host;
+        //! Blocks last entered from this one
+        Block *succ[2];
+    };
+
+    const uint8_t *hostAddr(Addr paddr) const;
+    bool validBlock(const Block *blk, const TheISA::PCState &pc,
+                    Addr paddr) const;
+    bool overlaps(const Block *blk, Addr paddr, unsigned size) const;
+    void startRecord(const TheISA::PCState &pc, Addr paddr);
+    void endRecord() { recBlock = NULL; }
+
+    const std::vector<BackingStoreEntry> backingStore;
+    const unsigned maxBlocks;
+    const unsigned maxBlockInsts;
+
+    //! Blocks by virtual address of their first instruction
+    std::unordered_map<Addr, Block> blocks;
+
+    Block *curBlock;
+    unsigned curIdx;
+    Block *recBlock;
+    Inst fetchingInst;
+
+    //! Bytes fetched for the instruction being decoded
+    Addr fetchStart;
+    unsigned fetchSize;
+    bool fetchContig;
+
+    Stats::Scalar numInsts;
+    Stats::Scalar numHits;
+    Stats::Scalar numMisses;
+    Stats::Scalar numInvalidations;
+    Stats::Scalar numFlushes;
+};
+
+#endif // __CPU_SIMPLE_FETCH_BLOCK_CACHE_HH__
@@ -73,3 +73,6 @@ class MemTest(MemObject):
     # accesses as Ruby needs this
     suppress_func_warnings = Param.Bool(False, "Suppress warnings when "\
                                             "functional accesses fail.")
+    functional_range = Param.Bool(False, "Send functional accesses as "\
+                                      "ranges when the memory system "\
+                                      "serves them, like port proxies")
@@ -49,6 +49,7 @@
 #include "base/trace.hh"
 #include "debug/MemTest.hh"
 #include "mem/mem_object.hh"
+#include "mem/port_proxy.hh"
 #include "sim/sim_exit.hh"
 #include "sim/stats.hh"
 #include "sim/system.hh"
@@ -96,6 +97,7 @@ MemTest::MemTest(const Params *p)
       percentReads(p->percent_reads),
       percentFunctional(p->percent_functional),
       percentUncacheable(p->percent_uncacheable),
+      functionalRange(p->functional_range),
       masterId(p->system->getMasterId(name())),
       blockSize(p->system->cacheLineSize()),
       blockAddrMask(blockSize - 1),
@@ -289,8 +291,19 @@ MemTest::tick()
     // there is no point in ticking if we are waiting for a retry
     bool keep_ticking = true;
     if (do_functional) {
-        pkt->setSuppressFuncError();
-        port.sendFunctional(pkt);
+        FunctionalRangeInterface *range_peer = functionalRange ?
+            dynamic_cast<FunctionalRangeInterface *>(&port.getSlavePort()) :
+            NULL;
+        bool done = false;
+        if (range_peer && pkt->isRead()) {
+            done = range_peer->functionalReadRange(paddr, pkt_data, 1);
+        } else if (range_peer) {
+            done = range_peer->functionalWriteRange(paddr, pkt_data, 1);
+        }
+        if (!done) {
+            pkt->setSuppressFuncError();
+            port.sendFunctional(pkt);
+        }
         completeRequest(pkt, true);
     } else {
         keep_ticking = sendPkt(pkt);
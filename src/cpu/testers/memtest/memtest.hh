@@ -129,6 +129,12 @@ class MemTest : public MemObject
     const unsigned percentFunctional;
     const unsigned percentUncacheable;
 
+    /**
+     * Send the functional accesses as ranges when the slave port
+     * serves whole ranges, as port proxies do (see port_proxy.hh).
+     */
+    const bool functionalRange;
+
     /** Request id for all generated traffic */
     MasterID masterId;
 
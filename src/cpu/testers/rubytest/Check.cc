@@ -39,7 +39,7 @@ typedef RubyTester::SenderState SenderState;
 Check::Check(Addr address, Addr pc, int _num_writers, int _num_readers,
              RubyTester* _tester)
     : m_num_writers(_num_writers), m_num_readers(_num_readers),
-      m_tester_ptr(_tester)
+      m_tester_ptr(_tester), m_spec_idx(-1), m_spec_port(-1)
 {
     m_status = TesterStatus_Idle;
 
@@ -71,6 +71,8 @@ Check::initiate()
         initiateAction();
     } else if (m_status == TesterStatus_Ready) {
         initiateCheck();
+    } else if (m_status == TesterStatus_Expose_Ready) {
+        initiateExpose();
     } else {
         // Pending - do nothing
         DPRINTF(RubyTest,
@@ -243,12 +245,28 @@ Check::initiateCheck()
         flags.set(Request::INST_FETCH);
     }
 
+    // 1 in 2 chance that a data check is a spec load, which is exposed
+    // and checked again once the first check succeeds
+    MemCmd cmd = MemCmd::ReadReq;
+    if (m_tester_ptr->getSpecChecks() && !flags.isSet(Request::INST_FETCH) &&
+        random_mt.random(0, 0x1)) {
+        m_spec_idx = m_tester_ptr->allocSpecIdx(index);
+        if (m_spec_idx >= 0) {
+            m_spec_port = index;
+            cmd = MemCmd::ReadSpecReq;
+        }
+    }
+
     // Checks are sized depending on the number of bytes written
     Request *req = new Request(m_address, CHECK_SIZE, flags,
                                m_tester_ptr->masterId(), curTick(), m_pc);
 
     req->setContext(index);
-    PacketPtr pkt = new Packet(req, MemCmd::ReadReq);
+    PacketPtr pkt = new Packet(req, cmd);
+    if (cmd == MemCmd::ReadSpecReq) {
+        pkt->reqIdx = m_spec_idx;
+        pkt->setFirst();
+    }
     uint8_t *dataArray = new uint8_t[CHECK_SIZE];
     pkt->dataDynamic(dataArray);
 
@@ -272,6 +290,12 @@ Check::initiateCheck()
         delete pkt->req;
         delete pkt;
 
+        if (m_spec_idx >= 0) {
+            m_tester_ptr->freeSpecIdx(m_spec_port, m_spec_idx);
+            m_spec_idx = -1;
+            m_spec_port = -1;
+        }
+
         DPRINTF(RubyTest, "failed to initiate check - cpu port not ready\n");
     }
 
@@ -279,6 +303,45 @@ Check::initiateCheck()
             TesterStatus_to_string(m_status).c_str());
 }
 
+void
+Check::initiateExpose()
+{
+    DPRINTF(RubyTest, "Initiating Expose\n");
+    assert(m_status == TesterStatus_Expose_Ready);
+
+    // The expose must match the spec load: same sequencer, entry,
+    // address and size
+    MasterPort* port = m_tester_ptr->getReadableCpuPort(m_spec_port);
+
+    Request::Flags flags;
+    Request *req = new Request(m_address, CHECK_SIZE, flags,
+                               m_tester_ptr->masterId(), curTick(), m_pc);
+
+    req->setContext(m_spec_port);
+    PacketPtr pkt = new Packet(req, MemCmd::ExposeReq);
+    pkt->reqIdx = m_spec_idx;
+    pkt->setFirst();
+    uint8_t *dataArray = new uint8_t[CHECK_SIZE];
+    pkt->dataDynamic(dataArray);
+
+    DPRINTF(RubyTest, "Seq expose: index %d idx %d\n", m_spec_port,
+            m_spec_idx);
+
+    pkt->senderState = new SenderState(m_address, req->getSize());
+
+    if (port->sendTimingReq(pkt)) {
+        DPRINTF(RubyTest, "initiating expose - successful\n");
+        m_status = TesterStatus_Expose_Pending;
+        DPRINTF(RubyTest, "Check %s, State=Expose_Pending\n", m_address);
+    } else {
+        delete pkt->senderState;
+        delete pkt->req;
+        delete pkt;
+
+        DPRINTF(RubyTest, "failed to initiate expose - cpu port not ready\n");
+    }
+}
+
 void
 Check::performCallback(NodeID proc, SubBlock* data, Cycles curTime)
 {
@@ -309,7 +372,8 @@ Check::performCallback(NodeID proc, SubBlock* data, Cycles curTime)
         }
         DPRINTF(RubyTest, "Action callback return data now %d\n",
                 data->getByte(0));
-    } else if (m_status == TesterStatus_Check_Pending) {
+    } else if (m_status == TesterStatus_Check_Pending ||
+               m_status == TesterStatus_Expose_Pending) {
         DPRINTF(RubyTest, "Check callback\n");
         // Perform load/check
         for (int byte_number=0; byte_number<CHECK_SIZE; byte_number++) {
@@ -325,6 +389,18 @@ Check::performCallback(NodeID proc, SubBlock* data, Cycles curTime)
         DPRINTF(RubyTest, "Action/check success\n");
         debugPrint();
 
+        if (m_status == TesterStatus_Check_Pending && m_spec_idx >= 0) {
+            // The spec load saw the right value, now the expose must too
+            m_status = TesterStatus_Expose_Ready;
+            DPRINTF(RubyTest, "Check %s, State=Expose_Ready\n", m_address);
+            return;
+        }
+        if (m_spec_idx >= 0) {
+            m_tester_ptr->freeSpecIdx(m_spec_port, m_spec_idx);
+            m_spec_idx = -1;
+            m_spec_port = -1;
+        }
+
         // successful check complete, increment complete
         m_tester_ptr->incrementCheckCompletions();
 
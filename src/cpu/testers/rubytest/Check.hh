@@ -60,6 +60,7 @@ class Check
     void initiatePrefetch();
     void initiateAction();
     void initiateCheck();
+    void initiateExpose();
 
     void pickValue();
     void pickInitiatingNode();
@@ -76,6 +77,10 @@ class Check
     int m_num_writers;
     int m_num_readers;
     RubyTester* m_tester_ptr;
+    //! Spec buffer entry and read port of a spec load check, -1 for a
+    //! normal check
+    int m_spec_idx;
+    int m_spec_port;
 };
 
 inline std::ostream&
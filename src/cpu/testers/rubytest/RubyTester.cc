@@ -62,6 +62,8 @@ RubyTester::RubyTester(const Params *p)
     m_num_readers(0),
     m_wakeup_frequency(p->wakeup_frequency),
     m_check_flush(p->check_flush),
+    m_spec_checks(p->spec_checks),
+    m_spec_buffer_size(p->spec_buffer_size),
     m_num_inst_only_ports(p->port_cpuInstPort_connection_count),
     m_num_inst_data_ports(p->port_cpuInstDataPort_connection_count)
 {
@@ -125,6 +127,9 @@ RubyTester::init()
     m_num_readers = readPorts.size();
     assert(m_num_readers == m_num_cpus);
 
+    m_spec_idx_used.assign(m_num_readers,
+        std::vector<bool>(m_spec_buffer_size, false));
+
     m_checkTable_ptr = new CheckTable(m_num_writers, m_num_readers, this);
 }
 
@@ -212,6 +217,26 @@ RubyTester::getReadableCpuPort(int idx)
     return readPorts[idx];
 }
 
+int
+RubyTester::allocSpecIdx(int port)
+{
+    std::vector<bool> &used = m_spec_idx_used[port];
+    for (int idx = 0; idx < used.size(); idx++) {
+        if (!used[idx]) {
+            used[idx] = true;
+            return idx;
+        }
+    }
+    return -1;
+}
+
+void
+RubyTester::freeSpecIdx(int port, int idx)
+{
+    assert(m_spec_idx_used[port][idx]);
+    m_spec_idx_used[port][idx] = false;
+}
+
 MasterPort*
 RubyTester::getWritableCpuPort(int idx)
 {
@@ -115,6 +115,12 @@ class RubyTester : public MemObject
 
     void print(std::ostream& out) const;
     bool getCheckFlush() { return m_check_flush; }
+    bool getSpecChecks() { return m_spec_checks; }
+
+    //! Spec buffer entry of the sequencer behind a read port for a spec
+    //! check, -1 if they are all in use
+    int allocSpecIdx(int port);
+    void freeSpecIdx(int port, int idx);
 
     MasterID masterId() { return _masterId; }
   protected:
@@ -144,6 +150,10 @@ class RubyTester : public MemObject
     int m_num_readers;
     int m_wakeup_frequency;
     bool m_check_flush;
+    bool m_spec_checks;
+    const int m_spec_buffer_size;
+    //! Spec buffer entries in use, per read port
+    std::vector<std::vector<bool> > m_spec_idx_used;
     int m_num_inst_only_ports;
     int m_num_inst_data_ports;
 };
@@ -41,4 +41,8 @@ class RubyTester(MemObject):
     deadlock_threshold = Param.Int(50000, "how often to check for deadlock")
     wakeup_frequency = Param.Int(10, "number of cycles between wakeups")
     check_flush = Param.Bool(False, "check cache flushing")
+    spec_checks = Param.Bool(False, "issue some of the checks as a "
+        "speculative load followed by an expose")
+    spec_buffer_size = Param.Unsigned(32, "spec buffer entries of each "
+        "sequencer used by the spec checks")
     system = Param.System(Parent.any, "System we belong to")
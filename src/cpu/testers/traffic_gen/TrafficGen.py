@@ -83,3 +83,18 @@ class TrafficGen(MemObject):
     # somewhat arbitrary and may well have to be tuned.
     progress_check = Param.Latency('1ms', "Time before exiting " \
                                    "due to lack of progress")
+
+    # Protobuf traces are decoded by a separate thread, in batches of
+    # packets. A trace state may also play a region of its trace only,
+    # optionally in a loop:
+    # STATE <id> <duration> TRACE <file> <addr offset>
+    #     [<first record> <number of records, 0 for all> <loop 0/1>]
+    # An STT state models the requests of a core running with STT and
+    # InvisiSpec, see stt_gen.hh. It takes the fields of a RANDOM state
+    # followed by <tainted load %> <untaint burst size> <spec load %>
+    # <exposed spec load %> <dummy load per store %> <spec entries>.
+
+    trace_batch_size = Param.Unsigned(4096, "Number of trace packets " \
+                                      "decoded at once by the trace " \
+                                      "prefetch thread, 0 to decode them " \
+                                      "on the simulation thread")
@@ -82,6 +82,17 @@ class BaseGen
 
   public:
 
+    /**
+     * Sender state of the packets a generator needs the response of,
+     * see recvResponse().
+     */
+    struct SenderState : public Packet::SenderState
+    {
+        BaseGen *gen;
+
+        SenderState(BaseGen *_gen) : gen(_gen) { }
+    };
+
     /** Time to spend in this state */
     const Tick duration;
 
@@ -131,6 +142,24 @@ class BaseGen
      */
     virtual Tick nextPacketTick(bool elastic, Tick delay) const = 0;
 
+    /**
+     * Receive the response to a packet that carried the sender state
+     * of this generator, even if it is no longer the active state. By
+     * default do nothing.
+     *
+     * @param pkt The response, deleted by the caller
+     */
+    virtual void recvResponse(PacketPtr pkt) { };
+
+    /**
+     * Take back a packet that carried the sender state of this
+     * generator but was dropped before being sent, e.g., as it is not
+     * destined for a memory. By default do nothing.
+     *
+     * @param pkt The dropped packet, deleted by the caller
+     */
+    virtual void dropPacket(PacketPtr pkt) { };
+
 };
 
 #endif
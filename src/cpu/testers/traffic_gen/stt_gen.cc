@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2018 The University of Illinois at Urbana-Champaign
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cpu/testers/traffic_gen/stt_gen.hh"
+
+#include <algorithm>
+
+#include "base/random.hh"
+#include "base/trace.hh"
+#include "debug/TrafficGen.hh"
+
+void
+SttGen::enter()
+{
+    RandomGen::enter();
+
+    // accesses not sent yet are dropped, freeing the entries of the
+    // spec loads and exposes among them, the responses of the spec
+    // loads in flight still free their entries
+    delayed.clear();
+    for (const auto &access : ready) {
+        if (access.specIdx >= 0)
+            freeSpecIdx(access.specIdx);
+    }
+    ready.clear();
+}
+
+bool
+SttGen::draw(uint8_t percent) const
+{
+    return percent != 0 &&
+        (percent >= 100 || random_mt.random(0, 99) < percent);
+}
+
+int
+SttGen::allocSpecIdx()
+{
+    auto it = std::find(specIdxUsed.begin(), specIdxUsed.end(), false);
+    if (it == specIdxUsed.end())
+        return -1;
+    *it = true;
+    return it - specIdxUsed.begin();
+}
+
+void
+SttGen::freeSpecIdx(int idx)
+{
+    assert(idx >= 0 && idx < specIdxUsed.size() && specIdxUsed[idx]);
+    specIdxUsed[idx] = false;
+}
+
+void
+SttGen::generateAccess()
+{
+    // address of the request, aligned to the block size
+    Addr addr = random_mt.random(startAddr, endAddr - 1);
+    addr -= addr % blocksize;
+
+    // add the amount of data manipulated to the total
+    dataManipulated += blocksize;
+
+    if (!draw(readPercent)) {
+        ready.push_back({ addr, MemCmd::WriteReq, -1 });
+        // a younger load got its data from this store while the store
+        // address was tainted, the load still goes to memory to hide
+        // the address of the store
+        if (draw(dummyPercent))
+            ready.push_back({ addr, MemCmd::ReadReq, -1 });
+        return;
+    }
+
+    if (draw(taintPercent)) {
+        // the taint of the loads clears all at once, e.g., when the
+        // older branch they depend on resolves
+        delayed.push_back({ addr, MemCmd::ReadReq, -1 });
+        if (delayed.size() >= burstSize) {
+            DPRINTF(TrafficGen, "SttGen: releasing %d tainted loads\n",
+                    delayed.size());
+            ready.insert(ready.end(), delayed.begin(), delayed.end());
+            delayed.clear();
+        }
+        return;
+    }
+
+    // spec loads need a spec buffer entry, they are sent as normal
+    // loads if there is none left
+    int spec_idx = draw(specPercent) ? allocSpecIdx() : -1;
+    ready.push_back({ addr, spec_idx < 0 ? MemCmd::ReadReq :
+                      MemCmd::ReadSpecReq, spec_idx });
+}
+
+PacketPtr
+SttGen::getNextPacket()
+{
+    // exposes, dummy loads and released tainted loads go first
+    while (ready.empty())
+        generateAccess();
+
+    Access access = ready.front();
+    ready.pop_front();
+
+    DPRINTF(TrafficGen, "SttGen::getNextPacket: %s to addr %x, size %d\n",
+            access.cmd.toString(), access.addr, blocksize);
+
+    PacketPtr pkt = getPacket(access.addr, blocksize, access.cmd);
+    if (access.specIdx >= 0) {
+        pkt->reqIdx = access.specIdx;
+        pkt->setFirst();
+        // the entry is freed, or the load exposed, on the response
+        pkt->pushSenderState(new SenderState(this));
+    }
+    return pkt;
+}
+
+Tick
+SttGen::nextPacketTick(bool elastic, Tick delay) const
+{
+    if (!ready.empty())
+        return curTick();
+
+    return RandomGen::nextPacketTick(elastic, delay);
+}
+
+void
+SttGen::recvResponse(PacketPtr pkt)
+{
+    if (pkt->isSpec() && draw(exposePercent)) {
+        // the load reached the visibility point, expose it with the
+        // same entry, address and size
+        ready.push_back({ pkt->getAddr(), MemCmd::ExposeReq, pkt->reqIdx });
+    } else {
+        // the load was squashed, or the expose is done
+        freeSpecIdx(pkt->reqIdx);
+    }
+}
+
+void
+SttGen::dropPacket(PacketPtr pkt)
+{
+    // the spec load or expose never reaches the spec buffer
+    freeSpecIdx(pkt->reqIdx);
+}
@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2018 The University of Illinois at Urbana-Champaign
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Declaration of the generator of the memory traffic of a core that
+ * runs with STT and InvisiSpec.
+ */
+
+#ifndef __CPU_TRAFFIC_GEN_STT_GEN_HH__
+#define __CPU_TRAFFIC_GEN_STT_GEN_HH__
+
+#include <deque>
+#include <vector>
+
+#include "base/bitfield.hh"
+#include "base/intmath.hh"
+#include "mem/packet.hh"
+#include "random_gen.hh"
+
+/**
+ * The STT generator picks random addresses like the random generator,
+ * and shapes the requests like a core that runs with STT and
+ * InvisiSpec:
+ * - tainted loads are delayed until their taint clears, and released
+ *   in bursts of back to back loads;
+ * - a store that forwards to a younger load while its address is
+ *   tainted is followed by a dummy load to the same address;
+ * - untainted loads may be issued as invisible spec loads, some of
+ *   which are exposed once their response comes back, the others
+ *   being squashed.
+ *
+ * Spec loads and exposes use the spec buffer of a Ruby sequencer,
+ * they need spec_entries to be at most its spec_buffer_size.
+ */
+class SttGen : public RandomGen
+{
+
+  public:
+
+    /**
+     * Create an STT traffic generator.
+     *
+     * @param _name Name to use for status and debug
+     * @param master_id MasterID set on each request
+     * @param _duration duration of this state before transitioning
+     * @param start_addr Start address
+     * @param end_addr End address
+     * @param _blocksize Size used for transactions injected
+     * @param min_period Lower limit of random inter-transaction time
+     * @param max_period Upper limit of random inter-transaction time
+     * @param read_percent Percent of transactions that are reads
+     * @param data_limit Upper limit on how much data to read/write
+     * @param taint_percent Percent of loads that are tainted
+     * @param burst_size Number of tainted loads released at once
+     * @param spec_percent Percent of untainted loads sent as spec loads
+     * @param expose_percent Percent of spec loads that are exposed
+     * @param dummy_percent Percent of stores followed by a dummy load
+     * @param spec_entries Number of spec buffer entries to use
+     */
+    SttGen(const std::string& _name, MasterID master_id, Tick _duration,
+           Addr start_addr, Addr end_addr, Addr _blocksize,
+           Tick min_period, Tick max_period,
+           uint8_t read_percent, Addr data_limit,
+           uint8_t taint_percent, unsigned int burst_size,
+           uint8_t spec_percent, uint8_t expose_percent,
+           uint8_t dummy_percent, unsigned int spec_entries)
+        : RandomGen(_name, master_id, _duration, start_addr, end_addr,
+          _blocksize, min_period, max_period, read_percent, data_limit),
+          taintPercent(taint_percent), burstSize(burst_size),
+          specPercent(spec_percent), exposePercent(expose_percent),
+          dummyPercent(dummy_percent), specIdxUsed(spec_entries, false)
+    { }
+
+    void enter();
+
+    PacketPtr getNextPacket();
+
+    Tick nextPacketTick(bool elastic, Tick delay) const;
+
+    void recvResponse(PacketPtr pkt);
+
+    void dropPacket(PacketPtr pkt);
+
+  protected:
+
+    /** A request to send */
+    struct Access {
+        Addr addr;
+        MemCmd cmd;
+        /** Spec buffer entry of spec loads and exposes, -1 if none */
+        int specIdx;
+    };
+
+    /** True with the given probability */
+    bool draw(uint8_t percent) const;
+
+    /** Generate the next access, or hold it if it is tainted */
+    void generateAccess();
+
+    int allocSpecIdx();
+
+    void freeSpecIdx(int idx);
+
+    /** Percent of loads that are tainted */
+    const uint8_t taintPercent;
+
+    /** Number of tainted loads released at once */
+    const unsigned int burstSize;
+
+    /** Percent of untainted loads sent as spec loads */
+    const uint8_t specPercent;
+
+    /** Percent of spec loads that are exposed */
+    const uint8_t exposePercent;
+
+    /** Percent of stores followed by a dummy load */
+    const uint8_t dummyPercent;
+
+    /** Tainted loads waiting for their taint to clear */
+    std::deque<Access> delayed;
+
+    /** Accesses to send back to back */
+    std::deque<Access> ready;
+
+    /** Spec buffer entries in use by a spec load or an expose */
+    std::vector<bool> specIdxUsed;
+};
+
+#endif
@@ -42,17 +42,91 @@
 
 #include "cpu/testers/traffic_gen/trace_gen.hh"
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include <algorithm>
+#include <cstring>
+#include <fstream>
 
 #include "base/random.hh"
 #include "base/trace.hh"
 #include "debug/TrafficGen.hh"
 #include "proto/packet.pb.h"
 
-TraceGen::InputStream::InputStream(const std::string& filename)
-    : trace(filename)
+static const char binaryTraceMagic[8] = { 'G', 'E', 'M', '5',
+                                          'P', 'K', 'T', 'B' };
+static const uint32_t binaryTraceVersion = 1;
+
+TraceGen::InputStream::InputStream(const std::string& filename,
+                                   const TraceRegion& _region,
+                                   unsigned batch_size)
+    : records(NULL), numRecords(0), mapping(NULL), mappingSize(0),
+      region(_region), nextRecord(0), regionPos(0), firstTick(0),
+      lastTick(0), tickShift(0), batchSize(batch_size), current(NULL),
+      readBatch(0), readPos(0), prefetcher(NULL), stopPrefetch(false)
 {
-    init();
+    // Binary traces are recognised by their magic number, anything
+    // else is left to the protobuf stream
+    char magic[sizeof(binaryTraceMagic)] = {};
+    std::ifstream file(filename.c_str(), std::ios::binary);
+    file.read(magic, sizeof(magic));
+    if (file && memcmp(magic, binaryTraceMagic, sizeof(magic)) == 0) {
+        file.close();
+        mapBinary(filename);
+    } else {
+        file.close();
+        trace.reset(new ProtoInputStream(filename));
+        init();
+    }
+
+    rewind();
+    startPrefetch();
+}
+
+TraceGen::InputStream::~InputStream()
+{
+    stopPrefetcher();
+    if (mapping)
+        munmap(mapping, mappingSize);
+}
+
+void
+TraceGen::InputStream::mapBinary(const std::string& filename)
+{
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+        fatal("Failed to open binary trace %s\n", filename);
+
+    struct stat st;
+    if (fstat(fd, &st) < 0 || st.st_size < (off_t)sizeof(BinaryTraceHeader))
+        fatal("Failed to read the header of binary trace %s\n", filename);
+
+    mappingSize = st.st_size;
+    mapping = mmap(NULL, mappingSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED)
+        fatal("Failed to map binary trace %s\n", filename);
+    madvise(mapping, mappingSize, MADV_SEQUENTIAL);
+
+    const BinaryTraceHeader *header =
+        static_cast<const BinaryTraceHeader *>(mapping);
+    if (header->version != binaryTraceVersion ||
+        header->recordSize != sizeof(BinaryTraceRecord)) {
+        panic("Binary trace %s has an unsupported version %d\n",
+              filename, header->version);
+    } else if (header->tickFreq != SimClock::Frequency) {
+        panic("Trace was recorded with a different tick frequency %d\n",
+              header->tickFreq);
+    } else if (mappingSize < sizeof(BinaryTraceHeader) +
+               header->numRecords * sizeof(BinaryTraceRecord)) {
+        panic("Binary trace %s is truncated\n", filename);
+    }
+
+    records = reinterpret_cast<const BinaryTraceRecord *>(header + 1);
+    numRecords = header->numRecords;
 }
 
 void
@@ -60,7 +134,7 @@ TraceGen::InputStream::init()
 {
     // Create a protobuf message for the header and read it from the stream
     ProtoMessage::PacketHeader header_msg;
-    if (!trace.read(header_msg)) {
+    if (!trace->read(header_msg)) {
         panic("Failed to read packet header from trace\n");
     } else if (header_msg.tick_freq() != SimClock::Frequency) {
         panic("Trace was recorded with a different tick frequency %d\n",
@@ -71,25 +145,192 @@ TraceGen::InputStream::init()
 void
 TraceGen::InputStream::reset()
 {
-    trace.reset();
-    init();
+    stopPrefetcher();
+
+    regionPos = 0;
+    tickShift = 0;
+    rewind();
+
+    startPrefetch();
 }
 
 bool
-TraceGen::InputStream::read(TraceElement& element)
+TraceGen::InputStream::readRecord(TraceElement& element)
 {
-    ProtoMessage::Packet pkt_msg;
-    if (trace.read(pkt_msg)) {
+    if (trace) {
+        ProtoMessage::Packet pkt_msg;
+        if (!trace->read(pkt_msg)) {
+            // We have reached the end of the file
+            return false;
+        }
         element.cmd = pkt_msg.cmd();
         element.addr = pkt_msg.addr();
         element.blocksize = pkt_msg.size();
         element.tick = pkt_msg.tick();
         element.flags = pkt_msg.has_flags() ? pkt_msg.flags() : 0;
+    } else {
+        if (nextRecord >= numRecords)
+            return false;
+        const BinaryTraceRecord &rec = records[nextRecord];
+        element.cmd = rec.cmd;
+        element.addr = rec.addr;
+        element.blocksize = rec.size;
+        element.tick = rec.tick;
+        element.flags = rec.flags;
+    }
+
+    ++nextRecord;
+    return true;
+}
+
+void
+TraceGen::InputStream::rewind()
+{
+    if (!trace) {
+        nextRecord = std::min(region.firstRecord, numRecords);
+        return;
+    }
+
+    // A protobuf stream can only be read from its start
+    if (nextRecord > region.firstRecord) {
+        trace->reset();
+        init();
+        nextRecord = 0;
+    }
+    TraceElement skipped;
+    while (nextRecord < region.firstRecord && readRecord(skipped))
+        ;
+}
+
+bool
+TraceGen::InputStream::readRegion(TraceElement& element)
+{
+    if ((region.numRecords == 0 || regionPos < region.numRecords) &&
+        readRecord(element)) {
+        if (regionPos == 0)
+            firstTick = element.tick;
+        lastTick = element.tick;
+        ++regionPos;
+
+        // A region that does not start the trace is played from the
+        // time the state is entered
+        if (region.firstRecord != 0)
+            element.tick -= firstTick;
+        element.tick += tickShift;
         return true;
     }
 
-    // We have reached the end of the file
-    return false;
+    if (!region.loop || regionPos == 0)
+        return false;
+
+    // Play the region again, one mean packet interval after its last
+    // packet
+    Tick span = lastTick - firstTick;
+    Tick gap = regionPos > 1 ? span / (regionPos - 1) : 0;
+    tickShift += span + std::max(gap, Tick(1));
+    regionPos = 0;
+    rewind();
+
+    return readRegion(element);
+}
+
+void
+TraceGen::InputStream::startPrefetch()
+{
+    if (!trace || batchSize == 0)
+        return;
+
+    for (auto& batch : batches) {
+        batch.elements.clear();
+        batch.last = false;
+        batch.full = false;
+    }
+    current = NULL;
+    readBatch = 0;
+    readPos = 0;
+    stopPrefetch = false;
+
+    prefetcher = new std::thread([this]{ prefetchLoop(); });
+}
+
+void
+TraceGen::InputStream::stopPrefetcher()
+{
+    if (!prefetcher)
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopPrefetch = true;
+    }
+    cond.notify_all();
+    prefetcher->join();
+    delete prefetcher;
+    prefetcher = NULL;
+}
+
+void
+TraceGen::InputStream::prefetchLoop()
+{
+    unsigned fill = 0;
+    bool last = false;
+    while (!last) {
+        Batch& batch = batches[fill];
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            cond.wait(lock, [&]{ return stopPrefetch || !batch.full; });
+            if (stopPrefetch)
+                return;
+        }
+
+        // The simulation thread does not touch the batch until it is
+        // marked full
+        batch.elements.resize(batchSize);
+        size_t n = 0;
+        while (n < batchSize && readRegion(batch.elements[n]))
+            ++n;
+        batch.elements.resize(n);
+        last = n < batchSize;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            batch.last = last;
+            batch.full = true;
+        }
+        cond.notify_all();
+        fill ^= 1;
+    }
+}
+
+bool
+TraceGen::InputStream::read(TraceElement& element)
+{
+    if (!prefetcher)
+        return readRegion(element);
+
+    while (!current || readPos == current->elements.size()) {
+        if (current) {
+            if (current->last)
+                return false;
+
+            // Hand the consumed batch back to the prefetch thread
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                current->full = false;
+            }
+            cond.notify_all();
+            readBatch ^= 1;
+        }
+
+        Batch& next = batches[readBatch];
+        std::unique_lock<std::mutex> lock(mutex);
+        cond.wait(lock, [&]{ return next.full; });
+        current = &next;
+        readPos = 0;
+    }
+
+    element = current->elements[readPos++];
+    return true;
 }
 
 Tick
@@ -170,7 +411,7 @@ TraceGen::exit()
     // Check if we reached the end of the trace file. If we did not
     // then we want to generate a warning stating that not the entire
     // trace was played.
-    if (!traceComplete) {
+    if (!traceComplete && !trace.looping()) {
         warn("Trace player %s was unable to replay the entire trace!\n",
              name());
     }
@@ -49,16 +49,53 @@
 #ifndef __CPU_TRAFFIC_GEN_TRACE_GEN_HH__
 #define __CPU_TRAFFIC_GEN_TRACE_GEN_HH__
 
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
 #include "base/bitfield.hh"
 #include "base/intmath.hh"
 #include "base_gen.hh"
 #include "mem/packet.hh"
 #include "proto/protoio.hh"
 
+/**
+ * Header of a binary packet trace, a file of fixed size records that
+ * is mapped in memory rather than parsed. Binary traces are converted
+ * from the protobuf packet traces by util/encode_binary_packet_trace.py,
+ * and recognised by their magic number. All the fields are little
+ * endian.
+ */
+struct BinaryTraceHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t recordSize;
+    uint64_t tickFreq;
+    uint64_t numRecords;
+};
+
+struct BinaryTraceRecord
+{
+    uint64_t tick;
+    uint64_t addr;
+    uint64_t flags;
+    uint32_t size;
+    uint32_t cmd;
+};
+
 /**
  * The trace replay generator reads a trace file and plays
  * back the transactions. The trace is offset with respect to
  * the time when the state was entered.
+ *
+ * Protobuf traces are decoded by a prefetch thread, in batches of
+ * packets that the generator consumes from the simulation thread.
+ * Binary traces are mapped in memory instead. The generator may also
+ * play a region of the trace only, and play it in a loop for the
+ * duration of the state.
  */
 class TraceGen : public BaseGen
 {
@@ -102,6 +139,21 @@ class TraceGen : public BaseGen
         }
     };
 
+    /**
+     * A region of the trace to play, and whether to loop over it.
+     */
+    struct TraceRegion {
+
+        /** Index of the first record to play */
+        uint64_t firstRecord;
+
+        /** Number of records to play, 0 to play until the end */
+        uint64_t numRecords;
+
+        /** Play the region again when its end is reached */
+        bool loop;
+    };
+
     /**
      * The InputStream encapsulates a trace file and the
      * internal buffers and populates TraceElements based on
@@ -112,8 +164,87 @@ class TraceGen : public BaseGen
 
       private:
 
-        /// Input file stream for the protobuf trace
-        ProtoInputStream trace;
+        /// Input file stream for the protobuf trace, NULL for a
+        /// binary trace
+        std::unique_ptr<ProtoInputStream> trace;
+
+        /// Records of a binary trace mapped in memory
+        const BinaryTraceRecord *records;
+        uint64_t numRecords;
+        void *mapping;
+        size_t mappingSize;
+
+        const TraceRegion region;
+
+        /// Index of the next record in the file
+        uint64_t nextRecord;
+
+        /// Position in the region, and tick shift of the current
+        /// iteration over it
+        uint64_t regionPos;
+        Tick firstTick;
+        Tick lastTick;
+        Tick tickShift;
+
+        /// Number of elements decoded at once by the prefetch
+        /// thread, 0 if there is no prefetch thread
+        const unsigned batchSize;
+
+        /**
+         * A batch of decoded elements. The prefetch thread fills the
+         * two batches in turn while the simulation thread consumes the
+         * other one.
+         */
+        struct Batch {
+            std::vector<TraceElement> elements;
+            /// The end of the trace follows the elements
+            bool last;
+            /// Elements are ready to be consumed
+            bool full;
+        };
+
+        Batch batches[2];
+        /// Batch being consumed, NULL until the first one is full
+        Batch *current;
+        unsigned readBatch;
+        size_t readPos;
+
+        std::thread *prefetcher;
+        std::mutex mutex;
+        std::condition_variable cond;
+        bool stopPrefetch;
+
+        /**
+         * Check the trace header to make sure that it is of the right
+         * format.
+         */
+        void init();
+
+        /** Map a binary trace in memory. */
+        void mapBinary(const std::string& filename);
+
+        /**
+         * Read the next record of the file, without any region.
+         *
+         * @return False at the end of the file
+         */
+        bool readRecord(TraceElement& element);
+
+        /** Move to the first record of the region. */
+        void rewind();
+
+        /**
+         * Read the next element of the region, looping over it if
+         * asked to. The ticks of the elements are shifted by the
+         * duration of the previous iterations.
+         *
+         * @return False at the end of the region
+         */
+        bool readRegion(TraceElement& element);
+
+        void startPrefetch();
+        void stopPrefetcher();
+        void prefetchLoop();
 
       public:
 
@@ -121,8 +252,15 @@ class TraceGen : public BaseGen
          * Create a trace input stream for a given file name.
          *
          * @param filename Path to the file to read from
+         * @param region Region of the trace to play
+         * @param batch_size Number of protobuf packets decoded at
+         *                   once by the prefetch thread, 0 to decode
+         *                   them on the simulation thread
          */
-        InputStream(const std::string& filename);
+        InputStream(const std::string& filename, const TraceRegion& region,
+                    unsigned batch_size);
+
+        ~InputStream();
 
         /**
          * Reset the stream such that it can be played once
@@ -130,11 +268,8 @@ class TraceGen : public BaseGen
          */
         void reset();
 
-        /**
-         * Check the trace header to make sure that it is of the right
-         * format.
-         */
-        void init();
+        /** True if the stream never ends. */
+        bool looping() const { return region.loop; }
 
         /**
          * Attempt to read a trace element from the stream,
@@ -157,11 +292,18 @@ class TraceGen : public BaseGen
      * @param _duration duration of this state before transitioning
      * @param trace_file File to read the transactions from
      * @param addr_offset Positive offset to add to trace address
+     * @param first_record Index of the first record to play
+     * @param num_records Number of records to play, 0 for all
+     * @param loop Play the records in a loop until the state exits
+     * @param batch_size Number of packets decoded at once by the
+     *                   prefetch thread, 0 for no prefetch thread
      */
     TraceGen(const std::string& _name, MasterID master_id, Tick _duration,
-             const std::string& trace_file, Addr addr_offset)
+             const std::string& trace_file, Addr addr_offset,
+             uint64_t first_record = 0, uint64_t num_records = 0,
+             bool loop = false, unsigned batch_size = 0)
         : BaseGen(_name, master_id, _duration),
-          trace(trace_file),
+          trace(trace_file, { first_record, num_records, loop }, batch_size),
           tickOffset(0),
           addrOffset(addr_offset),
           traceComplete(false)
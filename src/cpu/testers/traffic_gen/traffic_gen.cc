@@ -45,6 +45,7 @@
 
 #include <sstream>
 
+#include "base/cast.hh"
 #include "base/intmath.hh"
 #include "base/random.hh"
 #include "debug/Checkpoint.hh"
@@ -61,6 +62,7 @@ TrafficGen::TrafficGen(const TrafficGenParams* p)
       configFile(p->config_file),
       elasticReq(p->elastic_req),
       progressCheck(p->progress_check),
+      traceBatchSize(p->trace_batch_size),
       noProgressEvent([this]{ noProgress(); }, name()),
       nextTransitionTick(0),
       nextPacketTick(0),
@@ -213,6 +215,13 @@ TrafficGen::update()
                 warn("%s suppressed %d packets with non-memory addresses\n",
                      name(), numSuppressed);
 
+            // let the generator release what it holds for the packet
+            if (pkt->senderState) {
+                BaseGen::SenderState *state =
+                    safe_cast<BaseGen::SenderState *>(pkt->popSenderState());
+                state->gen->dropPacket(pkt);
+                delete state;
+            }
             delete pkt->req;
             delete pkt;
             pkt = nullptr;
@@ -295,12 +304,20 @@ TrafficGen::parseConfig()
                 if (mode == "TRACE") {
                     string traceFile;
                     Addr addrOffset;
+                    // optional region of the trace, played once or in
+                    // a loop
+                    uint64_t first_record = 0;
+                    uint64_t num_records = 0;
+                    unsigned loop = 0;
 
                     is >> traceFile >> addrOffset;
+                    is >> first_record >> num_records >> loop;
                     traceFile = resolveFile(traceFile);
 
                     states[id] = new TraceGen(name(), masterID, duration,
-                                              traceFile, addrOffset);
+                                              traceFile, addrOffset,
+                                              first_record, num_records,
+                                              loop != 0, traceBatchSize);
                     DPRINTF(TrafficGen, "State: %d TraceGen\n", id);
                 } else if (mode == "IDLE") {
                     states[id] = new IdleGen(name(), masterID, duration);
@@ -309,7 +326,8 @@ TrafficGen::parseConfig()
                     states[id] = new ExitGen(name(), masterID, duration);
                     DPRINTF(TrafficGen, "State: %d ExitGen\n", id);
                 } else if (mode == "LINEAR" || mode == "RANDOM" ||
-                           mode == "DRAM"   || mode == "DRAM_ROTATE") {
+                           mode == "DRAM"   || mode == "DRAM_ROTATE" ||
+                           mode == "STT") {
                     uint32_t read_percent;
                     Addr start_addr;
                     Addr end_addr;
@@ -352,6 +370,39 @@ TrafficGen::parseConfig()
                                                    min_period, max_period,
                                                    read_percent, data_limit);
                         DPRINTF(TrafficGen, "State: %d RandomGen\n", id);
+                    } else if (mode == "STT") {
+                        uint32_t taint_percent;
+                        unsigned int burst_size;
+                        uint32_t spec_percent;
+                        uint32_t expose_percent;
+                        uint32_t dummy_percent;
+                        unsigned int spec_entries;
+
+                        is >> taint_percent >> burst_size >> spec_percent >>
+                            expose_percent >> dummy_percent >> spec_entries;
+
+                        if (taint_percent > 100 || spec_percent > 100 ||
+                            expose_percent > 100 || dummy_percent > 100)
+                            fatal("%s STT percentages cannot exceed 100%%",
+                                  name());
+
+                        if (burst_size == 0)
+                            fatal("%s STT burst size must be at least 1",
+                                  name());
+
+                        if (spec_percent && !spec_entries)
+                            fatal("%s STT spec loads need spec entries",
+                                  name());
+
+                        states[id] = new SttGen(name(), masterID,
+                                                duration, start_addr,
+                                                end_addr, blocksize,
+                                                min_period, max_period,
+                                                read_percent, data_limit,
+                                                taint_percent, burst_size,
+                                                spec_percent, expose_percent,
+                                                dummy_percent, spec_entries);
+                        DPRINTF(TrafficGen, "State: %d SttGen\n", id);
                     } else if (mode == "DRAM" || mode == "DRAM_ROTATE") {
                         // stride size (bytes) of the request for achieving
                         // required hit length
@@ -575,6 +626,14 @@ TrafficGen::regStats()
 bool
 TrafficGen::TrafficGenPort::recvTimingResp(PacketPtr pkt)
 {
+    // hand the response to the generator that asked for it
+    if (pkt->senderState) {
+        BaseGen::SenderState *state =
+            safe_cast<BaseGen::SenderState *>(pkt->popSenderState());
+        state->gen->recvResponse(pkt);
+        delete state;
+    }
+
     delete pkt->req;
     delete pkt;
 
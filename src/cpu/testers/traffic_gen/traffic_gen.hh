@@ -52,6 +52,7 @@
 #include "cpu/testers/traffic_gen/idle_gen.hh"
 #include "cpu/testers/traffic_gen/linear_gen.hh"
 #include "cpu/testers/traffic_gen/random_gen.hh"
+#include "cpu/testers/traffic_gen/stt_gen.hh"
 #include "cpu/testers/traffic_gen/trace_gen.hh"
 #include "mem/mem_object.hh"
 #include "mem/qport.hh"
@@ -157,6 +158,12 @@ class TrafficGen : public MemObject
      */
     const Tick progressCheck;
 
+    /**
+     * Number of packets decoded at once by the prefetch thread of the
+     * trace states.
+     */
+    const unsigned traceBatchSize;
+
     /**
      * Event to keep track of our progress, or lack thereof.
      */
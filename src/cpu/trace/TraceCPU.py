@@ -76,6 +76,14 @@ class TraceCPU(BaseCPU):
     freqMultiplier = Param.Float(1.0, "Multiplier scale the Trace CPU "\
                                  "frequency up or down")
 
+    # Replay with STT: loads and stores whose address is tainted by an access
+    # root wait until the root reaches its visibility point, i.e. all the
+    # older control nodes (Spectre) or nodes (Futuristic) are complete. The
+    # data trace must have been captured with ElasticTrace.traceTaint set.
+    STT = Param.Bool(False, "Apply STT protection mechanism during replay")
+    threatModel = Param.String('Spectre', "Threat model defining the "\
+                               "visibility point of loads with STT")
+
     # Enable exiting when any one Trace CPU completes execution which is set to
     # false by default
     enableEarlyExit = Param.Bool(False, "Exit when any one Trace CPU "\
@@ -304,6 +304,16 @@ TraceCPU::ElasticDataGen::regStats()
     .desc("Number of strictly ordered stores")
     ;
 
+    numTaintStalls
+    .name(name() + ".numTaintStalls")
+    .desc("Number of loads/stores held back by an unsafe access root (STT)")
+    ;
+
+    taintStallTicks
+    .name(name() + ".taintStallTicks")
+    .desc("Total ticks loads/stores were held back by their taint (STT)")
+    ;
+
     dataLastTick
     .name(name() + ".dataLastTick")
     .desc("Last tick simulated from the elastic data trace")
@@ -393,6 +403,9 @@ TraceCPU::ElasticDataGen::readNextWindow()
         num_read++;
         // Add to map
         depGraph[new_node->seqNum] = new_node;
+        if (stt && (futuristic || new_node->isControl)) {
+            pendingVisPoints.insert(new_node->seqNum);
+        }
         if (new_node->numRobDep == 0 && new_node->numRegDep == 0) {
             // Source dependencies are already complete, check if resources
             // are available and issue. The execution time is approximated
@@ -568,6 +581,7 @@ TraceCPU::ElasticDataGen::execute()
         if (!node_ptr->isLoad() || node_ptr->isStrictlyOrdered()) {
             // Release all resources occupied by the completed node
             hwResource.release(node_ptr);
+            completeVisPoint(node_ptr);
             // clear the dynamically allocated set of dependents
             (node_ptr->dependents).clear();
             // Update the stat for numOps simulated
@@ -708,6 +722,18 @@ TraceCPU::ElasticDataGen::checkAndIssue(const GraphNode* node_ptr, bool first)
     // Assert the node is dependency-free
     assert(node_ptr->numRobDep == 0 && node_ptr->numRegDep == 0);
 
+    // With STT, a load or store tainted by an unsafe access root waits for
+    // the root to be safe before it takes any resources.
+    if (first && stt && node_ptr->taintRoot != 0 &&
+        !isRootSafe(node_ptr->taintRoot)) {
+        DPRINTFR(TraceCPUData, "\t\tseq. num %lli(%s) is tainted by unsafe "
+            "access root %lli. Holding it back.\n", node_ptr->seqNum,
+            node_ptr->typeToStr(), node_ptr->taintRoot);
+        taintStalled[node_ptr->taintRoot].push_back({node_ptr, curTick()});
+        ++numTaintStalls;
+        return false;
+    }
+
     // If this is the first attempt, print a debug message to indicate this.
     if (first) {
         DPRINTFR(TraceCPUData, "\t\tseq. num %lli(%s) with rob num %lli is now"
@@ -742,6 +768,26 @@ TraceCPU::ElasticDataGen::checkAndIssue(const GraphNode* node_ptr, bool first)
     }
 }
 
+void
+TraceCPU::ElasticDataGen::completeVisPoint(const GraphNode* node_ptr)
+{
+    if (!stt || pendingVisPoints.erase(node_ptr->seqNum) == 0)
+        return;
+
+    while (!taintStalled.empty() && isRootSafe(taintStalled.begin()->first)) {
+        std::vector<TaintStalledNode> stalled =
+            std::move(taintStalled.begin()->second);
+        DPRINTFR(TraceCPUData, "\tAccess root %lli is safe, issuing the %d "
+            "nodes held back by it.\n", taintStalled.begin()->first,
+            stalled.size());
+        taintStalled.erase(taintStalled.begin());
+        for (const auto& stalled_node : stalled) {
+            taintStallTicks += curTick() - stalled_node.stallTick;
+            checkAndIssue(stalled_node.node);
+        }
+    }
+}
+
 void
 TraceCPU::ElasticDataGen::completeMemAccess(PacketPtr pkt)
 {
@@ -762,6 +808,7 @@ TraceCPU::ElasticDataGen::completeMemAccess(PacketPtr pkt)
 
         // Release resources occupied by the load
         hwResource.release(node_ptr);
+        completeVisPoint(node_ptr);
 
         DPRINTF(TraceCPUData, "Load seq. num %lli response received. Waking up"
                 " dependents..\n", node_ptr->seqNum);
@@ -1269,7 +1316,8 @@ TraceCPU::ElasticDataGen::InputStream::InputStream(
     const double time_multiplier)
     : trace(filename),
       timeMultiplier(time_multiplier),
-      microOpCount(0)
+      microOpCount(0),
+      taint(false)
 {
     // Create a protobuf message for the header and read it from the stream
     ProtoMessage::InstDepRecordHeader header_msg;
@@ -1284,6 +1332,7 @@ TraceCPU::ElasticDataGen::InputStream::InputStream(
         // Assign window size equal to the field in the trace that was recorded
         // when the data dependency trace was captured in the o3cpu model
         windowSize = header_msg.window_size();
+        taint = header_msg.taint();
     }
 }
 
@@ -1329,7 +1378,16 @@ TraceCPU::ElasticDataGen::InputStream::read(GraphNode* element)
             }
         }
 
+        // Repeated field, only the youngest access root is kept
+        element->taintRoot = 0;
+        for (int i = 0; i < (pkt_msg.taint_dep()).size(); i++) {
+            element->taintRoot = std::max<NodeSeqNum>(element->taintRoot,
+                                                      pkt_msg.taint_dep(i));
+        }
+
         // Optional fields
+        element->isControl = pkt_msg.control();
+
         if (pkt_msg.has_p_addr())
             element->physAddr = pkt_msg.p_addr();
         else
@@ -1463,6 +1521,9 @@ TraceCPU::ElasticDataGen::GraphNode::writeElementAsTrace() const
         DPRINTFR(TraceCPUData, ",%lli", regDep[i]);
         i++;
     }
+    if (taintRoot != 0) {
+        DPRINTFR(TraceCPUData, "taintRoot:,%lli", taintRoot);
+    }
     auto child_itr = dependents.begin();
     DPRINTFR(TraceCPUData, "dependents:");
     while (child_itr != dependents.end()) {
@@ -44,6 +44,7 @@
 
 #include <array>
 #include <cstdint>
+#include <map>
 #include <queue>
 #include <set>
 #include <unordered_map>
@@ -636,6 +637,16 @@ class TraceCPU : public BaseCPU
             /** Number of register dependencies */
             uint8_t numRegDep;
 
+            /**
+             * The youngest access root tainting the address of a load or
+             * store, zero if none. Roots become safe in program order, so
+             * that the node is safe as soon as this one is.
+             */
+            NodeSeqNum taintRoot;
+
+            /** Is the node a control instruction, i.e. a visibility point */
+            bool isControl;
+
             /**
              * A vector of nodes dependent (outgoing) on this node. A
              * sequential container is chosen because when dependents become
@@ -681,6 +692,16 @@ class TraceCPU : public BaseCPU
             std::string typeToStr() const;
         };
 
+        /**
+         * Struct to store a node held back by its taint and the tick when it
+         * became dependency free.
+         */
+        struct TaintStalledNode
+        {
+            const GraphNode* node;
+            Tick stallTick;
+        };
+
         /** Struct to store a ready-to-execute node and its execution tick. */
         struct ReadyNode
         {
@@ -816,6 +837,9 @@ class TraceCPU : public BaseCPU
              * trace and used to process the dependency trace
              */
             uint32_t windowSize;
+
+            /** If the trace carries taint information, see ElasticTrace */
+            bool taint;
           public:
 
             /**
@@ -847,6 +871,9 @@ class TraceCPU : public BaseCPU
             /** Get window size from trace */
             uint32_t getWindowSize() const { return windowSize; }
 
+            /** Get if the trace carries taint information */
+            bool hasTaint() const { return taint; }
+
             /** Get number of micro-ops modelled in the TraceCPU replay */
             uint64_t getMicroOpCount() const { return microOpCount; }
         };
@@ -867,10 +894,17 @@ class TraceCPU : public BaseCPU
               execComplete(false),
               windowSize(trace.getWindowSize()),
               hwResource(params->sizeROB, params->sizeStoreBuffer,
-                         params->sizeLoadBuffer)
+                         params->sizeLoadBuffer),
+              stt(params->STT),
+              futuristic(params->threatModel == "Futuristic")
         {
             DPRINTF(TraceCPUData, "Window size in the trace is %d.\n",
                     windowSize);
+            fatal_if(stt && !futuristic && params->threatModel != "Spectre",
+                     "%s: STT replay needs the Spectre or Futuristic threat "
+                     "model, not %s\n", genName, params->threatModel);
+            fatal_if(stt && !trace.hasTaint(), "%s: STT replay needs a "
+                     "trace captured with taint tracing\n", genName);
         }
 
         /**
@@ -983,6 +1017,27 @@ class TraceCPU : public BaseCPU
         /** Get number of micro-ops modelled in the TraceCPU replay */
         uint64_t getMicroOpCount() const { return trace.getMicroOpCount(); }
 
+        /**
+         * With STT, an access root is safe once all the visibility points
+         * older than it are complete.
+         *
+         * @param root seq. num of the access root
+         * @return true if the root is safe
+         */
+        bool isRootSafe(NodeSeqNum root) const
+        {
+            return pendingVisPoints.empty() || *pendingVisPoints.begin() > root;
+        }
+
+        /**
+         * Mark a completed node as a reached visibility point, if it is one,
+         * and attempt to issue the nodes held back by the access roots that
+         * became safe as a result.
+         *
+         * @param node_ptr pointer to the completed node
+         */
+        void completeVisPoint(const GraphNode* node_ptr);
+
         void regStats();
 
       private:
@@ -1046,6 +1101,28 @@ class TraceCPU : public BaseCPU
         /** List of nodes that are ready to execute */
         std::list<ReadyNode> readyList;
 
+        /**
+         * Replay with STT: a load or store whose address is tainted by an
+         * access root that is not safe yet is not issued until it is.
+         */
+        const bool stt;
+
+        /**
+         * Under the Futuristic threat model every node is a visibility point,
+         * under the Spectre one only the control nodes are.
+         */
+        const bool futuristic;
+
+        /** Visibility points that are not complete, in program order */
+        std::set<NodeSeqNum> pendingVisPoints;
+
+        /**
+         * Dependency-free nodes held back by their taint, by the access root
+         * they wait for. The map is ordered so that the roots becoming safe
+         * are at its beginning.
+         */
+        std::map<NodeSeqNum, std::vector<TaintStalledNode>> taintStalled;
+
         /** Stats for data memory accesses replayed. */
         Stats::Scalar maxDependents;
         Stats::Scalar maxReadyListSize;
@@ -1056,6 +1133,8 @@ class TraceCPU : public BaseCPU
         Stats::Scalar numSplitReqs;
         Stats::Scalar numSOLoads;
         Stats::Scalar numSOStores;
+        Stats::Scalar numTaintStalls;
+        Stats::Scalar taintStallTicks;
         /** Tick when ElasticDataGen completes execution */
         Stats::Scalar dataLastTick;
     };
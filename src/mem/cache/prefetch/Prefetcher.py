@@ -80,10 +80,16 @@ class StridePrefetcher(QueuedPrefetcher):
 
     table_sets = Param.Int(16, "Number of sets in PC lookup table")
     table_assoc = Param.Int(4, "Associativity of PC lookup table")
+    table_contexts = Param.Int(16, "Number of PC lookup tables the master "
+        "ids are hashed into")
     use_master_id = Param.Bool(True, "Use master id based history")
 
     degree = Param.Int(4, "Number of prefetches to generate")
 
+    # [STT] Loads that are not safe yet (Request::SPEC) neither train the
+    # prefetcher nor trigger prefetches, see the pfTaint* stats.
+    taint_safe_training = Param.Bool(False, "Only train on safe loads")
+
 class TaggedPrefetcher(QueuedPrefetcher):
     type = 'TaggedPrefetcher'
     cxx_class = 'TaggedPrefetcher'
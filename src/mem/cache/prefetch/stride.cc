@@ -48,6 +48,7 @@
 
 #include "mem/cache/prefetch/stride.hh"
 
+#include "base/logging.hh"
 #include "base/random.hh"
 #include "base/trace.hh"
 #include "debug/HWPrefetch.hh"
@@ -60,42 +61,73 @@ StridePrefetcher::StridePrefetcher(const StridePrefetcherParams *p)
       startConf(p->start_conf),
       pcTableAssoc(p->table_assoc),
       pcTableSets(p->table_sets),
+      pcTableContexts(p->table_contexts),
       useMasterId(p->use_master_id),
       degree(p->degree),
-      pcTable(pcTableAssoc, pcTableSets, name())
+      taintSafe(p->taint_safe_training),
+      pcTable(pcTableAssoc, pcTableSets, pcTableContexts)
 {
     // Don't consult stride prefetcher on instruction accesses
     onInst = false;
 
     assert(isPowerOf2(pcTableSets));
+    fatal_if(pcTableContexts <= 0, "%s: the stride prefetcher needs at "
+             "least one table context\n", name());
 }
 
-StridePrefetcher::StrideEntry**
-StridePrefetcher::PCTable::allocateNewContext(int context)
+int
+StridePrefetcher::train(StrideEntry &entry, Addr pkt_addr) const
 {
-    auto res = entries.insert(std::make_pair(context,
-                              new StrideEntry*[pcTableSets]));
-    auto it = res.first;
-    chatty_assert(res.second, "Allocating an already created context\n");
-    assert(it->first == context);
-
-    DPRINTF(HWPrefetch, "Adding context %i with stride entries at %p\n",
-            context, it->second);
-
-    StrideEntry** entry = it->second;
-    for (int s = 0; s < pcTableSets; s++) {
-        entry[s] = new StrideEntry[pcTableAssoc];
+    int new_stride = pkt_addr - entry.lastAddr;
+    bool stride_match = (new_stride == entry.stride);
+
+    // Adjust confidence for stride entry
+    if (stride_match && new_stride != 0) {
+        if (entry.confidence < maxConf)
+            entry.confidence++;
+    } else {
+        if (entry.confidence > minConf)
+            entry.confidence--;
+        // If confidence has dropped below the threshold, train new stride
+        if (entry.confidence < threshConf)
+            entry.stride = new_stride;
     }
-    return entry;
+
+    DPRINTF(HWPrefetch, "Hit: PC %x pkt_addr %x (%s) stride %d (%s), "
+            "conf %d\n", entry.instAddr, pkt_addr,
+            entry.isSecure ? "s" : "ns", new_stride,
+            stride_match ? "match" : "change", entry.confidence);
+
+    entry.lastAddr = pkt_addr;
+    return new_stride;
 }
 
-StridePrefetcher::PCTable::~PCTable() {
-    for (auto entry : entries) {
-        for (int s = 0; s < pcTableSets; s++) {
-            delete[] entry.second[s];
+int
+StridePrefetcher::generate(const StrideEntry &entry, int new_stride,
+                           Addr pkt_addr,
+                           std::vector<AddrPriority> &addresses) const
+{
+    // Abort prefetch generation if below confidence threshold
+    if (entry.confidence < threshConf)
+        return 0;
+
+    // Generate up to degree prefetches
+    for (int d = 1; d <= degree; d++) {
+        // Round strides up to atleast 1 cacheline
+        int prefetch_stride = new_stride;
+        if (abs(new_stride) < blkSize) {
+            prefetch_stride = (new_stride < 0) ? -blkSize : blkSize;
+        }
+
+        Addr new_addr = pkt_addr + d * prefetch_stride;
+        if (samePage(pkt_addr, new_addr)) {
+            addresses.push_back(AddrPriority(new_addr, 0));
+        } else {
+            // Return the number of page crossing prefetches generated
+            return degree - d + 1;
         }
-        delete[] entry.second;
     }
+    return 0;
 }
 
 void
@@ -114,54 +146,36 @@ StridePrefetcher::calculatePrefetch(const PacketPtr &pkt,
     MasterID master_id = useMasterId ? pkt->req->masterId() : 0;
 
     // Lookup pc-based information
-    StrideEntry *entry;
-
-    if (pcTableHit(pc, is_secure, master_id, entry)) {
-        // Hit in table
-        int new_stride = pkt_addr - entry->lastAddr;
-        bool stride_match = (new_stride == entry->stride);
-
-        // Adjust confidence for stride entry
-        if (stride_match && new_stride != 0) {
-            if (entry->confidence < maxConf)
-                entry->confidence++;
-        } else {
-            if (entry->confidence > minConf)
-                entry->confidence--;
-            // If confidence has dropped below the threshold, train new stride
-            if (entry->confidence < threshConf)
-                entry->stride = new_stride;
+    StrideEntry *entry = pcTableHit(pc, is_secure, master_id);
+
+    if (taintSafe && pkt->req->isSpec()) {
+        // The access of a load that may still be squashed, count the
+        // prefetches it would have triggered on a copy of its entry
+        ++pfTaintedAccesses;
+        if (entry) {
+            StrideEntry shadow = *entry;
+            std::vector<AddrPriority> lost;
+            int new_stride = train(shadow, pkt_addr);
+            generate(shadow, new_stride, pkt_addr, lost);
+            pfTaintSuppressed += lost.size();
         }
+        DPRINTF(HWPrefetch, "Ignoring unsafe access: PC %x pkt_addr %x\n",
+                pc, pkt_addr);
+        return;
+    }
 
-        DPRINTF(HWPrefetch, "Hit: PC %x pkt_addr %x (%s) stride %d (%s), "
-                "conf %d\n", pc, pkt_addr, is_secure ? "s" : "ns", new_stride,
-                stride_match ? "match" : "change",
-                entry->confidence);
-
-        entry->lastAddr = pkt_addr;
-
-        // Abort prefetch generation if below confidence threshold
-        if (entry->confidence < threshConf)
-            return;
-
-        // Generate up to degree prefetches
-        for (int d = 1; d <= degree; d++) {
-            // Round strides up to atleast 1 cacheline
-            int prefetch_stride = new_stride;
-            if (abs(new_stride) < blkSize) {
-                prefetch_stride = (new_stride < 0) ? -blkSize : blkSize;
-            }
-
-            Addr new_addr = pkt_addr + d * prefetch_stride;
-            if (samePage(pkt_addr, new_addr)) {
-                DPRINTF(HWPrefetch, "Queuing prefetch to %#x.\n", new_addr);
-                addresses.push_back(AddrPriority(new_addr, 0));
-            } else {
-                // Record the number of page crossing prefetches generated
-                pfSpanPage += degree - d + 1;
-                DPRINTF(HWPrefetch, "Ignoring page crossing prefetch.\n");
-                return;
-            }
+    if (entry) {
+        // Hit in table
+        int new_stride = train(*entry, pkt_addr);
+        size_t first = addresses.size();
+        int span_page = generate(*entry, new_stride, pkt_addr, addresses);
+        for (size_t i = first; i < addresses.size(); i++)
+            DPRINTF(HWPrefetch, "Queuing prefetch to %#x.\n",
+                    addresses[i].first);
+        if (span_page) {
+            // Record the number of page crossing prefetches generated
+            pfSpanPage += span_page;
+            DPRINTF(HWPrefetch, "Ignoring page crossing prefetch.\n");
         }
     } else {
         // Miss in table
@@ -171,6 +185,7 @@ StridePrefetcher::calculatePrefetch(const PacketPtr &pkt,
         StrideEntry* entry = pcTableVictim(pc, master_id);
         entry->instAddr = pc;
         entry->lastAddr = pkt_addr;
+        entry->context = master_id;
         entry->isSecure= is_secure;
         entry->stride = 0;
         entry->confidence = startConf;
@@ -193,25 +208,38 @@ StridePrefetcher::pcTableVictim(Addr pc, int master_id)
     int way = random_mt.random<int>(0, pcTableAssoc - 1);
 
     DPRINTF(HWPrefetch, "Victimizing lookup table[%d][%d].\n", set, way);
-    return &pcTable[master_id][set][way];
+    return &pcTable.set(master_id, set)[way];
 }
 
-inline bool
-StridePrefetcher::pcTableHit(Addr pc, bool is_secure, int master_id,
-                             StrideEntry* &entry)
+inline StridePrefetcher::StrideEntry*
+StridePrefetcher::pcTableHit(Addr pc, bool is_secure, int master_id)
 {
     int set = pcHash(pc);
-    StrideEntry* set_entries = pcTable[master_id][set];
+    StrideEntry* set_entries = pcTable.set(master_id, set);
     for (int way = 0; way < pcTableAssoc; way++) {
         // Search ways for match
         if (set_entries[way].instAddr == pc &&
+            set_entries[way].context == master_id &&
             set_entries[way].isSecure == is_secure) {
             DPRINTF(HWPrefetch, "Lookup hit table[%d][%d].\n", set, way);
-            entry = &set_entries[way];
-            return true;
+            return &set_entries[way];
         }
     }
-    return false;
+    return NULL;
+}
+
+void
+StridePrefetcher::regStats()
+{
+    QueuedPrefetcher::regStats();
+
+    pfTaintedAccesses
+        .name(name() + ".pfTaintedAccesses")
+        .desc("number of accesses of unsafe loads not trained on");
+
+    pfTaintSuppressed
+        .name(name() + ".pfTaintSuppressed")
+        .desc("number of prefetches unsafe loads would have generated");
 }
 
 StridePrefetcher*
@@ -48,7 +48,7 @@
 #ifndef __MEM_CACHE_PREFETCH_STRIDE_HH__
 #define __MEM_CACHE_PREFETCH_STRIDE_HH__
 
-#include <unordered_map>
+#include <vector>
 
 #include "mem/cache/prefetch/queued.hh"
 #include "params/StridePrefetcher.hh"
@@ -63,59 +63,95 @@ class StridePrefetcher : public QueuedPrefetcher
 
     const int pcTableAssoc;
     const int pcTableSets;
+    const int pcTableContexts;
 
     const bool useMasterId;
 
     const int degree;
 
+    /**
+     * [STT] Do not train on, or prefetch for, the accesses of loads that
+     * are not safe yet (Request::SPEC). Their training is counted rather
+     * than applied, to measure the coverage it costs.
+     */
+    const bool taintSafe;
+
     struct StrideEntry
     {
-        StrideEntry() : instAddr(0), lastAddr(0), isSecure(false), stride(0),
-                        confidence(0)
+        StrideEntry() : instAddr(0), lastAddr(0), context(0),
+                        isSecure(false), stride(0), confidence(0)
         { }
 
         Addr instAddr;
         Addr lastAddr;
+        int context;
         bool isSecure;
         int stride;
         int confidence;
     };
 
+    /**
+     * Table of the strides, one set-associative table per context laid
+     * out in a single array. Contexts are hashed into a fixed number of
+     * tables, so the table does not grow with the number of masters;
+     * the entries are tagged with their context.
+     */
     class PCTable
     {
       public:
-        PCTable(int assoc, int sets, const std::string name) :
-            pcTableAssoc(assoc), pcTableSets(sets), _name(name) {}
-        StrideEntry** operator[] (int context) {
-            auto it = entries.find(context);
-            if (it != entries.end())
-                return it->second;
-
-            return allocateNewContext(context);
+        PCTable(int assoc, int sets, int contexts)
+            : pcTableAssoc(assoc), pcTableSets(sets),
+              pcTableContexts(contexts),
+              entries((size_t)assoc * sets * contexts)
+        {}
+
+        /** The ways of a set of the table of a context */
+        StrideEntry *
+        set(int context, int set)
+        {
+            size_t table = (unsigned)context % pcTableContexts;
+            return &entries[(table * pcTableSets + set) * pcTableAssoc];
         }
 
-        ~PCTable();
       private:
-        const std::string name() {return _name; }
         const int pcTableAssoc;
         const int pcTableSets;
-        const std::string _name;
-        std::unordered_map<int, StrideEntry**> entries;
-
-        StrideEntry** allocateNewContext(int context);
+        const int pcTableContexts;
+        std::vector<StrideEntry> entries;
     };
     PCTable pcTable;
 
-    bool pcTableHit(Addr pc, bool is_secure, int master_id, StrideEntry* &entry);
+    StrideEntry *pcTableHit(Addr pc, bool is_secure, int master_id);
     StrideEntry* pcTableVictim(Addr pc, int master_id);
 
     Addr pcHash(Addr pc) const;
+
+    /**
+     * Update the stride and confidence of an entry with an access.
+     *
+     * @return The stride of the access.
+     */
+    int train(StrideEntry &entry, Addr pkt_addr) const;
+
+    /**
+     * Prefetches of an entry trained with an access.
+     *
+     * @return The number of prefetches dropped as they cross a page.
+     */
+    int generate(const StrideEntry &entry, int new_stride, Addr pkt_addr,
+                 std::vector<AddrPriority> &addresses) const;
+
+    Stats::Scalar pfTaintedAccesses;
+    Stats::Scalar pfTaintSuppressed;
+
   public:
 
     StridePrefetcher(const StridePrefetcherParams *p);
 
     void calculatePrefetch(const PacketPtr &pkt,
                            std::vector<AddrPriority> &addresses);
+
+    void regStats();
 };
 
 #endif // __MEM_CACHE_PREFETCH_STRIDE_HH__
@@ -47,6 +47,7 @@
 
 #include "mem/cache/tags/base_set_assoc.hh"
 
+#include <algorithm>
 #include <string>
 
 #include "base/intmath.hh"
@@ -54,6 +55,8 @@
 
 using namespace std;
 
+const unsigned BaseSetAssoc::tagChunk;
+
 BaseSetAssoc::BaseSetAssoc(const Params *p)
     :BaseTags(p), assoc(p->assoc), allocAssoc(p->assoc),
      numSets(p->size / (p->block_size * p->assoc)),
@@ -79,6 +82,9 @@ BaseSetAssoc::BaseSetAssoc(const Params *p)
     // allocate data storage in one big chunk
     numBlocks = numSets * assoc;
     dataBlks = new uint8_t[numBlocks * blkSize];
+    packedAssoc = roundUp(assoc, tagChunk);
+    packedTags = new Addr[numSets * packedAssoc];
+    std::fill(packedTags, packedTags + numSets * packedAssoc, MaxAddr);
 
     unsigned blkIndex = 0;       // index into blks array
     for (unsigned i = 0; i < numSets; ++i) {
@@ -101,6 +107,7 @@ BaseSetAssoc::BaseSetAssoc(const Params *p)
             // Setting the tag to j is just to prevent long chains in the hash
             // table; won't matter because the block is invalid
             blk->tag = j;
+            packedTags[i * packedAssoc + j] = packTag(j, false);
             blk->whenReady = 0;
             blk->isTouched = false;
             sets[i].blks[j]=blk;
@@ -112,6 +119,7 @@ BaseSetAssoc::BaseSetAssoc(const Params *p)
 
 BaseSetAssoc::~BaseSetAssoc()
 {
+    delete [] packedTags;
     delete [] dataBlks;
     delete [] blks;
     delete [] sets;
@@ -122,7 +130,7 @@ BaseSetAssoc::findBlock(Addr addr, bool is_secure) const
 {
     Addr tag = extractTag(addr);
     unsigned set = extractSet(addr);
-    BlkType *blk = sets[set].findBlk(tag, is_secure);
+    BlkType *blk = findBlk(tag, is_secure, set);
     return blk;
 }
 
@@ -52,6 +52,7 @@
 #include <cstring>
 #include <list>
 
+#include "base/bitfield.hh"
 #include "mem/cache/base.hh"
 #include "mem/cache/blk.hh"
 #include "mem/cache/tags/base.hh"
@@ -100,6 +101,17 @@ class BaseSetAssoc : public BaseTags
     /** The data blocks, 1 per cache block. */
     uint8_t *dataBlks;
 
+    /** The number of ways compared at once by findBlk(). */
+    static const unsigned tagChunk = 4;
+    /**
+     * The tags of the blocks with their secure bit, see packTag(), by
+     * set and way. The ways of a set are padded to a multiple of
+     * tagChunk with a value no tag packs to.
+     */
+    Addr *packedTags;
+    /** The number of packed tags of a set, including the padding. */
+    unsigned packedAssoc;
+
     /** The amount to shift the address to get the set. */
     int setShift;
     /** The amount to shift the address to get the tag. */
@@ -107,6 +119,66 @@ class BaseSetAssoc : public BaseTags
     /** Mask out all bits that aren't part of the set index. */
     unsigned setMask;
 
+    /**
+     * Pack a tag and its secure bit in a word. As the tag is shifted
+     * right by at least the block offset, MaxAddr is never a packed tag.
+     */
+    static Addr
+    packTag(Addr tag, bool is_secure)
+    {
+        return (tag << 1) | is_secure;
+    }
+
+    /**
+     * Two packed tags, and their 32-bit halves. The halves are compared
+     * as 64-bit lanes compares are missing from SSE2.
+     */
+    typedef uint64_t TagPair __attribute__((vector_size(16)));
+    typedef uint32_t TagHalves __attribute__((vector_size(16)));
+
+    /**
+     * Compare tagChunk packed tags to a key with SIMD instructions.
+     *
+     * @param keys The key in both lanes of a pair.
+     * @return A mask of the ways that match.
+     */
+    static unsigned
+    matchTags(const Addr *tags, TagHalves keys)
+    {
+        TagHalves lo, hi;
+        memcpy(&lo, tags, sizeof(lo));
+        memcpy(&hi, tags + 2, sizeof(hi));
+        // A tag matches if both of its halves do
+        TagPair eq_lo = (TagPair)(lo == keys);
+        TagPair eq_hi = (TagPair)(hi == keys);
+        TagPair match = (eq_lo & (eq_lo >> 32) & 1) |
+            ((eq_hi & (eq_hi >> 32) & 1) << 2);
+        return match[0] | (match[1] << 1);
+    }
+
+    /**
+     * Find a valid block matching the tag in a set. The packed tags of
+     * the set are compared tagChunk ways at a time, only the blocks
+     * whose tags match are then checked for validity.
+     */
+    BlkType *
+    findBlk(Addr tag, bool is_secure, int set) const
+    {
+        Addr key = packTag(tag, is_secure);
+        TagHalves keys = (TagHalves)(TagPair){ key, key };
+        const Addr *set_tags = &packedTags[set * packedAssoc];
+        for (unsigned way = 0; way < packedAssoc; way += tagChunk) {
+            unsigned match = matchTags(set_tags + way, keys);
+            while (match) {
+                BlkType *blk = &blks[set * assoc + way + findLsbSet(match)];
+                if (blk->isValid())
+                    return blk;
+                match &= match - 1;
+            }
+        }
+        return nullptr;
+    }
+
 public:
 
     /** Convenience typedef. */
@@ -160,7 +232,7 @@ public:
     {
         Addr tag = extractTag(addr);
         int set = extractSet(addr);
-        BlkType *blk = sets[set].findBlk(tag, is_secure);
+        BlkType *blk = findBlk(tag, is_secure, set);
 
         // Access all tags in parallel, hence one in each way.  The data side
         // either accesses all blocks in parallel, or one block sequentially on
@@ -267,6 +339,8 @@ public:
 
          // Set tag for new block.  Caller is responsible for setting status.
          blk->tag = extractTag(addr);
+         packedTags[blk->set * packedAssoc + blk->way] =
+             packTag(blk->tag, pkt->isSecure());
 
          // deal with what we are bringing in
          assert(master_id < cache->system->maxMasters());
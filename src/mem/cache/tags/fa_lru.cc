@@ -55,8 +55,49 @@
 
 using namespace std;
 
+FALRU::TagIndex::TagIndex(unsigned max_entries, unsigned blk_size)
+    : slots(ceilPow2(max_entries * 2)), mask(slots.size() - 1),
+      blkShift(floorLog2(blk_size)),
+      hashShift(64 - floorLog2(slots.size()))
+{
+    for (auto &slot : slots)
+        slot.blk = nullptr;
+}
+
+void
+FALRU::TagIndex::insert(Addr addr, FALRUBlk *blk)
+{
+    unsigned i = home(addr);
+    while (slots[i].blk && slots[i].addr != addr)
+        i = (i + 1) & mask;
+    slots[i].addr = addr;
+    slots[i].blk = blk;
+}
+
+void
+FALRU::TagIndex::erase(Addr addr, FALRUBlk *blk)
+{
+    unsigned i = home(addr);
+    while (slots[i].blk && slots[i].addr != addr)
+        i = (i + 1) & mask;
+    if (slots[i].blk != blk)
+        return;
+
+    // Move back the entries of the run that may not be found past the
+    // hole any more, i.e., whose home is not between the hole and them
+    for (unsigned j = (i + 1) & mask; slots[j].blk; j = (j + 1) & mask) {
+        unsigned dist = (j - home(slots[j].addr)) & mask;
+        if (dist >= ((j - i) & mask)) {
+            slots[i] = slots[j];
+            i = j;
+        }
+    }
+    slots[i].blk = nullptr;
+}
+
 FALRU::FALRU(const Params *p)
-    : BaseTags(p), cacheBoundaries(nullptr)
+    : BaseTags(p), cacheBoundaries(nullptr),
+      tagIndex(p->size / p->block_size, p->block_size)
 {
     if (!isPowerOf2(blkSize))
         fatal("cache block size (in bytes) `%d' must be a power of two",
@@ -155,11 +196,7 @@ FALRU::regStats()
 FALRUBlk *
 FALRU::hashLookup(Addr addr) const
 {
-    tagIterator iter = tagHash.find(addr);
-    if (iter != tagHash.end()) {
-        return (*iter).second;
-    }
-    return nullptr;
+    return tagIndex.find(addr);
 }
 
 void
@@ -251,8 +288,6 @@ FALRU::findVictim(Addr addr)
     FALRUBlk * blk = tail;
     assert(blk->inCache == 0);
     moveToHead(blk);
-    tagHash.erase(blk->tag);
-    tagHash[blkAlign(addr)] = blk;
     if (blk->isValid()) {
         replacements[0]++;
     } else {
@@ -270,6 +305,11 @@ FALRU::findVictim(Addr addr)
 void
 FALRU::insertBlock(PacketPtr pkt, CacheBlk *blk)
 {
+    // The victim keeps its tag until it is replaced, for its writeback
+    FALRUBlk *falru_blk = static_cast<FALRUBlk *>(blk);
+    tagIndex.erase(blk->tag, falru_blk);
+    blk->tag = extractTag(pkt->getAddr());
+    tagIndex.insert(blk->tag, falru_blk);
 }
 
 void
@@ -49,7 +49,7 @@
 #define __MEM_CACHE_TAGS_FA_LRU_HH__
 
 #include <list>
-#include <unordered_map>
+#include <vector>
 
 #include "mem/cache/base.hh"
 #include "mem/cache/blk.hh"
@@ -107,13 +107,60 @@ class FALRU : public BaseTags
     /** The LRU block. */
     FALRUBlk *tail;
 
-    /** Hash table type mapping addresses to cache block pointers. */
-    typedef std::unordered_map<Addr, FALRUBlk *, std::hash<Addr> > hash_t;
-    /** Iterator into the address hash table. */
-    typedef hash_t::const_iterator tagIterator;
+    /**
+     * Open-addressing hash table from block addresses to blocks, with
+     * linear probing. A block is indexed by at most one address, so the
+     * table is at most half full; removals shift the entries that
+     * follow back instead of leaving tombstones.
+     */
+    class TagIndex
+    {
+      public:
+        /**
+         * @param max_entries The number of blocks indexed.
+         * @param blk_size The block size, addresses are block aligned.
+         */
+        TagIndex(unsigned max_entries, unsigned blk_size);
+
+        FALRUBlk *
+        find(Addr addr) const
+        {
+            for (unsigned i = home(addr); slots[i].blk;
+                 i = (i + 1) & mask) {
+                if (slots[i].addr == addr)
+                    return slots[i].blk;
+            }
+            return nullptr;
+        }
+
+        /** Map addr to blk, replacing any block it mapped to. */
+        void insert(Addr addr, FALRUBlk *blk);
+
+        /** Remove the entry of addr if it maps to blk. */
+        void erase(Addr addr, FALRUBlk *blk);
+
+      private:
+        struct Slot
+        {
+            Addr addr;
+            FALRUBlk *blk;
+        };
+
+        unsigned
+        home(Addr addr) const
+        {
+            return ((addr >> blkShift) * ULL(0x9e3779b97f4a7c15)) >>
+                hashShift;
+        }
+
+        std::vector<Slot> slots;
+        unsigned mask;
+        const int blkShift;
+        int hashShift;
+    };
 
-    /** The address hash table. */
-    hash_t tagHash;
+    /** The address index of the blocks. */
+    TagIndex tagIndex;
 
     /**
      * Find the cache block for the given address.
@@ -338,6 +338,10 @@ class Packet : public Printable
         ONLY_ACCESS_SPEC_BUFF      = 0x00080000,
 
         EXTERNAL_EVICTION = 0x00100000,
+
+        // Atomic access of a CPU warming the caches of the CPU switched
+        // in after it, see AtomicSimpleCPU::warmup_insts
+        WARMUP                = 0x00200000,
     };
 
     Flags flags;
@@ -597,6 +601,7 @@ class Packet : public Printable
     bool isFirst() const             { return flags.isSet(FIRST_IN_SPLIT); }
     bool onlyAccessSpecBuff() const
         { return flags.isSet(ONLY_ACCESS_SPEC_BUFF); }
+    bool isWarmup() const            { return flags.isSet(WARMUP); }
 
     void setL1Hit()
     {
@@ -618,6 +623,8 @@ class Packet : public Printable
         flags.set(ONLY_ACCESS_SPEC_BUFF);
     }
 
+    void setWarmup() { flags.set(WARMUP); }
+
     void setFirst()
     {
         //assert(isSpec());
@@ -41,10 +41,25 @@
 
 #include "base/chunk_generator.hh"
 
+FunctionalRangeInterface *
+PortProxy::rangePeer() const
+{
+    if (!_rangePeerResolved && _port.isConnected()) {
+        _rangePeer =
+            dynamic_cast<FunctionalRangeInterface *>(&_port.getSlavePort());
+        _rangePeerResolved = true;
+    }
+    return _rangePeer;
+}
+
 void
 PortProxy::readBlobPhys(Addr addr, Request::Flags flags,
                         uint8_t *p, int size) const
 {
+    FunctionalRangeInterface *peer = rangePeer();
+    if (peer && peer->functionalReadRange(addr, p, size))
+        return;
+
     for (ChunkGenerator gen(addr, size, _cacheLineSize); !gen.done();
          gen.next()) {
         Request req(gen.addr(), gen.size(), flags, Request::funcMasterId);
@@ -59,6 +74,10 @@ void
 PortProxy::writeBlobPhys(Addr addr, Request::Flags flags,
                          const uint8_t *p, int size) const
 {
+    FunctionalRangeInterface *peer = rangePeer();
+    if (peer && peer->functionalWriteRange(addr, p, size))
+        return;
+
     for (ChunkGenerator gen(addr, size, _cacheLineSize); !gen.done();
          gen.next()) {
         Request req(gen.addr(), gen.size(), flags, Request::funcMasterId);
@@ -67,6 +67,25 @@
 #include "mem/port.hh"
 #include "sim/byteswap.hh"
 
+/**
+ * Implemented by the slave ports that can perform a functional access
+ * to a whole range at once, rather than one cache line at a time. The
+ * request flags are not passed on, these ports must ignore them.
+ */
+class FunctionalRangeInterface
+{
+  public:
+    virtual ~FunctionalRangeInterface() { }
+
+    /**
+     * @return False if the port cannot access this range, the access
+     *         is then done line by line with functional packets.
+     */
+    virtual bool functionalReadRange(Addr addr, uint8_t *p, int size) = 0;
+    virtual bool functionalWriteRange(Addr addr, const uint8_t *p,
+                                      int size) = 0;
+};
+
 /**
  * This object is a proxy for a structural port, to be used for debug
  * accesses.
@@ -91,9 +110,20 @@ class PortProxy
     /** Granularity of any transactions issued through this proxy. */
     const unsigned int _cacheLineSize;
 
+    /**
+     * Peer of the port if it serves whole ranges, looked up on first
+     * use as the port may not be connected yet when the proxy is
+     * created.
+     */
+    mutable FunctionalRangeInterface *_rangePeer;
+    mutable bool _rangePeerResolved;
+
+    FunctionalRangeInterface *rangePeer() const;
+
   public:
     PortProxy(MasterPort &port, unsigned int cacheLineSize) :
-        _port(port), _cacheLineSize(cacheLineSize) { }
+        _port(port), _cacheLineSize(cacheLineSize), _rangePeer(NULL),
+        _rangePeerResolved(false) { }
     virtual ~PortProxy() { }
 
     /**
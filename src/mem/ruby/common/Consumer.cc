@@ -28,6 +28,8 @@
 
 #include "mem/ruby/common/Consumer.hh"
 
+#include "mem/ruby/common/DeferredEffects.hh"
+
 using namespace std;
 
 void
@@ -39,17 +41,59 @@ Consumer::scheduleEvent(Cycles timeDelta)
 void
 Consumer::scheduleEventAbsolute(Tick evt_time)
 {
+    // Deferred during parallel controller evaluation
+    if (DeferredEffects::defer([this, evt_time]
+                               { scheduleEventAbsolute(evt_time); })) {
+        return;
+    }
+
     if (!alreadyScheduled(evt_time)) {
         // This wakeup is not redundant
-        auto *evt = new EventFunctionWrapper(
-            [this]{ wakeup(); }, "Consumer Event", true);
+        if (m_scheduler) {
+            m_scheduler->scheduleWakeup(this, evt_time);
+        } else {
+            auto *evt = new EventFunctionWrapper(
+                [this]{ wakeup(); }, "Consumer Event", true);
 
-        em->schedule(evt, evt_time);
+            em->schedule(evt, evt_time);
+        }
         insertScheduledWakeupTime(evt_time);
     }
 
-    Tick t = em->clockEdge();
-    set<Tick>::iterator bit = m_scheduled_wakeups.begin();
-    set<Tick>::iterator eit = m_scheduled_wakeups.lower_bound(t);
-    m_scheduled_wakeups.erase(bit,eit);
+    pruneScheduledWakeups(em->clockEdge());
+}
+
+void
+Consumer::pruneScheduledWakeups(Tick now)
+{
+    if (now > m_wakeup_base) {
+        Tick period = em->clockPeriod();
+        Tick offset = now - m_wakeup_base;
+
+        if (m_wakeup_bits && period == m_wakeup_period &&
+            offset % period == 0) {
+            // Slide the window to the current edge
+            Tick shift = offset / period;
+            m_wakeup_bits = shift < wakeupWindow ?
+                m_wakeup_bits >> shift : 0;
+        } else {
+            // The clock changed: keep the pending wakeups in the set
+            for (unsigned i = 0; m_wakeup_bits; ++i) {
+                if (m_wakeup_bits & 1) {
+                    m_scheduled_wakeups.insert(m_wakeup_base +
+                                               i * m_wakeup_period);
+                }
+                m_wakeup_bits >>= 1;
+            }
+        }
+
+        m_wakeup_base = now;
+        m_wakeup_period = period;
+    }
+
+    if (!m_scheduled_wakeups.empty()) {
+        set<Tick>::iterator bit = m_scheduled_wakeups.begin();
+        set<Tick>::iterator eit = m_scheduled_wakeups.lower_bound(now);
+        m_scheduled_wakeups.erase(bit,eit);
+    }
 }
@@ -40,11 +40,26 @@
 
 #include "sim/clocked_object.hh"
 
+class Consumer;
+
+/**
+ * Alternative to one event per wakeup: a scheduler takes over the
+ * (already coalesced) wakeups of the consumers attached to it, e.g., to
+ * service all the components of a network from a single event.
+ */
+class WakeupScheduler
+{
+  public:
+    virtual ~WakeupScheduler() { }
+    virtual void scheduleWakeup(Consumer *consumer, Tick when) = 0;
+};
+
 class Consumer
 {
   public:
     Consumer(ClockedObject *_em)
-        : em(_em)
+        : m_wakeup_bits(0), m_wakeup_base(0), m_wakeup_period(1),
+          m_scheduler(NULL), em(_em)
     {
     }
 
@@ -57,24 +72,73 @@ class Consumer
     virtual void storeEventInfo(int info) {}
 
     bool
-    alreadyScheduled(Tick time)
+    alreadyScheduled(Tick time) const
     {
-        return m_scheduled_wakeups.find(time) != m_scheduled_wakeups.end();
+        if (inWakeupWindow(time) &&
+            (m_wakeup_bits & (1ULL << wakeupIndex(time)))) {
+            return true;
+        }
+        return !m_scheduled_wakeups.empty() &&
+            m_scheduled_wakeups.find(time) != m_scheduled_wakeups.end();
     }
 
     void
     insertScheduledWakeupTime(Tick time)
     {
-        m_scheduled_wakeups.insert(time);
+        if (inWakeupWindow(time))
+            m_wakeup_bits |= 1ULL << wakeupIndex(time);
+        else
+            m_scheduled_wakeups.insert(time);
     }
 
     void scheduleEventAbsolute(Tick timeAbs);
 
+    //! Event queue the wakeups of this consumer are scheduled on.
+    EventQueue *getEventQueue() const { return em->eventQueue(); }
+
+    //! Hand the wakeups of this consumer to a scheduler (NULL to go
+    //! back to regular events).
+    void setWakeupScheduler(WakeupScheduler *s) { m_scheduler = s; }
+
   protected:
     void scheduleEvent(Cycles timeDelta);
 
   private:
+    /**
+     * Wakeups are coalesced so that a consumer is woken up at most once
+     * per tick. Almost all of them fall on one of the next few clock
+     * edges of the consumer, and are tracked with one bit per cycle in
+     * a window starting at the current clock edge. Wakeups outside the
+     * window, e.g., at ticks that are not edges of this consumer's
+     * clock, go to the m_scheduled_wakeups set.
+     */
+    static const unsigned wakeupWindow = 64;
+
+    bool
+    inWakeupWindow(Tick time) const
+    {
+        return time >= m_wakeup_base &&
+            (time - m_wakeup_base) % m_wakeup_period == 0 &&
+            (time - m_wakeup_base) / m_wakeup_period < wakeupWindow;
+    }
+
+    unsigned
+    wakeupIndex(Tick time) const
+    {
+        return (time - m_wakeup_base) / m_wakeup_period;
+    }
+
+    //! Forget the wakeups before the given clock edge.
+    void pruneScheduledWakeups(Tick now);
+
+    //! Bit i is set if a wakeup is scheduled at m_wakeup_base plus i
+    //! clock periods.
+    uint64_t m_wakeup_bits;
+    Tick m_wakeup_base;
+    Tick m_wakeup_period;
+
     std::set<Tick> m_scheduled_wakeups;
+    WakeupScheduler *m_scheduler;
     ClockedObject *em;
 };
 
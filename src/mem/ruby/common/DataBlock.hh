@@ -43,6 +43,7 @@ class DataBlock
     DataBlock()
     {
         alloc();
+        clear();
     }
 
     DataBlock(const DataBlock &cp);
@@ -70,9 +71,17 @@ class DataBlock
     void print(std::ostream& out) const;
 
   private:
+    /**
+     * Blocks up to this size are stored in the DataBlock itself, so
+     * that messages, TBEs and cache entries don't allocate memory for
+     * the default block size. Larger blocks are allocated on the heap.
+     */
+    static const int inlineBytes = 64;
+
     void alloc();
     uint8_t *m_data;
     bool m_alloc;
+    uint8_t m_inline[inlineBytes] __attribute__ ((aligned (8)));
 };
 
 inline void
@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2018 The University of Illinois at Urbana-Champaign
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/*
+ * Operations of a controller that have effects outside of it, e.g.,
+ * message enqueues, wakeups and callbacks to the CPUs, can be deferred
+ * while the controllers woken up in a tick are evaluated in parallel
+ * (see mem/ruby/system/ControllerScheduler.hh). They are then performed
+ * by the simulation thread at the end of the tick, controller by
+ * controller and in program order within a controller.
+ */
+
+#ifndef __MEM_RUBY_COMMON_DEFERREDEFFECTS_HH__
+#define __MEM_RUBY_COMMON_DEFERREDEFFECTS_HH__
+
+#include <functional>
+#include <vector>
+
+#include "base/types.hh"
+
+class DeferredEffects
+{
+  public:
+    typedef std::function<void()> Effect;
+
+    struct Entry
+    {
+        Effect effect;
+        //! Object whose state depends on the order of the effects, and
+        //! the tick that order matters for, e.g., a message buffer and
+        //! the arrival time of a message. NULL if the effect commutes
+        //! with the effects of the other controllers.
+        const void *target;
+        Tick when;
+    };
+
+    /**
+     * Queue an effect if a controller is being evaluated in parallel on
+     * this thread, and return true. Otherwise return false, the caller
+     * must then perform it immediately.
+     */
+    static bool
+    defer(Effect effect, const void *target = NULL, Tick when = 0)
+    {
+        if (!current)
+            return false;
+        current->push_back({ std::move(effect), target, when });
+        return true;
+    }
+
+    static bool active() { return current != NULL; }
+
+    //! Collect the effects of the current thread in effects (NULL to
+    //! perform them immediately again).
+    static void setCurrent(std::vector<Entry> *effects) { current = effects; }
+
+  private:
+    static __thread std::vector<Entry> *current;
+};
+
+#endif // __MEM_RUBY_COMMON_DEFERREDEFFECTS_HH__
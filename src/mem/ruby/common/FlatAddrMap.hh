@@ -0,0 +1,224 @@
+/*
+ * Copyright (c) 2018 The University of Illinois at Urbana-Champaign
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/*
+ * A hash map from addresses to values stored in a flat array with open
+ * addressing and linear probing, for the maps of Ruby that are looked
+ * up on every message. Erasing shifts the following entries back, so no
+ * tombstones accumulate. Iterators and references are invalidated by
+ * insertions and erasures.
+ */
+
+#ifndef __MEM_RUBY_COMMON_FLATADDRMAP_HH__
+#define __MEM_RUBY_COMMON_FLATADDRMAP_HH__
+
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include "base/types.hh"
+
+template <class V>
+class FlatAddrMap
+{
+  private:
+    struct Slot
+    {
+        bool used;
+        std::pair<Addr, V> entry;
+
+        Slot() : used(false), entry() {}
+    };
+
+    template <class S, class E>
+    class Iter : public std::iterator<std::forward_iterator_tag, E>
+    {
+      private:
+        S *slot;
+        S *last;
+
+        void skip() { while (slot != last && !slot->used) ++slot; }
+
+      public:
+        Iter(S *_slot, S *_last) : slot(_slot), last(_last) { skip(); }
+
+        E &operator*() const { return slot->entry; }
+        E *operator->() const { return &slot->entry; }
+        Iter &operator++() { ++slot; skip(); return *this; }
+        bool operator==(const Iter &other) const
+        { return slot == other.slot; }
+        bool operator!=(const Iter &other) const
+        { return slot != other.slot; }
+
+        friend class FlatAddrMap;
+    };
+
+  public:
+    typedef std::pair<Addr, V> value_type;
+    typedef Iter<Slot, value_type> iterator;
+    typedef Iter<const Slot, const value_type> const_iterator;
+
+    FlatAddrMap() : slots(minSlots), numEntries(0) {}
+
+    size_t size() const { return numEntries; }
+    bool empty() const { return numEntries == 0; }
+
+    iterator begin() { return iterator(first(), last()); }
+    iterator end() { return iterator(last(), last()); }
+    const_iterator begin() const { return const_iterator(first(), last()); }
+    const_iterator end() const { return const_iterator(last(), last()); }
+
+    iterator
+    find(Addr addr)
+    {
+        Slot *slot = lookup(addr);
+        return slot ? iterator(slot, last()) : end();
+    }
+
+    size_t count(Addr addr) const
+    {
+        return const_cast<FlatAddrMap *>(this)->lookup(addr) ? 1 : 0;
+    }
+
+    //! Value of addr, default constructed if it is not in the map yet
+    V &
+    operator[](Addr addr)
+    {
+        Slot *slot = lookup(addr);
+        if (slot)
+            return slot->entry.second;
+
+        // Keep the load factor at or below 1/2
+        if (2 * (numEntries + 1) > slots.size())
+            grow();
+
+        size_t i = home(addr);
+        while (slots[i].used)
+            i = (i + 1) & mask();
+        slots[i].used = true;
+        slots[i].entry.first = addr;
+        numEntries++;
+        return slots[i].entry.second;
+    }
+
+    void
+    erase(iterator it)
+    {
+        assert(it.slot != last() && it.slot->used);
+        size_t hole = it.slot - first();
+
+        // Move back the entries of the probe run after the hole which
+        // would not be found from their home slot anymore
+        for (size_t i = (hole + 1) & mask(); slots[i].used;
+             i = (i + 1) & mask()) {
+            size_t h = home(slots[i].entry.first);
+            bool reachable = hole <= i ? (hole < h && h <= i) :
+                                         (hole < h || h <= i);
+            if (!reachable) {
+                slots[hole].entry = std::move(slots[i].entry);
+                hole = i;
+            }
+        }
+        slots[hole].used = false;
+        slots[hole].entry = value_type();
+        numEntries--;
+    }
+
+    size_t
+    erase(Addr addr)
+    {
+        iterator it = find(addr);
+        if (it == end())
+            return 0;
+        erase(it);
+        return 1;
+    }
+
+    void
+    clear()
+    {
+        for (auto &slot : slots) {
+            if (slot.used) {
+                slot.used = false;
+                slot.entry = value_type();
+            }
+        }
+        numEntries = 0;
+    }
+
+  private:
+    static const size_t minSlots = 16;
+
+    std::vector<Slot> slots;
+    size_t numEntries;
+
+    Slot *first() { return slots.data(); }
+    Slot *last() { return slots.data() + slots.size(); }
+    const Slot *first() const { return slots.data(); }
+    const Slot *last() const { return slots.data() + slots.size(); }
+
+    size_t mask() const { return slots.size() - 1; }
+
+    //! Fibonacci hashing, line addresses have their low bits clear
+    size_t
+    home(Addr addr) const
+    {
+        return (size_t)((addr * 0x9e3779b97f4a7c15ULL) >> 32) & mask();
+    }
+
+    Slot *
+    lookup(Addr addr)
+    {
+        for (size_t i = home(addr); slots[i].used; i = (i + 1) & mask()) {
+            if (slots[i].entry.first == addr)
+                return &slots[i];
+        }
+        return NULL;
+    }
+
+    void
+    grow()
+    {
+        std::vector<Slot> old(2 * slots.size());
+        old.swap(slots);
+        for (auto &slot : old) {
+            if (!slot.used)
+                continue;
+            size_t i = home(slot.entry.first);
+            while (slots[i].used)
+                i = (i + 1) & mask();
+            slots[i].used = true;
+            slots[i].entry = std::move(slot.entry);
+        }
+    }
+};
+
+#endif // __MEM_RUBY_COMMON_FLATADDRMAP_HH__
@@ -28,6 +28,7 @@
 
 #include "mem/ruby/network/MessageBuffer.hh"
 
+#include <algorithm>
 #include <cassert>
 
 #include "base/cprintf.hh"
@@ -35,7 +36,9 @@
 #include "base/random.hh"
 #include "base/stl_helpers.hh"
 #include "debug/RubyQueue.hh"
+#include "mem/ruby/common/DeferredEffects.hh"
 #include "mem/ruby/system/RubySystem.hh"
+#include "sim/eventq_impl.hh"
 
 using namespace std;
 using m5::stl_helpers::operator<<;
@@ -49,6 +52,7 @@ MessageBuffer::MessageBuffer(const Params *p)
 {
     m_msg_counter = 0;
     m_consumer = NULL;
+    m_remote_last_arrival_time = 0;
     m_size_last_time_size_checked = 0;
     m_size_at_cycle_start = 0;
     m_msgs_this_cycle = 0;
@@ -69,7 +73,7 @@ MessageBuffer::getSize(Tick curTime)
 {
     if (m_time_last_time_size_checked != curTime) {
         m_time_last_time_size_checked = curTime;
-        m_size_last_time_size_checked = m_prio_heap.size();
+        m_size_last_time_size_checked = m_msg_queue.size();
     }
 
     return m_size_last_time_size_checked;
@@ -91,8 +95,8 @@ MessageBuffer::areNSlotsAvailable(unsigned int n, Tick current_time)
     unsigned int current_size = 0;
 
     if (m_time_last_time_pop < current_time) {
-        // no pops this cycle - heap size is correct
-        current_size = m_prio_heap.size();
+        // no pops this cycle - queue size is correct
+        current_size = m_msg_queue.size();
     } else {
         if (m_time_last_time_enqueue < current_time) {
             // no enqueues this cycle - m_size_at_cycle_start is correct
@@ -108,9 +112,9 @@ MessageBuffer::areNSlotsAvailable(unsigned int n, Tick current_time)
     if (current_size + m_stall_map_size + n <= m_max_size) {
         return true;
     } else {
-        DPRINTF(RubyQueue, "n: %d, current_size: %d, heap size: %d, "
+        DPRINTF(RubyQueue, "n: %d, current_size: %d, queue size: %d, "
                 "m_max_size: %d\n",
-                n, current_size, m_prio_heap.size(), m_max_size);
+                n, current_size, m_msg_queue.size(), m_max_size);
         m_not_avail_count++;
         return false;
     }
@@ -120,7 +124,7 @@ const Message*
 MessageBuffer::peek() const
 {
     DPRINTF(RubyQueue, "Peeking at head of queue.\n");
-    const Message* msg_ptr = m_prio_heap.front().get();
+    const Message* msg_ptr = m_msg_queue.front().get();
     assert(msg_ptr);
 
     DPRINTF(RubyQueue, "Message: %s\n", (*msg_ptr));
@@ -142,6 +146,27 @@ random_time()
 void
 MessageBuffer::enqueue(MsgPtr message, Tick current_time, Tick delta)
 {
+    assert(m_consumer != NULL);
+    if (inParallelMode &&
+        m_consumer->getEventQueue() != curEventQueue()) {
+        enqueueRemote(message, current_time, delta);
+        return;
+    }
+
+    // The buffer is only updated at the end of the tick while the
+    // controllers are evaluated in parallel. The order of the messages
+    // arriving in the same tick depends on the order of the enqueues.
+    if (DeferredEffects::active()) {
+        if (m_max_size != 0) {
+            panic("%s: finite buffers are not supported with parallel "
+                  "controller evaluation\n", name());
+        }
+        DeferredEffects::defer([this, message, current_time, delta]
+                               { enqueue(message, current_time, delta); },
+                               this, current_time + delta);
+        return;
+    }
+
     // record current time incase we have a pop that also adjusts my size
     if (m_time_last_time_enqueue < current_time) {
         m_msgs_this_cycle = 0;  // first msg this cycle
@@ -198,9 +223,8 @@ MessageBuffer::enqueue(MsgPtr message, Tick current_time, Tick delta)
     msg_ptr->setLastEnqueueTime(arrival_time);
     msg_ptr->setMsgCounter(m_msg_counter);
 
-    // Insert the message into the priority heap
-    m_prio_heap.push_back(message);
-    push_heap(m_prio_heap.begin(), m_prio_heap.end(), greater<MsgPtr>());
+    // Insert the message into the queue
+    insertMessage(message);
     // Increment the number of messages statistic
     m_buf_msgs++;
 
@@ -213,6 +237,109 @@ MessageBuffer::enqueue(MsgPtr message, Tick current_time, Tick delta)
     m_consumer->storeEventInfo(m_vnet_id);
 }
 
+void
+MessageBuffer::enqueueRemote(MsgPtr message, Tick current_time, Tick delta)
+{
+    // The producer only touches the message and, under the lock, the
+    // remote list; the buffer state is updated on the consumer's
+    // thread when the message arrives.
+    if (delta < simQuantum) {
+        panic("%s: latency %d between event queues is shorter than the "
+              "simulation quantum %d\n", name(), delta, simQuantum);
+    }
+    if (m_max_size != 0) {
+        panic("%s: finite buffers can not be shared between event "
+              "queues\n", name());
+    }
+    if (RubySystem::getRandomization() && m_randomization) {
+        panic("%s: randomization is not supported across event "
+              "queues\n", name());
+    }
+
+    Tick arrival_time = current_time + delta;
+    Message* msg_ptr = message.get();
+    assert(msg_ptr != NULL);
+    msg_ptr->updateDelayedTicks(current_time);
+    msg_ptr->setLastEnqueueTime(arrival_time);
+
+    DPRINTF(RubyQueue, "Remote enqueue arrival_time: %lld, Message: %s\n",
+            arrival_time, *msg_ptr);
+
+    std::list<MsgPtr>::iterator it;
+    {
+        std::lock_guard<std::mutex> lock(m_remote_mutex);
+        if (m_strict_fifo && arrival_time < m_remote_last_arrival_time) {
+            panic("FIFO ordering violated: name: %s current time: %d "
+                  "delta: %d arrival_time: %d last remote arrival_time: "
+                  "%d\n", name(), current_time, delta, arrival_time,
+                  m_remote_last_arrival_time);
+        }
+        m_remote_last_arrival_time = arrival_time;
+        it = m_remote_msgs.insert(m_remote_msgs.end(), message);
+    }
+
+    // This ends up in the consumer's async queue and is merged at the
+    // end of the current quantum, before its arrival time.
+    auto *evt = new EventFunctionWrapper(
+        [this, it]{ mergeRemote(it); }, name() + ".remoteEnqueue", true);
+    m_consumer->getEventQueue()->schedule(evt, arrival_time);
+}
+
+void
+MessageBuffer::mergeRemote(std::list<MsgPtr>::iterator it)
+{
+    MsgPtr message;
+    {
+        std::lock_guard<std::mutex> lock(m_remote_mutex);
+        message = *it;
+        m_remote_msgs.erase(it);
+    }
+
+    // The message is enqueued in the buffer now, on the consumer's
+    // thread, which owns the state below. Unlike a local enqueue, it
+    // only counts in the occupancy from its arrival, and it follows
+    // the local messages arriving in the same tick, so the timing of
+    // a parallel run differs from that of a serial one.
+    Tick current_time = curTick();
+    if (m_time_last_time_enqueue < current_time) {
+        m_msgs_this_cycle = 0;
+        m_time_last_time_enqueue = current_time;
+    }
+    m_msgs_this_cycle++;
+
+    Tick arrival_time = message->getLastEnqueueTime();
+    if (!RubySystem::getWarmupEnabled() &&
+        m_last_arrival_time < arrival_time) {
+        m_last_arrival_time = arrival_time;
+    }
+
+    m_msg_counter++;
+    message->setMsgCounter(m_msg_counter);
+
+    insertMessage(message);
+    m_buf_msgs++;
+
+    m_consumer->scheduleEventAbsolute(arrival_time);
+    m_consumer->storeEventInfo(m_vnet_id);
+}
+
+void
+MessageBuffer::insertMessage(const MsgPtr &message)
+{
+    // Common case: the message arrives after all the others
+    if (m_msg_queue.empty() || !(m_msg_queue.back() > message)) {
+        m_msg_queue.push_back(message);
+        return;
+    }
+
+    // Otherwise insert it after all the messages that are not
+    // ordered after it.
+    auto it = upper_bound(m_msg_queue.begin(), m_msg_queue.end(), message,
+        [](const MsgPtr &msg, const MsgPtr &other)
+        { return other > msg; });
+    m_msg_queue.insert(it, message);
+}
+
 Tick
 MessageBuffer::dequeue(Tick current_time, bool decrement_messages)
 {
@@ -220,7 +347,7 @@ MessageBuffer::dequeue(Tick current_time, bool decrement_messages)
     assert(isReady(current_time));
 
     // get MsgPtr of the message about to be dequeued
-    MsgPtr message = m_prio_heap.front();
+    MsgPtr message = m_msg_queue.front();
 
     // get the delay cycles
     message->updateDelayedTicks(current_time);
@@ -231,12 +358,11 @@ MessageBuffer::dequeue(Tick current_time, bool decrement_messages)
     // record previous size and time so the current buffer size isn't
     // adjusted until schd cycle
     if (m_time_last_time_pop < current_time) {
-        m_size_at_cycle_start = m_prio_heap.size();
+        m_size_at_cycle_start = m_msg_queue.size();
         m_time_last_time_pop = current_time;
     }
 
-    pop_heap(m_prio_heap.begin(), m_prio_heap.end(), greater<MsgPtr>());
-    m_prio_heap.pop_back();
+    m_msg_queue.pop_front();
     if (decrement_messages) {
         // If the message will be removed from the queue, decrement the
         // number of message in the queue.
@@ -266,7 +392,7 @@ MessageBuffer::unregisterDequeueCallback()
 void
 MessageBuffer::clear()
 {
-    m_prio_heap.clear();
+    m_msg_queue.clear();
 
     m_msg_counter = 0;
     m_time_last_time_enqueue = 0;
@@ -280,14 +406,13 @@ MessageBuffer::recycle(Tick current_time, Tick recycle_latency)
 {
     DPRINTF(RubyQueue, "Recycling.\n");
     assert(isReady(current_time));
-    MsgPtr node = m_prio_heap.front();
-    pop_heap(m_prio_heap.begin(), m_prio_heap.end(), greater<MsgPtr>());
+    MsgPtr node = m_msg_queue.front();
+    m_msg_queue.pop_front();
 
     Tick future_time = current_time + recycle_latency;
     node->setLastEnqueueTime(future_time);
 
-    m_prio_heap.back() = node;
-    push_heap(m_prio_heap.begin(), m_prio_heap.end(), greater<MsgPtr>());
+    insertMessage(node);
     m_consumer->scheduleEventAbsolute(future_time);
 }
 
@@ -300,9 +425,7 @@ MessageBuffer::reanalyzeList(list<MsgPtr> &lt, Tick schdTick)
         m->setLastEnqueueTime(schdTick);
         m->setMsgCounter(m_msg_counter);
 
-        m_prio_heap.push_back(m);
-        push_heap(m_prio_heap.begin(), m_prio_heap.end(),
-                  greater<MsgPtr>());
+        insertMessage(m);
 
         m_consumer->scheduleEventAbsolute(schdTick);
         lt.pop_front();
@@ -313,18 +436,20 @@ void
 MessageBuffer::reanalyzeMessages(Addr addr, Tick current_time)
 {
     DPRINTF(RubyQueue, "ReanalyzeMessages %#x\n", addr);
-    assert(m_stall_msg_map.count(addr) > 0);
 
     //
     // Put all stalled messages associated with this address back on the
-    // prio heap.  The reanalyzeList call will make sure the consumer is
+    // queue.  The reanalyzeList call will make sure the consumer is
     // scheduled for the current cycle so that the previously stalled messages
     // will be observed before any younger messages that may arrive this cycle
     //
-    m_stall_map_size -= m_stall_msg_map[addr].size();
+    StallMsgMapType::iterator map_iter = m_stall_msg_map.find(addr);
+    panic_if(map_iter == m_stall_msg_map.end(),
+             "%s: No message stalled on %#x to reanalyze\n", name(), addr);
+    m_stall_map_size -= map_iter->second.size();
     assert(m_stall_map_size >= 0);
-    reanalyzeList(m_stall_msg_map[addr], current_time);
-    m_stall_msg_map.erase(addr);
+    reanalyzeList(map_iter->second, current_time);
+    m_stall_msg_map.erase(map_iter);
 }
 
 void
@@ -334,15 +459,24 @@ MessageBuffer::reanalyzeAllMessages(Tick current_time)
 
     //
     // Put all stalled messages associated with this address back on the
-    // prio heap.  The reanalyzeList call will make sure the consumer is
+    // queue.  The reanalyzeList call will make sure the consumer is
     // scheduled for the current cycle so that the previously stalled messages
     // will be observed before any younger messages that may arrive this cycle.
     //
-    for (StallMsgMapType::iterator map_iter = m_stall_msg_map.begin();
-         map_iter != m_stall_msg_map.end(); ++map_iter) {
-        m_stall_map_size -= map_iter->second.size();
+    // The lines are reanalyzed in address order, so that the messages
+    // are numbered the same way regardless of the hash map's layout.
+    //
+    vector<Addr> addrs;
+    addrs.reserve(m_stall_msg_map.size());
+    for (const auto &entry : m_stall_msg_map)
+        addrs.push_back(entry.first);
+    sort(addrs.begin(), addrs.end());
+
+    for (Addr addr : addrs) {
+        list<MsgPtr> &lt = m_stall_msg_map[addr];
+        m_stall_map_size -= lt.size();
         assert(m_stall_map_size >= 0);
-        reanalyzeList(map_iter->second, current_time);
+        reanalyzeList(lt, current_time);
     }
     m_stall_msg_map.clear();
 }
@@ -353,7 +487,7 @@ MessageBuffer::stallMessage(Addr addr, Tick current_time)
     DPRINTF(RubyQueue, "Stalling due to %#x\n", addr);
     assert(isReady(current_time));
     assert(getOffset(addr) == 0);
-    MsgPtr message = m_prio_heap.front();
+    MsgPtr message = m_msg_queue.front();
 
     // Since the message will just be moved to stall map, indicate that the
     // buffer should not decrement the m_buf_msgs statistic
@@ -377,16 +511,15 @@ MessageBuffer::print(ostream& out) const
         ccprintf(out, " consumer-yes ");
     }
 
-    vector<MsgPtr> copy(m_prio_heap);
-    sort_heap(copy.begin(), copy.end(), greater<MsgPtr>());
+    vector<MsgPtr> copy(m_msg_queue.begin(), m_msg_queue.end());
     ccprintf(out, "%s] %s", copy, name());
 }
 
 bool
 MessageBuffer::isReady(Tick current_time) const
 {
-    return ((m_prio_heap.size() > 0) &&
-        (m_prio_heap.front()->getLastEnqueueTime() <= current_time));
+    return (!m_msg_queue.empty() &&
+        (m_msg_queue.front()->getLastEnqueueTime() <= current_time));
 }
 
 void
@@ -429,15 +562,25 @@ MessageBuffer::functionalWrite(Packet *pkt)
 {
     uint32_t num_functional_writes = 0;
 
-    // Check the priority heap and write any messages that may
+    // Check the queue and write any messages that may
     // correspond to the address in the packet.
-    for (unsigned int i = 0; i < m_prio_heap.size(); ++i) {
-        Message *msg = m_prio_heap[i].get();
+    for (unsigned int i = 0; i < m_msg_queue.size(); ++i) {
+        Message *msg = m_msg_queue[i].get();
         if (msg->functionalWrite(pkt)) {
             num_functional_writes++;
         }
     }
 
+    // Messages still in flight from another event queue
+    {
+        std::lock_guard<std::mutex> lock(m_remote_mutex);
+        for (auto &msg : m_remote_msgs) {
+            if (msg->functionalWrite(pkt)) {
+                num_functional_writes++;
+            }
+        }
+    }
+
     // Check the stall queue and write any messages that may
     // correspond to the address in the packet.
     for (StallMsgMapType::iterator map_iter = m_stall_msg_map.begin();
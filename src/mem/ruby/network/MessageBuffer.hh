@@ -37,7 +37,10 @@
 #include <algorithm>
 #include <cassert>
 #include <functional>
+#include <deque>
 #include <iostream>
+#include <list>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -45,6 +48,7 @@
 #include "debug/RubyQueue.hh"
 #include "mem/ruby/common/Address.hh"
 #include "mem/ruby/common/Consumer.hh"
+#include "mem/ruby/common/FlatAddrMap.hh"
 #include "mem/ruby/slicc_interface/Message.hh"
 #include "mem/packet.hh"
 #include "params/MessageBuffer.hh"
@@ -66,10 +70,8 @@ class MessageBuffer : public SimObject
     void
     delayHead(Tick current_time, Tick delta)
     {
-        MsgPtr m = m_prio_heap.front();
-        std::pop_heap(m_prio_heap.begin(), m_prio_heap.end(),
-                      std::greater<MsgPtr>());
-        m_prio_heap.pop_back();
+        MsgPtr m = m_msg_queue.front();
+        m_msg_queue.pop_front();
         enqueue(m, current_time, delta);
     }
 
@@ -95,7 +97,7 @@ class MessageBuffer : public SimObject
     //! message queue.  The function assumes that the queue is nonempty.
     const Message* peek() const;
 
-    const MsgPtr &peekMsgPtr() const { return m_prio_heap.front(); }
+    const MsgPtr &peekMsgPtr() const { return m_msg_queue.front(); }
 
     void enqueue(MsgPtr message, Tick curTime, Tick delta);
 
@@ -107,7 +109,7 @@ class MessageBuffer : public SimObject
     void unregisterDequeueCallback();
 
     void recycle(Tick current_time, Tick recycle_latency);
-    bool isEmpty() const { return m_prio_heap.size() == 0; }
+    bool isEmpty() const { return m_msg_queue.empty(); }
     bool isStallMapEmpty() { return m_stall_msg_map.size() == 0; }
     unsigned int getStallMapSize() { return m_stall_msg_map.size(); }
 
@@ -131,29 +133,61 @@ class MessageBuffer : public SimObject
   private:
     void reanalyzeList(std::list<MsgPtr> &, Tick);
 
+    //! Insert a message in m_msg_queue, keeping it sorted.
+    void insertMessage(const MsgPtr &message);
+
+    /**
+     * Enqueue a message produced by a thread servicing another event
+     * queue than the consumer's. The message is held aside and merged
+     * into the buffer by an event on the consumer's queue at its
+     * arrival time, which requires the latency to be at least one
+     * simulation quantum.
+     */
+    void enqueueRemote(MsgPtr message, Tick current_time, Tick delta);
+
+    //! Move a remotely enqueued message into the message queue.
+    void mergeRemote(std::list<MsgPtr>::iterator it);
+
   private:
     // Data Members (m_ prefix)
     //! Consumer to signal a wakeup(), can be NULL
     Consumer* m_consumer;
-    std::vector<MsgPtr> m_prio_heap;
+
+    /**
+     * The messages in the buffer, sorted by arrival time and then by
+     * message counter. This is the order a heap would pop them in, but
+     * as most messages of a buffer are enqueued with the same fixed
+     * latency, they almost always arrive in the order they are
+     * enqueued: inserting is then an append to the back of the ring,
+     * and dequeuing a pop from its front.
+     */
+    std::deque<MsgPtr> m_msg_queue;
 
     std::function<void()> m_dequeue_callback;
 
-    // use a std::map for the stalled messages as this container is
-    // sorted and ensures a well-defined iteration order
-    typedef std::map<Addr, std::list<MsgPtr> > StallMsgMapType;
+    //! Messages enqueued from other event queues that have not arrived
+    //! yet, and the last of their arrival times for the FIFO check,
+    //! protected by m_remote_mutex.
+    std::list<MsgPtr> m_remote_msgs;
+    Tick m_remote_last_arrival_time;
+    std::mutex m_remote_mutex;
+
+    // the stalled messages are looked up on every stall and unblock;
+    // reanalyzeAllMessages() sorts the addresses to keep a
+    // well-defined order
+    typedef FlatAddrMap<std::list<MsgPtr> > StallMsgMapType;
 
     /**
      * A map from line addresses to lists of stalled messages for that line.
      * If this buffer allows the receiver to stall messages, on a stall
-     * request, the stalled message is removed from the m_prio_heap and placed
+     * request, the stalled message is removed from the m_msg_queue and placed
      * in the m_stall_msg_map. Messages are held there until the receiver
      * requests they be reanalyzed, at which point they are moved back to
-     * m_prio_heap.
+     * m_msg_queue.
      *
      * NOTE: The stall map holds messages in the order in which they were
      * initially received, and when a line is unblocked, the messages are
-     * moved back to the m_prio_heap in the same order. This prevents starving
+     * moved back to the m_msg_queue in the same order. This prevents starving
      * older requests with younger ones.
      */
     StallMsgMapType m_stall_msg_map;
@@ -162,7 +196,7 @@ class MessageBuffer : public SimObject
      * Current size of the stall map.
      * Track the number of messages held in stall map lists. This is used to
      * ensure that if the buffer is finite-sized, it blocks further requests
-     * when the m_prio_heap and m_stall_msg_map contain m_max_size messages.
+     * when the m_msg_queue and m_stall_msg_map contain m_max_size messages.
      */
     int m_stall_map_size;
 
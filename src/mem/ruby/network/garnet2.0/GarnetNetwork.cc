@@ -33,9 +33,12 @@
 
 #include "mem/ruby/network/garnet2.0/GarnetNetwork.hh"
 
+#include <algorithm>
 #include <cassert>
 
+#include "base/bitfield.hh"
 #include "base/cast.hh"
+#include "base/intmath.hh"
 #include "base/stl_helpers.hh"
 #include "mem/ruby/common/NetDest.hh"
 #include "mem/ruby/network/MessageBuffer.hh"
@@ -57,7 +60,10 @@ using m5::stl_helpers::deletePointers;
  */
 
 GarnetNetwork::GarnetNetwork(const Params *p)
-    : Network(p)
+    : Network(p), m_active_scheduling(p->active_scheduling),
+      m_wheel(wheelSize), m_wheel_bits(0), m_wheel_cycle(0),
+      m_wheel_period(1),
+      m_wakeup_event([this]{ wakeupActive(); }, name() + ".activeWakeup")
 {
     m_num_rows = p->num_rows;
     m_ni_flit_size = p->ni_flit_size;
@@ -141,6 +147,124 @@ GarnetNetwork::init()
             router->printFaultVector(cout);
         }
     }
+
+    if (m_active_scheduling) {
+        m_wheel_period = clockPeriod();
+        for (auto router : m_routers)
+            attachScheduler(router);
+        for (auto ni : m_nis)
+            attachScheduler(ni);
+        for (auto link : m_networklinks)
+            attachScheduler(link);
+        for (auto link : m_creditlinks)
+            attachScheduler(link);
+    }
+}
+
+void
+GarnetNetwork::attachScheduler(Consumer *consumer)
+{
+    // Components simulated by another thread keep their own events
+    if (consumer->getEventQueue() == eventQueue())
+        consumer->setWakeupScheduler(this);
+}
+
+bool
+GarnetNetwork::inWheel(Tick when) const
+{
+    return when % m_wheel_period == 0 &&
+        when / m_wheel_period >= m_wheel_cycle &&
+        when / m_wheel_period - m_wheel_cycle < wheelSize;
+}
+
+void
+GarnetNetwork::scheduleWakeup(Consumer *consumer, Tick when)
+{
+    assert(when >= curTick());
+
+    // Restart the window at the current cycle after an idle period
+    if (!m_wheel_bits)
+        m_wheel_cycle = divCeil(curTick(), m_wheel_period);
+
+    if (inWheel(when)) {
+        unsigned idx = (when / m_wheel_period) % wheelSize;
+        m_wheel[idx].push_back(consumer);
+        m_wheel_bits |= 1ULL << idx;
+    } else {
+        m_far_wakeups[when].push_back(consumer);
+    }
+
+    if (!m_wakeup_event.scheduled())
+        schedule(m_wakeup_event, when);
+    else if (when < m_wakeup_event.when())
+        reschedule(m_wakeup_event, when);
+}
+
+bool
+GarnetNetwork::takeWakeups(Tick when, vector<Consumer *> &out)
+{
+    // Swap the bucket out, so that wakeups scheduled for this same tick
+    // while servicing it end up in a new bucket
+    if (inWheel(when)) {
+        unsigned idx = (when / m_wheel_period) % wheelSize;
+        if (m_wheel_bits & (1ULL << idx)) {
+            out.swap(m_wheel[idx]);
+            m_wheel_bits &= ~(1ULL << idx);
+            return true;
+        }
+    }
+
+    auto it = m_far_wakeups.find(when);
+    if (it != m_far_wakeups.end()) {
+        out.swap(it->second);
+        m_far_wakeups.erase(it);
+        return true;
+    }
+
+    return false;
+}
+
+void
+GarnetNetwork::wakeupActive()
+{
+    Tick now = curTick();
+
+    // Everything left on the wheel is at or after now
+    m_wheel_cycle = divCeil(now, m_wheel_period);
+
+    while (takeWakeups(now, m_active)) {
+        for (auto consumer : m_active)
+            consumer->wakeup();
+        m_active.clear();
+    }
+
+    scheduleNextWakeup();
+}
+
+void
+GarnetNetwork::scheduleNextWakeup()
+{
+    Tick next = MaxTick;
+
+    if (m_wheel_bits) {
+        // Rotate the bits so that bit 0 is the first cycle of the window
+        unsigned base = m_wheel_cycle % wheelSize;
+        uint64_t bits = base ? (m_wheel_bits >> base) |
+            (m_wheel_bits << (wheelSize - base)) : m_wheel_bits;
+        next = (m_wheel_cycle + findLsbSet(bits)) * m_wheel_period;
+    }
+    if (!m_far_wakeups.empty())
+        next = std::min(next, m_far_wakeups.begin()->first);
+
+    if (next == MaxTick) {
+        assert(!m_wakeup_event.scheduled());
+        return;
+    }
+
+    if (!m_wakeup_event.scheduled())
+        schedule(m_wakeup_event, next);
+    else if (m_wakeup_event.when() != next)
+        reschedule(m_wakeup_event, next);
 }
 
 GarnetNetwork::~GarnetNetwork()
@@ -35,8 +35,10 @@
 #define __MEM_RUBY_NETWORK_GARNET2_0_GARNETNETWORK_HH__
 
 #include <iostream>
+#include <map>
 #include <vector>
 
+#include "mem/ruby/common/Consumer.hh"
 #include "mem/ruby/network/Network.hh"
 #include "mem/ruby/network/fault_model/FaultModel.hh"
 #include "mem/ruby/network/garnet2.0/CommonTypes.hh"
@@ -49,7 +51,7 @@ class NetDest;
 class NetworkLink;
 class CreditLink;
 
-class GarnetNetwork : public Network
+class GarnetNetwork : public Network, public WakeupScheduler
 {
   public:
     typedef GarnetNetworkParams Params;
@@ -106,6 +108,9 @@ class GarnetNetwork : public Network
     void regStats();
     void print(std::ostream& out) const;
 
+    //! Queue the wakeup of a router, link or NI on the active list
+    void scheduleWakeup(Consumer *consumer, Tick when) override;
+
     // increment counters
     void increment_injected_packets(int vnet) { m_packets_injected[vnet]++; }
     void increment_received_packets(int vnet) { m_packets_received[vnet]++; }
@@ -195,6 +200,34 @@ class GarnetNetwork : public Network
     std::vector<NetworkLink *> m_networklinks; // All flit links in the network
     std::vector<CreditLink *> m_creditlinks; // All credit links in the network
     std::vector<NetworkInterface *> m_nis;   // All NI's in Network
+
+    /*
+     * Active scheduling: rather than one event per wakeup, the routers,
+     * links and NIs with work to do are queued on a time wheel with one
+     * bucket per network cycle, and a single event services them. Idle
+     * components are never visited. Wakeups that are not on a network
+     * clock edge, or beyond the wheel, go to m_far_wakeups.
+     */
+    void attachScheduler(Consumer *consumer);
+    bool inWheel(Tick when) const;
+    bool takeWakeups(Tick when, std::vector<Consumer *> &out);
+    void wakeupActive();
+    void scheduleNextWakeup();
+
+    static const unsigned wheelSize = 64;
+
+    bool m_active_scheduling;
+    //! Bucket i holds the wakeups of the cycles equal to i modulo
+    //! wheelSize, starting at m_wheel_cycle.
+    std::vector<std::vector<Consumer *> > m_wheel;
+    //! Bit i is set if bucket i is not empty.
+    uint64_t m_wheel_bits;
+    uint64_t m_wheel_cycle;
+    Tick m_wheel_period;
+    std::map<Tick, std::vector<Consumer *> > m_far_wakeups;
+    //! Consumers being woken up in the current tick
+    std::vector<Consumer *> m_active;
+    EventFunctionWrapper m_wakeup_event;
 };
 
 inline std::ostream&
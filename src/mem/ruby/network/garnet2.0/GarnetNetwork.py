@@ -48,6 +48,8 @@ class GarnetNetwork(RubyNetwork):
     fault_model = Param.FaultModel(NULL, "network fault model");
     garnet_deadlock_threshold = Param.UInt32(50000,
                               "network-level deadlock threshold")
+    active_scheduling = Param.Bool(True, "wake up the routers, links and "
+                                   "NIs from a single per-network event")
 
 class GarnetNetworkInterface(ClockedObject):
     type = 'GarnetNetworkInterface'
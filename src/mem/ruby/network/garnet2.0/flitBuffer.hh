@@ -35,8 +35,8 @@
 #define __MEM_RUBY_NETWORK_GARNET2_0_FLITBUFFER_HH__
 
 #include <algorithm>
+#include <deque>
 #include <iostream>
-#include <vector>
 
 #include "mem/ruby/network/garnet2.0/CommonTypes.hh"
 #include "mem/ruby/network/garnet2.0/flit.hh"
@@ -58,8 +58,7 @@ class flitBuffer
     getTopFlit()
     {
         flit *f = m_buffer.front();
-        std::pop_heap(m_buffer.begin(), m_buffer.end(), flit::greater);
-        m_buffer.pop_back();
+        m_buffer.pop_front();
         return f;
     }
 
@@ -72,14 +71,24 @@ class flitBuffer
     void
     insert(flit *flt)
     {
-        m_buffer.push_back(flt);
-        std::push_heap(m_buffer.begin(), m_buffer.end(), flit::greater);
+        // Flits nearly always arrive in time order, so appending is the
+        // common case. Equal flits keep their arrival order.
+        if (m_buffer.empty() || !flit::greater(m_buffer.back(), flt)) {
+            m_buffer.push_back(flt);
+        } else {
+            m_buffer.insert(std::upper_bound(m_buffer.begin(),
+                m_buffer.end(), flt,
+                [](flit *a, flit *b) { return flit::greater(b, a); }),
+                flt);
+        }
     }
 
     uint32_t functionalWrite(Packet *pkt);
 
   private:
-    std::vector<flit *> m_buffer;
+    //! Kept sorted by time then id, i.e., in the order the flits are
+    //! consumed, so that the top flit is always at the front.
+    std::deque<flit *> m_buffer;
     int max_size;
 };
 
@@ -0,0 +1,218 @@
+/*
+ * Copyright (c) 2018 The University of Illinois at Urbana-Champaign
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/ruby/profiler/AddressTracer.hh"
+
+#include <zlib.h>
+
+#include <chrono>
+
+#include "base/intmath.hh"
+#include "base/logging.hh"
+
+using namespace std;
+
+AddressTraceBuffer::AddressTraceBuffer(AddressTracer *tracer, uint32_t id,
+                                       size_t size)
+    : m_tracer(tracer), m_id(id), m_size(size), m_mask(size - 1),
+      m_records(size), m_head(0), m_tail_cache(0), m_full_stalls(0),
+      m_tail(0)
+{
+    assert(isPowerOf2(size));
+}
+
+void
+AddressTraceBuffer::waitForSpace(uint64_t head)
+{
+    m_full_stalls++;
+    do {
+        wakeDrainer();
+        this_thread::yield();
+        m_tail_cache = m_tail.load(memory_order_acquire);
+    } while (head - m_tail_cache >= m_size);
+}
+
+void
+AddressTraceBuffer::wakeDrainer()
+{
+    m_tracer->wake();
+}
+
+size_t
+AddressTraceBuffer::drain(vector<AddressTraceRecord> &out)
+{
+    uint64_t tail = m_tail.load(memory_order_relaxed);
+    uint64_t head = m_head.load(memory_order_acquire);
+    for (uint64_t i = tail; i != head; ++i)
+        out.push_back(m_records[i & m_mask]);
+    m_tail.store(head, memory_order_release);
+    return head - tail;
+}
+
+constexpr char AddressTracer::magic[8];
+const uint32_t AddressTracer::version;
+
+AddressTracer::AddressTracer(const string &filename, size_t buffer_size)
+    : m_filename(filename), m_buffer_size(ceilPow2(buffer_size)),
+      m_file(NULL), m_thread(NULL), m_stop(false), m_tracing(false),
+      m_num_records(0)
+{
+    if (buffer_size < 2)
+        fatal("Address trace buffers need at least two records\n");
+}
+
+AddressTracer::~AddressTracer()
+{
+    close();
+    for (auto &src : m_sources)
+        delete src.buffer;
+}
+
+AddressTraceBuffer *
+AddressTracer::registerSource(const string &name,
+                              const vector<string> &types,
+                              const vector<string> &states)
+{
+    if (m_file)
+        panic("Address trace source %s registered after start\n", name);
+
+    AddressTraceBuffer *buffer =
+        new AddressTraceBuffer(this, m_sources.size(), m_buffer_size);
+    m_sources.push_back({ name, types, states, buffer });
+    return buffer;
+}
+
+void
+AddressTracer::write(const void *data, size_t len)
+{
+    if (gzwrite((gzFile)m_file, data, len) != (int)len)
+        fatal("Write failed on address trace '%s'\n", m_filename);
+}
+
+void
+AddressTracer::writeString(const string &str)
+{
+    uint32_t len = str.size();
+    write(&len, sizeof(len));
+    write(str.data(), len);
+}
+
+void
+AddressTracer::start()
+{
+    if (m_file)
+        return;
+
+    // Favour speed over size, the drain thread must keep up with the
+    // simulation.
+    m_file = gzopen(m_filename.c_str(), "wb1");
+    if (m_file == NULL)
+        fatal("Can't open address trace '%s'\n", m_filename);
+
+    uint32_t num_sources = m_sources.size();
+    uint32_t record_size = sizeof(AddressTraceRecord);
+    write(magic, sizeof(magic));
+    write(&version, sizeof(version));
+    write(&record_size, sizeof(record_size));
+    write(&num_sources, sizeof(num_sources));
+    for (const auto &src : m_sources) {
+        writeString(src.name);
+        uint32_t num_types = src.types.size();
+        write(&num_types, sizeof(num_types));
+        for (const auto &type : src.types)
+            writeString(type);
+        uint32_t num_states = src.states.size();
+        write(&num_states, sizeof(num_states));
+        for (const auto &state : src.states)
+            writeString(state);
+    }
+
+    m_drained.reserve(m_buffer_size);
+    m_thread = new thread(&AddressTracer::drainLoop, this);
+    m_tracing = true;
+}
+
+void
+AddressTracer::drainLoop()
+{
+    while (!m_stop.load()) {
+        {
+            unique_lock<mutex> lock(m_mutex);
+            m_cond.wait_for(lock, chrono::milliseconds(10));
+        }
+        drainAll();
+    }
+}
+
+void
+AddressTracer::drainAll()
+{
+    // Each chunk is the source id, the number of records and the
+    // records themselves.
+    for (const auto &src : m_sources) {
+        m_drained.clear();
+        uint32_t count = src.buffer->drain(m_drained);
+        if (count == 0)
+            continue;
+        uint32_t id = src.buffer->getId();
+        write(&id, sizeof(id));
+        write(&count, sizeof(count));
+        write(m_drained.data(), count * sizeof(AddressTraceRecord));
+        m_num_records += count;
+    }
+}
+
+void
+AddressTracer::close()
+{
+    if (!m_file)
+        return;
+
+    m_tracing = false;
+    m_stop = true;
+    wake();
+    m_thread->join();
+    delete m_thread;
+    m_thread = NULL;
+
+    // Anything recorded after the last pass of the thread
+    drainAll();
+
+    if (gzclose((gzFile)m_file))
+        fatal("Close failed on address trace '%s'\n", m_filename);
+    m_file = NULL;
+
+    uint64_t full_stalls = 0;
+    for (const auto &src : m_sources)
+        full_stalls += src.buffer->getFullStalls();
+    inform("Address trace '%s': %d records\n", m_filename, m_num_records);
+    if (full_stalls) {
+        warn("Address trace buffers were full %d times, consider a larger "
+             "address_trace_buffer\n", full_stalls);
+    }
+}
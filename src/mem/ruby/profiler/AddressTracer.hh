@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) 2018 The University of Illinois at Urbana-Champaign
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Low overhead address and event tracing for Ruby. Every sequencer and
+ * controller appends fixed size records to its own single producer ring
+ * buffer, and a host thread drains the buffers into a gzipped file.
+ * Nothing is aggregated during simulation; util/ruby_addr_trace.py
+ * builds the hot line, hot PC and transition profiles offline.
+ */
+
+#ifndef __MEM_RUBY_PROFILER_ADDRESSTRACER_HH__
+#define __MEM_RUBY_PROFILER_ADDRESSTRACER_HH__
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "base/compiler.hh"
+#include "base/types.hh"
+
+class AddressTracer;
+
+struct AddressTraceRecord
+{
+    enum Kind : uint16_t {
+        //! A request issued by a sequencer; type is a RubyRequestType.
+        Request,
+        //! A controller transition; type is the event.
+        Transition,
+    };
+
+    uint64_t tick;
+    uint64_t addr;
+    uint64_t pc;
+    uint16_t kind;
+    uint16_t type;
+    uint16_t state;
+    uint16_t next_state;
+};
+
+/**
+ * Ring buffer of trace records with a single producer (the simulated
+ * object owning it) and a single consumer (the drain thread). A full
+ * buffer makes the producer wait for the drain thread, so that no
+ * record is ever lost.
+ */
+class AddressTraceBuffer
+{
+  public:
+    AddressTraceBuffer(AddressTracer *tracer, uint32_t id, size_t size);
+
+    void
+    recordRequest(Tick tick, Addr addr, Addr pc, int type)
+    {
+        if (tracing())
+            push({ tick, addr, pc, AddressTraceRecord::Request,
+                   (uint16_t)type, 0, 0 });
+    }
+
+    void
+    recordTransition(Tick tick, Addr addr, int event, int state,
+                     int next_state)
+    {
+        if (tracing())
+            push({ tick, addr, 0, AddressTraceRecord::Transition,
+                   (uint16_t)event, (uint16_t)state, (uint16_t)next_state });
+    }
+
+    /** Move all the available records to out (consumer side). */
+    size_t drain(std::vector<AddressTraceRecord> &out);
+
+    uint32_t getId() const { return m_id; }
+    uint64_t getFullStalls() const { return m_full_stalls; }
+
+  private:
+    inline bool tracing() const;
+
+    void
+    push(const AddressTraceRecord &rec)
+    {
+        uint64_t head = m_head.load(std::memory_order_relaxed);
+        if (head - m_tail_cache >= m_size) {
+            m_tail_cache = m_tail.load(std::memory_order_acquire);
+            if (head - m_tail_cache >= m_size)
+                waitForSpace(head);
+        }
+        m_records[head & m_mask] = rec;
+        m_head.store(head + 1, std::memory_order_release);
+
+        // Wake the drain thread early rather than at its next poll.
+        if (head - m_tail_cache == m_size / 2)
+            wakeDrainer();
+    }
+
+    void waitForSpace(uint64_t head);
+    void wakeDrainer();
+
+    AddressTracer *m_tracer;
+    const uint32_t m_id;
+    const size_t m_size;
+    const uint64_t m_mask;
+    std::vector<AddressTraceRecord> m_records;
+
+    //! Producer side state, padded away from the consumer's index to
+    //! avoid false sharing.
+    std::atomic<uint64_t> m_head;
+    uint64_t m_tail_cache;
+    uint64_t m_full_stalls;
+    char m_pad[64] M5_VAR_USED;
+
+    std::atomic<uint64_t> m_tail;
+};
+
+class AddressTracer
+{
+  public:
+    /**
+     * @param filename The gzipped output file.
+     * @param buffer_size Number of records in each buffer, rounded up to
+     *                    a power of two.
+     */
+    AddressTracer(const std::string &filename, size_t buffer_size);
+    ~AddressTracer();
+
+    /**
+     * Create the buffer of a trace source. The names translate the type
+     * and state fields of its records in the output file. All the
+     * sources must be registered before start().
+     */
+    AddressTraceBuffer *registerSource(const std::string &name,
+                                       const std::vector<std::string> &types,
+                                       const std::vector<std::string> &states);
+
+    /** Write the file header and start the drain thread. */
+    void start();
+    /** Drain all the buffers, stop the thread and close the file. */
+    void close();
+
+    void wake() { m_cond.notify_one(); }
+    //! Records are dropped before start() and after close().
+    bool tracing() const { return m_tracing; }
+
+  private:
+    struct Source
+    {
+        std::string name;
+        std::vector<std::string> types;
+        std::vector<std::string> states;
+        AddressTraceBuffer *buffer;
+    };
+
+    void drainLoop();
+    void drainAll();
+    void write(const void *data, size_t len);
+    void writeString(const std::string &str);
+
+    static constexpr char magic[8] = { 'R', 'U', 'B', 'Y',
+                                       'A', 'T', 'R', 'C' };
+    static const uint32_t version = 1;
+
+    const std::string m_filename;
+    const size_t m_buffer_size;
+    std::vector<Source> m_sources;
+
+    void *m_file;
+    std::thread *m_thread;
+    std::mutex m_mutex;
+    std::condition_variable m_cond;
+    std::atomic<bool> m_stop;
+    bool m_tracing;
+
+    //! Scratch space of the drain thread.
+    std::vector<AddressTraceRecord> m_drained;
+    uint64_t m_num_records;
+};
+
+inline bool
+AddressTraceBuffer::tracing() const
+{
+    return m_tracer->tracing();
+}
+
+#endif // __MEM_RUBY_PROFILER_ADDRESSTRACER_HH__
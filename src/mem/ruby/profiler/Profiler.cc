@@ -50,12 +50,14 @@
 #include <algorithm>
 #include <fstream>
 
+#include "base/output.hh"
 #include "base/stl_helpers.hh"
 #include "base/str.hh"
 #include "mem/protocol/MachineType.hh"
 #include "mem/protocol/RubyRequest.hh"
 #include "mem/ruby/network/Network.hh"
 #include "mem/ruby/profiler/AddressProfiler.hh"
+#include "mem/ruby/profiler/AddressTracer.hh"
 
 /**
  * the profiler uses GPUCoalescer code even
@@ -75,12 +77,14 @@
 #endif
 
 #include "mem/ruby/system/Sequencer.hh"
+#include "sim/core.hh"
 
 using namespace std;
 using m5::stl_helpers::operator<<;
 
 Profiler::Profiler(const RubySystemParams *p, RubySystem *rs)
-    : m_ruby_system(rs), m_hot_lines(p->hot_lines),
+    : m_ruby_system(rs), m_address_tracer_ptr(NULL),
+      m_hot_lines(p->hot_lines),
       m_all_instructions(p->all_instructions),
       m_num_vnets(p->number_of_virtual_networks)
 {
@@ -93,10 +97,28 @@ Profiler::Profiler(const RubySystemParams *p, RubySystem *rs)
         m_inst_profiler_ptr->setHotLines(m_hot_lines);
         m_inst_profiler_ptr->setAllInstructions(m_all_instructions);
     }
+
+    if (!p->address_trace.empty()) {
+        m_address_tracer_ptr =
+            new AddressTracer(simout.resolve(p->address_trace),
+                              p->address_trace_buffer);
+        // Simulated objects are not destroyed at exit, flush the trace
+        // from an exit callback instead.
+        registerExitCallback(new MakeCallback<AddressTracer,
+                             &AddressTracer::close>(m_address_tracer_ptr));
+    }
 }
 
 Profiler::~Profiler()
 {
+    delete m_address_tracer_ptr;
+}
+
+void
+Profiler::startAddressTrace()
+{
+    if (m_address_tracer_ptr)
+        m_address_tracer_ptr->start();
 }
 
 void
@@ -60,6 +60,7 @@
 
 class RubyRequest;
 class AddressProfiler;
+class AddressTracer;
 
 class Profiler
 {
@@ -75,6 +76,9 @@ class Profiler
 
     AddressProfiler* getAddressProfiler() { return m_address_profiler_ptr; }
     AddressProfiler* getInstructionProfiler() { return m_inst_profiler_ptr; }
+    //! The address tracer, NULL unless an address trace was requested.
+    AddressTracer* getAddressTracer() { return m_address_tracer_ptr; }
+    void startAddressTrace();
 
     void addAddressTraceSample(const RubyRequest& msg, NodeID id);
 
@@ -89,6 +93,7 @@ class Profiler
 
     AddressProfiler* m_address_profiler_ptr;
     AddressProfiler* m_inst_profiler_ptr;
+    AddressTracer* m_address_tracer_ptr;
 
     Stats::Histogram delayHistogram;
     std::vector<Stats::Histogram *> delayVCHistogram;
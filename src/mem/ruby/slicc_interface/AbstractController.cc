@@ -43,8 +43,10 @@
 #include "debug/RubyQueue.hh"
 #include "debug/MemSpecBuffer.hh"
 #include "mem/protocol/MemoryMsg.hh"
+#include "mem/ruby/common/DeferredEffects.hh"
 #include "mem/ruby/network/Network.hh"
 #include "mem/ruby/system/GPUCoalescer.hh"
+#include "mem/ruby/system/PresenceFilter.hh"
 #include "mem/ruby/system/RubySystem.hh"
 #include "mem/ruby/system/Sequencer.hh"
 #include "sim/system.hh"
@@ -52,7 +54,8 @@
 AbstractController::AbstractController(const Params *p)
     : MemObject(p), Consumer(this), m_version(p->version),
       m_clusterID(p->cluster_id),
-      m_masterId(p->system->getMasterId(name())), m_is_blocking(false),
+      m_masterId(p->system->getMasterId(name())), m_addr_trace(NULL),
+      m_presence(NULL), m_is_blocking(false),
       m_number_of_TBEs(p->number_of_TBEs),
       m_transitions_per_cycle(p->transitions_per_cycle),
       m_buffer_size(p->buffer_size), m_recycle_latency(p->recycle_latency),
@@ -70,6 +73,7 @@ void
 AbstractController::init()
 {
     params()->ruby_system->registerAbstractController(this);
+    m_presence = params()->ruby_system->getPresenceFilter();
     m_delayHistogram.init(10);
     uint32_t size = Network::getNumberOfVirtualNetworks();
     for (uint32_t i = 0; i < size; i++) {
@@ -258,6 +262,8 @@ AbstractController::queueMemoryRead(const MachineID &id, Addr addr,
     assert(sbeId >= -1 && sbeId <= 65);
     assert(coreId < 8);
     assert(type >=0 && type <= 2);
+    if (m_presence)
+        m_presence->insert(makeLineAddress(addr));
     if (type == 0) {
         for (int c = 0; c < 8; ++c) {
             for (int i = 0; i < 66; ++i) {
@@ -320,6 +326,7 @@ AbstractController::queueMemoryRead(const MachineID &id, Addr addr,
     s->coreId = coreId;
     s->sbeId = sbeId;
     pkt->pushSenderState(s);
+    trackMemoryReq(pkt);
 
     // Use functional rather than timing accesses during warmup
     if (RubySystem::getWarmupEnabled()) {
@@ -328,7 +335,7 @@ AbstractController::queueMemoryRead(const MachineID &id, Addr addr,
         return;
     }
 
-    memoryPort.schedTimingReq(pkt, clockEdge(latency));
+    schedMemoryReq(pkt, clockEdge(latency));
 }
 
 void
@@ -346,6 +353,8 @@ AbstractController::queueMemoryWrite(const MachineID &id, Addr addr,
 
     SenderState *s = new SenderState(id);
     pkt->pushSenderState(s);
+    trackMemoryReq(pkt);
+    clearSpecBufOnWrite(addr);
 
     // Use functional rather than timing accesses during warmup
     if (RubySystem::getWarmupEnabled()) {
@@ -355,7 +364,7 @@ AbstractController::queueMemoryWrite(const MachineID &id, Addr addr,
     }
 
     // Create a block and copy data from the block.
-    memoryPort.schedTimingReq(pkt, clockEdge(latency));
+    schedMemoryReq(pkt, clockEdge(latency));
 }
 
 void
@@ -372,9 +381,47 @@ AbstractController::queueMemoryWritePartial(const MachineID &id, Addr addr,
 
     SenderState *s = new SenderState(id);
     pkt->pushSenderState(s);
+    trackMemoryReq(pkt);
+    clearSpecBufOnWrite(addr);
 
     // Create a block and copy data from the block.
-    memoryPort.schedTimingReq(pkt, clockEdge(latency));
+    schedMemoryReq(pkt, clockEdge(latency));
+}
+
+void
+AbstractController::clearSpecBufOnWrite(Addr addr)
+{
+    // An expose must not return the data of a spec load older than
+    // the write.
+    Addr line = makeLineAddress(addr);
+    for (int c = 0; c < 8; ++c) {
+        for (int i = 0; i < 66; ++i) {
+            if (m_specBuf[c][i].address == line) {
+                DPRINTFR(MemSpecBuffer, "%10s Cleared by Write (core=%d, idx=%d, addr=%#x)\n", curTick(), c, i, printAddress(line));
+                m_specBuf[c][i].address = 0;
+                m_specBuf[c][i].data.clear();
+            }
+        }
+    }
+}
+
+void
+AbstractController::trackMemoryReq(PacketPtr pkt)
+{
+    if (m_presence) {
+        Addr line = makeLineAddress(pkt->getAddr());
+        m_presence->insert(line);
+        m_presence->memIssued(line);
+    }
+}
+
+void
+AbstractController::schedMemoryReq(PacketPtr pkt, Tick when)
+{
+    if (!DeferredEffects::defer([this, pkt, when]
+                                { memoryPort.schedTimingReq(pkt, when); })) {
+        memoryPort.schedTimingReq(pkt, when);
+    }
 }
 
 void
@@ -404,6 +451,9 @@ AbstractController::recvTimingResp(PacketPtr pkt)
     assert(getMemoryQueue());
     assert(pkt->isResponse());
 
+    if (m_presence)
+        m_presence->memCompleted(makeLineAddress(pkt->getAddr()));
+
     std::shared_ptr<MemoryMsg> msg = std::make_shared<MemoryMsg>(clockEdge());
     (*msg).m_addr = pkt->getAddr();
     (*msg).m_Sender = m_machineID;
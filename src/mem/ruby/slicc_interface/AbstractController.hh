@@ -50,6 +50,7 @@
 #include "mem/mem_object.hh"
 #include "mem/packet.hh"
 #include "mem/protocol/AccessPermission.hh"
+#include "mem/protocol/WarmState.hh"
 #include "mem/qport.hh"
 #include "mem/ruby/common/Address.hh"
 #include "mem/ruby/common/Consumer.hh"
@@ -57,11 +58,14 @@
 #include "mem/ruby/common/Histogram.hh"
 #include "mem/ruby/common/MachineID.hh"
 #include "mem/ruby/network/MessageBuffer.hh"
+#include "mem/ruby/profiler/AddressTracer.hh"
 #include "mem/ruby/system/CacheRecorder.hh"
+#include "mem/ruby/system/WarmupSnapshot.hh"
 #include "params/RubyController.hh"
 
 class Network;
 class GPUCoalescer;
+class PresenceFilter;
 
 // used to communicate that an in_port peeked the wrong message type
 class RejectException: public std::exception
@@ -94,11 +98,44 @@ class AbstractController : public MemObject, public Consumer
     virtual AccessPermission getAccessPermission(const Addr &addr) = 0;
 
     virtual void print(std::ostream & out) const = 0;
+    //! True for the controllers that access memory (directories)
+    bool isMemorySide() const { return memoryPort.isConnected(); }
     virtual void wakeup() = 0;
+    //! True if the protocol allows evaluating this controller in
+    //! parallel with the others woken up in the same tick (machine
+    //! parallel="yes" in SLICC), see ControllerScheduler.
+    virtual bool parallelSafe() const { return false; }
     virtual void resetStats() = 0;
     virtual void regStats();
 
     virtual void recordCacheTrace(int cntrl, CacheRecorder* tr) = 0;
+    virtual void recordWarmState(WarmupSnapshot *snapshot) = 0;
+
+    //! Functional warmup from a warm-state snapshot. A line is loaded
+    //! only if all the controllers can take it, and must then be stored
+    //! by the controllers it maps to; they return true if they hold a
+    //! copy of it. Protocols implement these as SLICC functions.
+    virtual bool
+    functionalWarmupAvail(const Addr &addr, const WarmState &state,
+                          const int &owner)
+    { return true; }
+    virtual bool
+    functionalWarmup(const Addr &addr, const WarmState &state,
+                     const int &owner, const DataBlock &data)
+    { return false; }
+    //! Replacement of the lines in the way of a functional warmup:
+    //! a controller with no space for addr returns the victim of its
+    //! replacement policy (addr if it has space or cannot replace), and
+    //! all the controllers are then told that the evictor dropped the
+    //! victim, data being its newest copy, already written to memory.
+    virtual Addr
+    functionalWarmupVictim(const Addr &addr, const WarmState &state,
+                           const int &owner)
+    { return addr; }
+    virtual void
+    functionalWarmupEvict(const Addr &addr, const MachineID &evictor,
+                          const DataBlock &data)
+    { }
     virtual Sequencer* getCPUSequencer() const = 0;
     virtual GPUCoalescer* getGPUCoalescer() const = 0;
 
@@ -181,6 +218,10 @@ class AbstractController : public MemObject, public Consumer
     const MasterID m_masterId;
 
     Network *m_net_ptr;
+    //! Address trace buffer of this controller, NULL if not tracing
+    AddressTraceBuffer *m_addr_trace;
+    //! Lines Ruby may hold, see RubySystem::functionalReadRange
+    PresenceFilter *m_presence;
     bool m_is_blocking;
     std::map<Addr, MessageBuffer*> m_block_map;
 
@@ -247,6 +288,14 @@ class AbstractController : public MemObject, public Consumer
     /* Master port to the memory controller. */
     MemoryPort memoryPort;
 
+    //! Send a request to memory, at the end of the tick during parallel
+    //! controller evaluation.
+    void schedMemoryReq(PacketPtr pkt, Tick when);
+    //! Keep the line in the presence filter until memory responds
+    void trackMemoryReq(PacketPtr pkt);
+    //! Drop the memory side spec buffer entries of a line being written
+    void clearSpecBufOnWrite(Addr addr);
+
     // State that is stored in packets sent to the memory controller.
     struct SenderState : public Packet::SenderState
     {
@@ -54,6 +54,11 @@ class AbstractReplacementPolicy : public SimObject
 
     virtual bool useOccupancy() const { return false; }
 
+    /* true if the victims only depend on the accesses to the cache,
+     * e.g., not on a random number generator, which the controllers
+     * evaluated in parallel cannot share */
+    virtual bool isDeterministic() const { return false; }
+
     void setCache(CacheMemory * pCache) {m_cache = pCache;}
     CacheMemory * m_cache;
 
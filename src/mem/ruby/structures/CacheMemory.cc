@@ -29,6 +29,8 @@
 
 #include "mem/ruby/structures/CacheMemory.hh"
 
+#include "base/bitfield.hh"
+#include "base/compiler.hh"
 #include "base/intmath.hh"
 #include "debug/RubyCache.hh"
 #include "debug/RubyCacheTrace.hh"
@@ -54,12 +56,16 @@ RubyCacheParams::create()
     return new CacheMemory(this);
 }
 
+const int CacheMemory::tagChunk;
+const uint32_t CacheMemory::invalidTag;
+
 CacheMemory::CacheMemory(const Params *p)
     : SimObject(p),
     dataArray(p->dataArrayBanks, p->dataAccessLatency,
               p->start_index_bit, p->ruby_system),
     tagArray(p->tagArrayBanks, p->tagAccessLatency,
-             p->start_index_bit, p->ruby_system)
+             p->start_index_bit, p->ruby_system),
+    m_ruby_system(p->ruby_system)
 {
     m_cache_size = p->size;
     m_cache_assoc = p->assoc;
@@ -82,19 +88,24 @@ CacheMemory::init()
     m_cache_num_set_bits = floorLog2(m_cache_num_sets);
     assert(m_cache_num_set_bits > 0);
 
-    m_cache.resize(m_cache_num_sets,
-                    std::vector<AbstractCacheEntry*>(m_cache_assoc, nullptr));
+    m_cache.resize(m_cache_num_sets * m_cache_assoc, nullptr);
+    m_packed_assoc = roundUp(m_cache_assoc, tagChunk);
+    m_tags.resize(m_cache_num_sets * m_packed_assoc, invalidTag);
+
+    // The controllers evaluated in parallel would draw from a shared
+    // random number generator in an order that differs between runs
+    fatal_if(m_ruby_system->getControllerThreads() > 0 &&
+             !m_replacementPolicy_ptr->isDeterministic(),
+             "%s: the replacement policy must be deterministic with "
+             "parallel controller evaluation\n", name());
 }
 
 CacheMemory::~CacheMemory()
 {
     if (m_replacementPolicy_ptr)
         delete m_replacementPolicy_ptr;
-    for (int i = 0; i < m_cache_num_sets; i++) {
-        for (int j = 0; j < m_cache_assoc; j++) {
-            delete m_cache[i][j];
-        }
-    }
+    for (auto entry : m_cache)
+        delete entry;
 }
 
 // convert a Address to its location in the cache
@@ -111,14 +122,11 @@ CacheMemory::addressToCacheSet(Addr address) const
 int
 CacheMemory::findTagInSet(int64_t cacheSet, Addr tag) const
 {
-    assert(tag == makeLineAddress(tag));
-    // search the set for the tags
-    auto it = m_tag_index.find(tag);
-    if (it != m_tag_index.end())
-        if (m_cache[cacheSet][it->second]->m_Permission !=
-            AccessPermission_NotPresent)
-            return it->second;
-    return -1; // Not found
+    int loc = findTagInSetIgnorePermissions(cacheSet, tag);
+    if (loc != -1 &&
+        entryAt(cacheSet, loc)->m_Permission == AccessPermission_NotPresent)
+        return -1;
+    return loc;
 }
 
 // Given a cache index: returns the index of the tag in a set.
@@ -128,11 +136,26 @@ CacheMemory::findTagInSetIgnorePermissions(int64_t cacheSet,
                                            Addr tag) const
 {
     assert(tag == makeLineAddress(tag));
-    // search the set for the tags
-    auto it = m_tag_index.find(tag);
-    if (it != m_tag_index.end())
-        return it->second;
-    return -1; // Not found
+    // Compare the packed tags of all the ways, then the addresses of
+    // the entries that match. A line is in at most one way, allocate()
+    // reuses a NotPresent way that still holds it.
+    const uint32_t key = packTag(tag);
+    const TagChunk keys = { key, key, key, key };
+    const uint32_t *tags = &m_tags[cacheSet * m_packed_assoc];
+    int loc = -1; // Not found
+    for (int way = 0; way < m_packed_assoc; way += tagChunk) {
+        unsigned match = matchTags(tags + way, keys);
+        while (match) {
+            int i = way + findLsbSet(match);
+            if (i < m_cache_assoc && entryAt(cacheSet, i) &&
+                entryAt(cacheSet, i)->m_Address == tag) {
+                assert(loc == -1);
+                loc = i;
+            }
+            match &= match - 1;
+        }
+    }
+    return loc;
 }
 
 // Given an unique cache block identifier (idx): return the valid address
@@ -149,7 +172,7 @@ CacheMemory::getAddressAtIdx(int idx) const
     int way = idx - set * m_cache_assoc;
     assert (way < m_cache_assoc);
 
-    AbstractCacheEntry* entry = m_cache[set][way];
+    AbstractCacheEntry* entry = entryAt(set, way);
     if (entry == NULL ||
         entry->m_Permission == AccessPermission_Invalid ||
         entry->m_Permission == AccessPermission_NotPresent) {
@@ -168,7 +191,7 @@ CacheMemory::tryCacheAccess(Addr address, RubyRequestType type,
     int loc = findTagInSet(cacheSet, address);
     if (loc != -1) {
         // Do we even have a tag match?
-        AbstractCacheEntry* entry = m_cache[cacheSet][loc];
+        AbstractCacheEntry* entry = entryAt(cacheSet, loc);
         m_replacementPolicy_ptr->touch(cacheSet, loc, curTick());
         data_ptr = &(entry->getDataBlk());
 
@@ -198,11 +221,11 @@ CacheMemory::testCacheAccess(Addr address, RubyRequestType type,
 
     if (loc != -1) {
         // Do we even have a tag match?
-        AbstractCacheEntry* entry = m_cache[cacheSet][loc];
+        AbstractCacheEntry* entry = entryAt(cacheSet, loc);
         m_replacementPolicy_ptr->touch(cacheSet, loc, curTick());
         data_ptr = &(entry->getDataBlk());
 
-        return m_cache[cacheSet][loc]->m_Permission !=
+        return entryAt(cacheSet, loc)->m_Permission !=
             AccessPermission_NotPresent;
     }
 
@@ -238,7 +261,7 @@ CacheMemory::cacheAvail(Addr address) const
     int64_t cacheSet = addressToCacheSet(address);
 
     for (int i = 0; i < m_cache_assoc; i++) {
-        AbstractCacheEntry* entry = m_cache[cacheSet][i];
+        AbstractCacheEntry* entry = entryAt(cacheSet, i);
         if (entry != NULL) {
             if (entry->m_Address == address ||
                 entry->m_Permission == AccessPermission_NotPresent) {
@@ -260,10 +283,12 @@ CacheMemory::allocate(Addr address, AbstractCacheEntry *entry, bool touch)
     assert(cacheAvail(address));
     DPRINTF(RubyCache, "address: %#x\n", address);
 
-    // Find the first open slot
+    // Find the NotPresent way still tagged with the address, or else
+    // the first open slot, so that a tag is never in two ways
     int64_t cacheSet = addressToCacheSet(address);
-    std::vector<AbstractCacheEntry*> &set = m_cache[cacheSet];
-    for (int i = 0; i < m_cache_assoc; i++) {
+    AbstractCacheEntry **set = &m_cache[cacheSet * m_cache_assoc];
+    int stale = findTagInSetIgnorePermissions(cacheSet, address);
+    for (int i = stale != -1 ? stale : 0; i < m_cache_assoc; i++) {
         if (!set[i] || set[i]->m_Permission == AccessPermission_NotPresent) {
             if (set[i] && (set[i] != entry)) {
                 warn_once("This protocol contains a cache entry handling bug: "
@@ -278,7 +303,7 @@ CacheMemory::allocate(Addr address, AbstractCacheEntry *entry, bool touch)
             DPRINTF(RubyCache, "Allocate clearing lock for addr: %x\n",
                     address);
             set[i]->m_locked = -1;
-            m_tag_index[address] = i;
+            tagAt(cacheSet, i) = packTag(address);
             entry->setSetIndex(cacheSet);
             entry->setWayIndex(i);
 
@@ -301,9 +326,9 @@ CacheMemory::deallocate(Addr address)
     int64_t cacheSet = addressToCacheSet(address);
     int loc = findTagInSet(cacheSet, address);
     if (loc != -1) {
-        delete m_cache[cacheSet][loc];
-        m_cache[cacheSet][loc] = NULL;
-        m_tag_index.erase(address);
+        delete entryAt(cacheSet, loc);
+        entryAt(cacheSet, loc) = NULL;
+        tagAt(cacheSet, loc) = invalidTag;
     }
 }
 
@@ -315,7 +340,7 @@ CacheMemory::cacheProbe(Addr address) const
     assert(!cacheAvail(address));
 
     int64_t cacheSet = addressToCacheSet(address);
-    return m_cache[cacheSet][m_replacementPolicy_ptr->getVictim(cacheSet)]->
+    return entryAt(cacheSet, m_replacementPolicy_ptr->getVictim(cacheSet))->
         m_Address;
 }
 
@@ -327,7 +352,7 @@ CacheMemory::lookup(Addr address)
     int64_t cacheSet = addressToCacheSet(address);
     int loc = findTagInSet(cacheSet, address);
     if (loc == -1) return NULL;
-    return m_cache[cacheSet][loc];
+    return entryAt(cacheSet, loc);
 }
 
 // looks an address up in the cache
@@ -338,7 +363,7 @@ CacheMemory::lookup(Addr address) const
     int64_t cacheSet = addressToCacheSet(address);
     int loc = findTagInSet(cacheSet, address);
     if (loc == -1) return NULL;
-    return m_cache[cacheSet][loc];
+    return entryAt(cacheSet, loc);
 }
 
 // Sets the most recently used bit for a cache block
@@ -383,8 +408,8 @@ CacheMemory::getReplacementWeight(int64_t set, int64_t loc)
     assert(set < m_cache_num_sets);
     assert(loc < m_cache_assoc);
     int ret = 0;
-    if (m_cache[set][loc] != NULL) {
-        ret = m_cache[set][loc]->getNumValidBlocks();
+    if (entryAt(set, loc) != NULL) {
+        ret = entryAt(set, loc)->getNumValidBlocks();
         assert(ret >= 0);
     }
 
@@ -400,8 +425,8 @@ CacheMemory::recordCacheContents(int cntrl, CacheRecorder* tr) const
 
     for (int i = 0; i < m_cache_num_sets; i++) {
         for (int j = 0; j < m_cache_assoc; j++) {
-            if (m_cache[i][j] != NULL) {
-                AccessPermission perm = m_cache[i][j]->m_Permission;
+            if (entryAt(i, j) != NULL) {
+                AccessPermission perm = entryAt(i, j)->m_Permission;
                 RubyRequestType request_type = RubyRequestType_NULL;
                 if (perm == AccessPermission_Read_Only) {
                     if (m_is_instruction_only_cache) {
@@ -414,10 +439,10 @@ CacheMemory::recordCacheContents(int cntrl, CacheRecorder* tr) const
                 }
 
                 if (request_type != RubyRequestType_NULL) {
-                    tr->addRecord(cntrl, m_cache[i][j]->m_Address,
+                    tr->addRecord(cntrl, entryAt(i, j)->m_Address,
                                   0, request_type,
                                   m_replacementPolicy_ptr->getLastAccess(i, j),
-                                  m_cache[i][j]->getDataBlk());
+                                  entryAt(i, j)->getDataBlk());
                     warmedUpBlocks++;
                 }
             }
@@ -429,16 +454,53 @@ CacheMemory::recordCacheContents(int cntrl, CacheRecorder* tr) const
             totalBlocks, (float(warmedUpBlocks) / float(totalBlocks)) * 100.0);
 }
 
+void
+CacheMemory::recordWarmState(int owner, WarmupSnapshot *snapshot) const
+{
+    uint64_t recordedBlocks = 0;
+
+    for (int i = 0; i < m_cache_num_sets; i++) {
+        for (int j = 0; j < m_cache_assoc; j++) {
+            AbstractCacheEntry *entry = entryAt(i, j);
+            if (entry == NULL)
+                continue;
+
+            // A shared cache may only have a stale copy of lines written
+            // by a core; the core's own record holds the data then.
+            WarmState state;
+            switch (entry->m_Permission) {
+              case AccessPermission_Read_Only:
+                state = m_is_instruction_only_cache ?
+                    WarmState_Instruction : WarmState_Shared;
+                break;
+              case AccessPermission_Read_Write:
+              case AccessPermission_Maybe_Stale:
+                state = WarmState_Exclusive;
+                break;
+              default:
+                continue;
+            }
+
+            snapshot->addRecord(entry->m_Address, state, owner,
+                                entry->getDataBlk());
+            recordedBlocks++;
+        }
+    }
+
+    DPRINTF(RubyCacheTrace, "%s: %lli blocks recorded in the warm-state "
+            "snapshot\n", name(), recordedBlocks);
+}
+
 void
 CacheMemory::print(ostream& out) const
 {
     out << "Cache dump: " << name() << endl;
     for (int i = 0; i < m_cache_num_sets; i++) {
         for (int j = 0; j < m_cache_assoc; j++) {
-            if (m_cache[i][j] != NULL) {
+            if (entryAt(i, j) != NULL) {
                 out << "  Index: " << i
                     << " way: " << j
-                    << " entry: " << *m_cache[i][j] << endl;
+                    << " entry: " << *entryAt(i, j) << endl;
             } else {
                 out << "  Index: " << i
                     << " way: " << j
@@ -462,7 +524,7 @@ CacheMemory::setLocked(Addr address, int context)
     int64_t cacheSet = addressToCacheSet(address);
     int loc = findTagInSet(cacheSet, address);
     assert(loc != -1);
-    m_cache[cacheSet][loc]->setLocked(context);
+    entryAt(cacheSet, loc)->setLocked(context);
 }
 
 void
@@ -473,7 +535,7 @@ CacheMemory::clearLocked(Addr address)
     int64_t cacheSet = addressToCacheSet(address);
     int loc = findTagInSet(cacheSet, address);
     assert(loc != -1);
-    m_cache[cacheSet][loc]->clearLocked();
+    entryAt(cacheSet, loc)->clearLocked();
 }
 
 bool
@@ -484,8 +546,8 @@ CacheMemory::isLocked(Addr address, int context)
     int loc = findTagInSet(cacheSet, address);
     assert(loc != -1);
     DPRINTF(RubyCache, "Testing Lock for addr: %#llx cur %d con %d\n",
-            address, m_cache[cacheSet][loc]->m_locked, context);
-    return m_cache[cacheSet][loc]->isLocked(context);
+            address, entryAt(cacheSet, loc)->m_locked, context);
+    return entryAt(cacheSet, loc)->isLocked(context);
 }
 
 void
@@ -647,11 +709,11 @@ CacheMemory::checkResourceAvailable(CacheResourceType res, Addr addr)
 bool
 CacheMemory::isBlockInvalid(int64_t cache_set, int64_t loc)
 {
-  return (m_cache[cache_set][loc]->m_Permission == AccessPermission_Invalid);
+  return (entryAt(cache_set, loc)->m_Permission == AccessPermission_Invalid);
 }
 
 bool
 CacheMemory::isBlockNotBusy(int64_t cache_set, int64_t loc)
 {
-  return (m_cache[cache_set][loc]->m_Permission != AccessPermission_Busy);
+  return (entryAt(cache_set, loc)->m_Permission != AccessPermission_Busy);
 }
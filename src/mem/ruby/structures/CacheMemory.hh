@@ -30,6 +30,7 @@
 #ifndef __MEM_RUBY_STRUCTURES_CACHEMEMORY_HH__
 #define __MEM_RUBY_STRUCTURES_CACHEMEMORY_HH__
 
+#include <cstring>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -44,9 +45,12 @@
 #include "mem/ruby/structures/AbstractReplacementPolicy.hh"
 #include "mem/ruby/structures/BankedArray.hh"
 #include "mem/ruby/system/CacheRecorder.hh"
+#include "mem/ruby/system/WarmupSnapshot.hh"
 #include "params/RubyCache.hh"
 #include "sim/sim_object.hh"
 
+class RubySystem;
+
 class CacheMemory : public SimObject
 {
   public:
@@ -103,6 +107,7 @@ class CacheMemory : public SimObject
 
     // Hook for checkpointing the contents of the cache
     void recordCacheContents(int cntrl, CacheRecorder* tr) const;
+    void recordWarmState(int owner, WarmupSnapshot *snapshot) const;
 
     // Set this address to most recently used
     void setMRU(Addr address);
@@ -168,16 +173,68 @@ class CacheMemory : public SimObject
     // Data Members (m_prefix)
     bool m_is_instruction_only_cache;
 
-    // The first index is the # of cache lines.
-    // The second index is the the amount associativity.
-    std::unordered_map<Addr, int> m_tag_index;
-    std::vector<std::vector<AbstractCacheEntry*> > m_cache;
+    // The entries and the packed tags of the cache, stored set after
+    // set. Lookups compare the tags of a set, which are contiguous,
+    // tagChunk ways at a time with SIMD instructions, and only check
+    // the entries of the ways that match. The ways of a set are padded
+    // to m_packed_assoc, a multiple of tagChunk.
+    std::vector<AbstractCacheEntry*> m_cache;
+    std::vector<uint32_t> m_tags;
+    int m_packed_assoc;
+
+    static const int tagChunk = 4;
+
+    // Tag of the ways without an entry and of the padding. A line may
+    // pack to it too, matches are always checked against the entries.
+    static const uint32_t invalidTag = ~(uint32_t)0;
+
+    // The bits of a line address above the set index, truncated to 32
+    // bits, so distinct lines of a set may share a packed tag
+    uint32_t
+    packTag(Addr line) const
+    {
+        return line >> (m_start_index_bit + m_cache_num_set_bits);
+    }
+
+    uint32_t &
+    tagAt(int64_t set, int way)
+    {
+        return m_tags[set * m_packed_assoc + way];
+    }
+
+    // Four packed tags
+    typedef uint32_t TagChunk __attribute__((vector_size(16)));
+
+    // Compare tagChunk packed tags to a key, keys holds it in every
+    // lane. Returns a mask of the ways that match.
+    static unsigned
+    matchTags(const uint32_t *tags, TagChunk keys)
+    {
+        TagChunk chunk;
+        memcpy(&chunk, tags, sizeof(chunk));
+        TagChunk eq = (TagChunk)(chunk == keys);
+        return (eq[0] & 1) | (eq[1] & 2) | (eq[2] & 4) | (eq[3] & 8);
+    }
+
+    AbstractCacheEntry *&
+    entryAt(int64_t set, int way)
+    {
+        return m_cache[set * m_cache_assoc + way];
+    }
+
+    AbstractCacheEntry *
+    entryAt(int64_t set, int way) const
+    {
+        return m_cache[set * m_cache_assoc + way];
+    }
 
     AbstractReplacementPolicy *m_replacementPolicy_ptr;
 
     BankedArray dataArray;
     BankedArray tagArray;
 
+    RubySystem *m_ruby_system;
+
     int m_cache_size;
     int m_cache_num_sets;
     int m_cache_num_set_bits;
@@ -43,6 +43,7 @@ class LRUPolicy : public AbstractReplacementPolicy
 
     void touch(int64_t set, int64_t way, Tick time);
     int64_t getVictim(int64_t set) const;
+    bool isDeterministic() const override { return true; }
 };
 
 #endif // __MEM_RUBY_STRUCTURES_LRUPOLICY_HH__
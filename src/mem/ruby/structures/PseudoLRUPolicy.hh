@@ -55,6 +55,7 @@ class PseudoLRUPolicy : public AbstractReplacementPolicy
 
     void touch(int64_t set, int64_t way, Tick time);
     int64_t getVictim(int64_t set) const;
+    bool isDeterministic() const override { return true; }
 
   private:
     unsigned int m_effective_assoc;    /** nearest (to ceiling) power of 2 */
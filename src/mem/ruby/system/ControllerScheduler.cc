@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) 2018 The University of Illinois at Urbana-Champaign
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "mem/ruby/system/ControllerScheduler.hh"
+
+#include "base/cast.hh"
+#include "base/logging.hh"
+#include "mem/ruby/slicc_interface/AbstractController.hh"
+
+using namespace std;
+
+ControllerScheduler::ControllerScheduler(const string &name, EventManager *em,
+                                         unsigned num_threads, bool check)
+    : m_name(name), m_em(em), m_eq(em->eventQueue()), m_check(check),
+      m_num_tasks(0), m_next_task(0), m_barrier(num_threads),
+      m_stop(false), m_event([this]{ process(); }, name)
+{
+    assert(num_threads > 0);
+
+    // The simulation thread is one of the evaluation threads
+    for (unsigned i = 1; i < num_threads; ++i) {
+        m_threads.push_back(
+            new thread(&ControllerScheduler::workerLoop, this));
+    }
+}
+
+ControllerScheduler::~ControllerScheduler()
+{
+    if (!m_threads.empty()) {
+        m_stop = true;
+        m_barrier.wait();
+        for (auto t : m_threads) {
+            t->join();
+            delete t;
+        }
+    }
+}
+
+void
+ControllerScheduler::attach(AbstractController *ctrl)
+{
+    assert(ctrl->parallelSafe());
+    if (ctrl->getEventQueue() == m_eq)
+        ctrl->setWakeupScheduler(this);
+}
+
+void
+ControllerScheduler::scheduleWakeup(Consumer *consumer, Tick when)
+{
+    m_wakeups[when].push_back(safe_cast<AbstractController *>(consumer));
+
+    if (!m_event.scheduled())
+        m_em->schedule(m_event, when);
+    else if (when < m_event.when())
+        m_em->reschedule(m_event, when);
+}
+
+void
+ControllerScheduler::workerLoop()
+{
+    curEventQueue(m_eq);
+
+    while (true) {
+        m_barrier.wait();
+        if (m_stop)
+            break;
+        evaluate();
+        m_barrier.wait();
+    }
+}
+
+void
+ControllerScheduler::evaluate()
+{
+    size_t i;
+    while ((i = m_next_task++) < m_num_tasks) {
+        Task &task = m_tasks[i];
+        DeferredEffects::setCurrent(&task.effects);
+        task.ctrl->wakeup();
+        DeferredEffects::setCurrent(NULL);
+    }
+}
+
+void
+ControllerScheduler::process()
+{
+    auto it = m_wakeups.begin();
+    assert(it != m_wakeups.end() && it->first == curTick());
+
+    m_num_tasks = it->second.size();
+    if (m_tasks.size() < m_num_tasks)
+        m_tasks.resize(m_num_tasks);
+    for (size_t i = 0; i < m_num_tasks; ++i)
+        m_tasks[i].ctrl = it->second[i];
+    m_wakeups.erase(it);
+    m_next_task = 0;
+
+    // Evaluating a single controller on the simulation thread is
+    // cheaper than waking up the pool
+    if (m_threads.empty() || m_num_tasks == 1) {
+        evaluate();
+    } else {
+        m_barrier.wait();
+        evaluate();
+        m_barrier.wait();
+    }
+
+    commit();
+
+    // The effects may have scheduled more wakeups, possibly in this
+    // same tick
+    if (!m_wakeups.empty()) {
+        Tick next = m_wakeups.begin()->first;
+        if (!m_event.scheduled())
+            m_em->schedule(m_event, next);
+        else if (m_event.when() != next)
+            m_em->reschedule(m_event, next);
+    }
+}
+
+void
+ControllerScheduler::commit()
+{
+    for (size_t i = 0; i < m_num_tasks; ++i) {
+        for (auto &entry : m_tasks[i].effects) {
+            if (m_check && entry.target)
+                checkEffect(entry, i);
+            entry.effect();
+        }
+        m_tasks[i].effects.clear();
+    }
+
+    m_targets.clear();
+    m_num_tasks = 0;
+}
+
+void
+ControllerScheduler::checkEffect(const DeferredEffects::Entry &entry,
+                                 size_t task)
+{
+    auto res = m_targets.emplace(make_pair(entry.target, entry.when), task);
+    if (!res.second && res.first->second != task) {
+        panic("%s: %s and %s have effects on the same object for tick %d, "
+              "the result depends on the order they are evaluated in\n",
+              m_name, m_tasks[res.first->second].ctrl->name(),
+              m_tasks[task].ctrl->name(), entry.when);
+    }
+}
@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2018 The University of Illinois at Urbana-Champaign
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/*
+ * Parallel evaluation of the Ruby controllers woken up in the same tick.
+ *
+ * Controllers only see each other through message buffers, and a
+ * message is never visible before the tick after it is enqueued. The
+ * controllers woken up in a tick are hence independent: they are
+ * evaluated concurrently on a pool of host threads, while all their
+ * effects outside of themselves (enqueues, wakeups, responses to the
+ * CPUs, memory requests) are deferred (see DeferredEffects). At the end
+ * of the tick, the simulation thread performs the effects controller by
+ * controller, in the order the controllers were woken up. The result
+ * does not depend on the number of threads.
+ */
+
+#ifndef __MEM_RUBY_SYSTEM_CONTROLLERSCHEDULER_HH__
+#define __MEM_RUBY_SYSTEM_CONTROLLERSCHEDULER_HH__
+
+#include <atomic>
+#include <map>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "base/barrier.hh"
+#include "mem/ruby/common/Consumer.hh"
+#include "mem/ruby/common/DeferredEffects.hh"
+#include "sim/eventq.hh"
+
+class AbstractController;
+
+class ControllerScheduler : public WakeupScheduler
+{
+  public:
+    /**
+     * @param em Object the evaluation events are scheduled on.
+     * @param num_threads Host threads evaluating the controllers,
+     *                    including the simulation thread.
+     * @param check Panic if the effects of two controllers in the same
+     *              tick do not commute, i.e., if the result could differ
+     *              from a serial evaluation in another order.
+     */
+    ControllerScheduler(const std::string &name, EventManager *em,
+                        unsigned num_threads, bool check);
+    ~ControllerScheduler();
+
+    //! Evaluate the controller with the others from now on
+    void attach(AbstractController *ctrl);
+
+    void scheduleWakeup(Consumer *consumer, Tick when) override;
+
+  private:
+    struct Task
+    {
+        AbstractController *ctrl;
+        std::vector<DeferredEffects::Entry> effects;
+    };
+
+    void process();
+    void evaluate();
+    void commit();
+    void workerLoop();
+    void checkEffect(const DeferredEffects::Entry &entry, size_t task);
+
+    const std::string m_name;
+    EventManager *m_em;
+    EventQueue *m_eq;
+    const bool m_check;
+
+    //! Controllers to wake up, by tick, in the order of the wakeups
+    std::map<Tick, std::vector<AbstractController *> > m_wakeups;
+    //! Controllers of the tick being evaluated, and their effects
+    std::vector<Task> m_tasks;
+    size_t m_num_tasks;
+    std::atomic<size_t> m_next_task;
+
+    std::vector<std::thread *> m_threads;
+    Barrier m_barrier;
+    bool m_stop;
+
+    //! Check mode: controller that had an effect on each target
+    std::map<std::pair<const void *, Tick>, size_t> m_targets;
+
+    EventFunctionWrapper m_event;
+};
+
+#endif // __MEM_RUBY_SYSTEM_CONTROLLERSCHEDULER_HH__
@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2018 The University of Illinois at Urbana-Champaign
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/ruby/system/PresenceFilter.hh"
+
+#include <cassert>
+
+#include "base/bitfield.hh"
+
+using namespace std;
+
+const unsigned PresenceFilter::regionLinesBits;
+const unsigned PresenceFilter::regionLines;
+
+PresenceFilter::PresenceFilter(uint32_t block_size_bits)
+    : m_line_bits(block_size_bits)
+{
+}
+
+void
+PresenceFilter::insert(Addr line)
+{
+    Addr index = line >> m_line_bits;
+
+    lock_guard<mutex> lock(m_mutex);
+    m_regions[index >> regionLinesBits] |=
+        ULL(1) << (index & (regionLines - 1));
+}
+
+void
+PresenceFilter::remove(Addr line)
+{
+    Addr index = line >> m_line_bits;
+
+    lock_guard<mutex> lock(m_mutex);
+    if (m_mem_pending.count(line))
+        return;
+
+    auto it = m_regions.find(index >> regionLinesBits);
+    if (it == m_regions.end())
+        return;
+    it->second &= ~(ULL(1) << (index & (regionLines - 1)));
+    if (it->second == 0)
+        m_regions.erase(it);
+}
+
+void
+PresenceFilter::memIssued(Addr line)
+{
+    lock_guard<mutex> lock(m_mutex);
+    m_mem_pending[line]++;
+}
+
+void
+PresenceFilter::memCompleted(Addr line)
+{
+    lock_guard<mutex> lock(m_mutex);
+    auto it = m_mem_pending.find(line);
+    assert(it != m_mem_pending.end());
+    if (--it->second == 0)
+        m_mem_pending.erase(it);
+}
+
+Addr
+PresenceFilter::findPresent(Addr start, Addr end) const
+{
+    assert(start < end);
+    Addr index = start >> m_line_bits;
+    Addr last = (end - 1) >> m_line_bits;
+
+    lock_guard<mutex> lock(m_mutex);
+    while (index <= last && !m_regions.empty()) {
+        Addr region = index >> regionLinesBits;
+        auto it = m_regions.find(region);
+        if (it != m_regions.end()) {
+            uint64_t lines = it->second >> (index & (regionLines - 1));
+            if (lines) {
+                index += findLsbSet(lines);
+                return index <= last ? index << m_line_bits : end;
+            }
+        }
+        index = (region + 1) << regionLinesBits;
+    }
+    return end;
+}
@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2018 The University of Illinois at Urbana-Champaign
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Conservative record of the lines Ruby may hold a copy of. A line
+ * enters the filter when a controller reads or writes it in memory, or
+ * when a snapshot loads it into the caches, and leaves it only when a
+ * functional access finds that no cache holds it and no memory access
+ * to it is in flight. The backing store of memory is up to date for
+ * all the lines outside of the filter, so functional accesses to them
+ * do not need to look at the controllers.
+ */
+
+#ifndef __MEM_RUBY_SYSTEM_PRESENCEFILTER_HH__
+#define __MEM_RUBY_SYSTEM_PRESENCEFILTER_HH__
+
+#include <mutex>
+#include <unordered_map>
+
+#include "base/types.hh"
+
+class PresenceFilter
+{
+  public:
+    PresenceFilter(uint32_t block_size_bits);
+
+    //! A controller may now hold a copy of the line
+    void insert(Addr line);
+    //! Drop a line no controller holds, unless memory accesses to it
+    //! are still in flight
+    void remove(Addr line);
+
+    //! Accesses of the controllers to memory, a line is kept in the
+    //! filter while some are outstanding
+    void memIssued(Addr line);
+    void memCompleted(Addr line);
+
+    /**
+     * Find the first line of [start, end) that is in the filter.
+     *
+     * @return The address of the line, or end if there is none.
+     */
+    Addr findPresent(Addr start, Addr end) const;
+
+  private:
+    //! Lines are tracked by regions of 64, one bit per line
+    static const unsigned regionLinesBits = 6;
+    static const unsigned regionLines = 1 << regionLinesBits;
+
+    const uint32_t m_line_bits;
+
+    std::unordered_map<Addr, uint64_t> m_regions;
+    std::unordered_map<Addr, unsigned> m_mem_pending;
+
+    //! Controllers on different event queues update the filter
+    //! concurrently in parallel mode
+    mutable std::mutex m_mutex;
+};
+
+#endif // __MEM_RUBY_SYSTEM_PRESENCEFILTER_HH__
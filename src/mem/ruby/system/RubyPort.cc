@@ -46,6 +46,7 @@
 #include "debug/Drain.hh"
 #include "debug/Ruby.hh"
 #include "mem/protocol/AccessPermission.hh"
+#include "mem/ruby/common/DeferredEffects.hh"
 #include "mem/ruby/slicc_interface/AbstractController.hh"
 #include "mem/simple_mem.hh"
 #include "sim/full_system.hh"
@@ -55,6 +56,7 @@ RubyPort::RubyPort(const Params *p)
     : MemObject(p), m_ruby_system(p->ruby_system), m_version(p->version),
       m_controller(NULL), m_mandatory_q_ptr(NULL),
       m_usingRubyTester(p->using_ruby_tester), system(p->system),
+      m_backing_store(p->system->getPhysMem().getBackingStore()),
       pioMasterPort(csprintf("%s.pio-master-port", name()), this),
       pioSlavePort(csprintf("%s.pio-slave-port", name()), this),
       memMasterPort(csprintf("%s.mem-master-port", name()), this),
@@ -355,7 +357,16 @@ RubyPort::MemSlavePort::recvAtomic(PacketPtr pkt)
     RubySystem *rs = ruby_port->m_ruby_system;
     AbstractController *directory =
         rs->m_abstract_controls[id.getType()][id.getNum()];
-    return directory->recvAtomic(pkt);
+    Tick latency = directory->recvAtomic(pkt);
+
+    // Warm the caches of the core with the line, the CPU only flags
+    // the accesses of its warmup window
+    if (pkt->isWarmup() && pkt->cmd != MemCmd::MemFenceReq &&
+        ruby_port->m_controller->getCPUSequencer() != NULL) {
+        rs->atomicWarmup(pkt, ruby_port->m_controller->getVersion(),
+                         directory);
+    }
+    return latency;
 }
 
 void
@@ -429,10 +440,79 @@ RubyPort::MemSlavePort::recvFunctional(PacketPtr pkt)
     }
 }
 
+bool
+RubyPort::MemSlavePort::functionalReadRange(Addr addr, uint8_t *p, int size)
+{
+    RubyPort *rp = static_cast<RubyPort *>(&owner);
+    RubySystem *rs = rp->m_ruby_system;
+
+    if (size <= 0)
+        return true;
+    if (!isPhysMemAddress(addr) || !isPhysMemAddress(addr + size - 1))
+        return false;
+
+    if (access_backing_store) {
+        if (!AddrRange(addr, addr + size - 1).isSubset(
+                rs->getPhysMem()->getAddrRange()))
+            return false;
+        Request req(addr, size, 0, Request::funcMasterId);
+        Packet pkt(&req, MemCmd::ReadReq);
+        pkt.dataStatic(p);
+        rs->getPhysMem()->functionalAccess(&pkt);
+        return true;
+    }
+
+    const uint8_t *host = rp->backingStoreAddr(addr, size);
+    return host && rs->functionalReadRange(addr, p, size, host);
+}
+
+bool
+RubyPort::MemSlavePort::functionalWriteRange(Addr addr, const uint8_t *p,
+                                             int size)
+{
+    RubyPort *rp = static_cast<RubyPort *>(&owner);
+    RubySystem *rs = rp->m_ruby_system;
+
+    if (size <= 0)
+        return true;
+    if (!isPhysMemAddress(addr) || !isPhysMemAddress(addr + size - 1))
+        return false;
+
+    if (access_backing_store) {
+        if (!AddrRange(addr, addr + size - 1).isSubset(
+                rs->getPhysMem()->getAddrRange()))
+            return false;
+        Request req(addr, size, 0, Request::funcMasterId);
+        Packet pkt(&req, MemCmd::WriteReq);
+        pkt.dataStaticConst(p);
+        rs->getPhysMem()->functionalAccess(&pkt);
+        return true;
+    }
+
+    uint8_t *host = rp->backingStoreAddr(addr, size);
+    return host && rs->functionalWriteRange(addr, p, size, host);
+}
+
+uint8_t *
+RubyPort::backingStoreAddr(Addr addr, int size) const
+{
+    AddrRange range(addr, addr + size - 1);
+    for (const auto &entry : m_backing_store) {
+        if (entry.inAddrMap && range.isSubset(entry.range))
+            return entry.pmem + (addr - entry.range.start());
+    }
+    return NULL;
+}
+
 // [SafeSpec] On the way from Ruby to CPU
 void
 RubyPort::ruby_hit_callback(PacketPtr pkt)
 {
+    // Responses reach the CPUs at the end of the tick when the
+    // controllers are evaluated in parallel
+    if (DeferredEffects::defer([this, pkt]{ ruby_hit_callback(pkt); }))
+        return;
+
     DPRINTF(RubyPort, "Hit callback for %s 0x%x\n", pkt->cmdString(),
             pkt->getAddr());
 
@@ -482,6 +562,9 @@ RubyPort::trySendRetries()
 void
 RubyPort::testDrainComplete()
 {
+    if (DeferredEffects::defer([this]{ testDrainComplete(); }))
+        return;
+
     //If we weren't able to drain before, we might be able to now.
     if (drainState() == DrainState::Draining) {
         unsigned int drainCount = outstandingCount();
@@ -607,6 +690,12 @@ RubyPort::MemSlavePort::isPhysMemAddress(Addr addr) const
 void
 RubyPort::ruby_eviction_callback(Addr address, bool external)
 {
+    if (DeferredEffects::defer([this, address, external]{
+                ruby_eviction_callback(address, external);
+            })) {
+        return;
+    }
+
     DPRINTF(RubyPort, "Sending invalidations.\n");
     // Allocate the invalidate request and packet on the stack, as it is
     // assumed they will not be modified or deleted by receivers.
@@ -44,12 +44,15 @@
 
 #include <cassert>
 #include <string>
+#include <vector>
 
 #include "mem/protocol/RequestStatus.hh"
 #include "mem/ruby/common/MachineID.hh"
 #include "mem/ruby/network/MessageBuffer.hh"
 #include "mem/ruby/system/RubySystem.hh"
 #include "mem/mem_object.hh"
+#include "mem/physical.hh"
+#include "mem/port_proxy.hh"
 #include "mem/tport.hh"
 #include "params/RubyPort.hh"
 
@@ -72,7 +75,8 @@ class RubyPort : public MemObject
         void recvRangeChange() {}
     };
 
-    class MemSlavePort : public QueuedSlavePort
+    class MemSlavePort : public QueuedSlavePort,
+                         public FunctionalRangeInterface
     {
       private:
         RespPacketQueue queue;
@@ -93,6 +97,10 @@ class RubyPort : public MemObject
 
         void recvFunctional(PacketPtr pkt);
 
+        bool functionalReadRange(Addr addr, uint8_t *p, int size) override;
+        bool functionalWriteRange(Addr addr, const uint8_t *p,
+                                  int size) override;
+
         AddrRangeList getAddrRanges() const
         { AddrRangeList ranges; return ranges; }
 
@@ -184,12 +192,17 @@ class RubyPort : public MemObject
      */
     bool recvTimingResp(PacketPtr pkt, PortID master_port_id);
 
+    //! Host memory of [addr, addr + size) in the backing store of the
+    //! system, NULL if the range is not contiguous in it
+    uint8_t *backingStoreAddr(Addr addr, int size) const;
+
     RubySystem *m_ruby_system;
     uint32_t m_version;
     AbstractController* m_controller;
     MessageBuffer* m_mandatory_q_ptr;
     bool m_usingRubyTester;
     System* system;
+    const std::vector<BackingStoreEntry> m_backing_store;
 
     std::vector<MemSlavePort *> slave_ports;
 
@@ -31,8 +31,11 @@
 #include <fcntl.h>
 #include <zlib.h>
 
+#include <algorithm>
 #include <cstdio>
+#include <cstring>
 #include <list>
+#include <vector>
 
 #include "base/intmath.hh"
 #include "base/statistics.hh"
@@ -40,6 +43,8 @@
 #include "debug/RubySystem.hh"
 #include "mem/ruby/common/Address.hh"
 #include "mem/ruby/network/Network.hh"
+#include "mem/ruby/system/ControllerScheduler.hh"
+#include "mem/ruby/system/PresenceFilter.hh"
 #include "mem/simple_mem.hh"
 #include "sim/eventq.hh"
 #include "sim/simulate.hh"
@@ -58,7 +63,11 @@ bool RubySystem::m_cooldown_enabled = false;
 
 RubySystem::RubySystem(const Params *p)
     : ClockedObject(p), m_access_backing_store(p->access_backing_store),
-      m_cache_recorder(NULL)
+      m_warm_state_file(p->warm_state),
+      m_warm_snapshot(NULL),
+      m_controller_threads(p->controller_threads),
+      m_controller_check(p->controller_check),
+      m_controller_scheduler(NULL), m_presence(NULL), m_cache_recorder(NULL)
 {
     m_randomization = p->randomization;
 
@@ -75,6 +84,9 @@ RubySystem::RubySystem(const Params *p)
     // Create the profiler
     m_profiler = new Profiler(p, this);
     m_phys_mem = p->phys_mem;
+
+    if (p->functional_filter && !m_access_backing_store)
+        m_presence = new PresenceFilter(m_block_size_bits);
 }
 
 void
@@ -94,8 +106,11 @@ RubySystem::registerAbstractController(AbstractController* cntrl)
 
 RubySystem::~RubySystem()
 {
+    delete m_controller_scheduler;
     delete m_network;
     delete m_profiler;
+    delete m_warm_snapshot;
+    delete m_presence;
 }
 
 void
@@ -144,6 +159,11 @@ RubySystem::memWriteback()
     }
     DPRINTF(RubyCacheTrace, "Cache Trace Complete\n");
 
+    delete m_warm_snapshot;
+    m_warm_snapshot = new WarmupSnapshot(getBlockSizeBytes());
+    for (auto cntrl : m_abs_cntrl_vec)
+        cntrl->recordWarmState(m_warm_snapshot);
+
     // save the current tick value
     Tick curtick_original = curTick();
     DPRINTF(RubyCacheTrace, "Recording current tick %ld\n", curtick_original);
@@ -257,6 +277,14 @@ RubySystem::serialize(CheckpointOut &cp) const
 
     SERIALIZE_SCALAR(cache_trace_file);
     SERIALIZE_SCALAR(cache_trace_size);
+
+    // The warm-state snapshot can be loaded in any configuration, see
+    // the warm_state parameter.
+    if (m_warm_snapshot != NULL) {
+        string warm_state_file = name() + ".warm.gz";
+        m_warm_snapshot->write(CheckpointIn::dir() + "/" + warm_state_file);
+        SERIALIZE_SCALAR(warm_state_file);
+    }
 }
 
 void
@@ -268,6 +296,8 @@ RubySystem::drainResume()
         delete m_cache_recorder;
         m_cache_recorder = NULL;
     }
+    delete m_warm_snapshot;
+    m_warm_snapshot = NULL;
 }
 
 void
@@ -312,6 +342,10 @@ RubySystem::unserialize(CheckpointIn &cp)
     uint64_t block_size_bytes = getBlockSizeBytes();
     UNSERIALIZE_OPT_SCALAR(block_size_bytes);
 
+    // The caches are loaded from the snapshot at startup instead
+    if (!m_warm_state_file.empty())
+        return;
+
     string cache_trace_file;
     uint64_t cache_trace_size = 0;
 
@@ -376,9 +410,193 @@ RubySystem::startup()
         resetClock();
     }
 
+    if (!m_warm_state_file.empty())
+        loadWarmState(m_warm_state_file);
+
+    // Only trace the simulation itself, not the warmup above
+    m_profiler->startAddressTrace();
+
+    // The warmup above is always evaluated serially
+    if (m_controller_threads > 0) {
+        m_controller_scheduler = new ControllerScheduler(
+            name() + ".controllerScheduler", this, m_controller_threads,
+            m_controller_check);
+        for (auto cntrl : m_abs_cntrl_vec) {
+            if (cntrl->parallelSafe())
+                m_controller_scheduler->attach(cntrl);
+        }
+    }
+
     resetStats();
 }
 
+void
+RubySystem::loadWarmState(const string &filename)
+{
+    WarmupSnapshot snapshot;
+    snapshot.read(filename);
+
+    // As for the cache trace, lines can be split into smaller ones but
+    // not merged into larger ones.
+    uint32_t block_size = getBlockSizeBytes();
+    if (snapshot.getBlockSizeBytes() < block_size) {
+        fatal("Warm-state snapshot block size (%d) < current block size "
+              "(%d)\n", snapshot.getBlockSizeBytes(), block_size);
+    }
+
+    // Lines of cores this system does not have stay in the shared caches
+    int num_cores = 0;
+    for (auto cntrl : m_abs_cntrl_vec) {
+        if (cntrl->getCPUSequencer() != NULL)
+            num_cores++;
+    }
+
+    uint64_t num_loaded = 0;
+    uint64_t num_skipped = 0;
+    uint64_t num_ignored = 0;
+    Addr last_written = MaxAddr;
+
+    for (size_t i = 0; i < snapshot.size(); ++i) {
+        const WarmupSnapshot::Record &rec = snapshot.record(i);
+        int owner = rec.owner < num_cores ? rec.owner : -1;
+
+        for (uint32_t offset = 0; offset < snapshot.getBlockSizeBytes();
+             offset += block_size) {
+            Addr line = rec.address + offset;
+            uint8_t *bytes = const_cast<uint8_t *>(snapshot.data(i)) + offset;
+
+            // Bring memory up to date first, so that the caches can be
+            // loaded with clean copies of the lines.
+            if (line != last_written) {
+                Request req(line, block_size, 0, Request::funcMasterId);
+                Packet pkt(&req, MemCmd::WriteReq);
+                pkt.dataStatic(bytes);
+                functionalWrite(&pkt);
+                last_written = line;
+            }
+
+            if (!functionalWarmupAvail(line, rec.state, owner)) {
+                num_skipped++;
+                continue;
+            }
+
+            if (functionalWarmup(line, rec.state, owner, bytes))
+                num_loaded++;
+            else
+                num_ignored++;
+        }
+    }
+
+    DPRINTF(RubyCacheTrace, "Warm-state snapshot %s: %d lines loaded, %d "
+            "did not fit, %d not supported\n", filename, num_loaded,
+            num_skipped, num_ignored);
+    if (num_loaded == 0 && snapshot.size() != 0) {
+        warn("No line of warm-state snapshot %s could be loaded, the "
+             "protocol may not support functional warmup\n", filename);
+    }
+}
+
+bool
+RubySystem::functionalWarmupAvail(Addr line, WarmState state, int owner)
+{
+    for (auto cntrl : m_abs_cntrl_vec) {
+        if (!cntrl->functionalWarmupAvail(line, state, owner))
+            return false;
+    }
+    return true;
+}
+
+bool
+RubySystem::functionalWarmup(Addr line, WarmState state, int owner,
+                             const uint8_t *bytes)
+{
+    DataBlock data;
+    data.setData(bytes, 0, getBlockSizeBytes());
+
+    bool stored = false;
+    for (auto cntrl : m_abs_cntrl_vec) {
+        if (cntrl->functionalWarmup(line, state, owner, data))
+            stored = true;
+    }
+    if (stored && m_presence)
+        m_presence->insert(line);
+    return stored;
+}
+
+void
+RubySystem::atomicWarmup(PacketPtr pkt, int owner, AbstractController *dir)
+{
+    uint32_t block_size = getBlockSizeBytes();
+    Addr line = makeLineAddress(pkt->getAddr());
+    vector<uint8_t> bytes(block_size);
+
+    // The directory has already performed the access on memory
+    Request req(line, block_size, 0, Request::funcMasterId);
+    Packet mem_pkt(&req, MemCmd::ReadReq);
+    mem_pkt.dataStatic(bytes.data());
+    dir->functionalMemoryRead(&mem_pkt);
+
+    if (pkt->isWrite()) {
+        // Copies of the line already in the caches must see the write
+        Packet wr_pkt(&req, MemCmd::WriteReq);
+        wr_pkt.dataStatic(bytes.data());
+        for (auto cntrl : m_abs_cntrl_vec)
+            cntrl->functionalWrite(line, &wr_pkt);
+    }
+
+    WarmState state = pkt->req->isInstFetch() ? WarmState_Instruction :
+        pkt->isWrite() ? WarmState_Exclusive : WarmState_Shared;
+
+    // Each eviction makes room in one controller at least
+    for (unsigned evictions = 0;
+         !functionalWarmupAvail(line, state, owner);
+         ++evictions) {
+        if (evictions == m_abs_cntrl_vec.size() ||
+            !functionalWarmupEvict(line, state, owner)) {
+            return;
+        }
+    }
+    functionalWarmup(line, state, owner, bytes.data());
+}
+
+bool
+RubySystem::functionalWarmupEvict(Addr line, WarmState state, int owner)
+{
+    uint32_t block_size = getBlockSizeBytes();
+
+    for (auto cntrl : m_abs_cntrl_vec) {
+        Addr victim = cntrl->functionalWarmupVictim(line, state, owner);
+        if (victim == line)
+            continue;
+
+        // Write the newest copy of the victim back to memory
+        vector<uint8_t> bytes(block_size);
+        Request req(victim, block_size, 0, Request::funcMasterId);
+        Packet rd_pkt(&req, MemCmd::ReadReq);
+        rd_pkt.dataStatic(bytes.data());
+        if (!functionalReadLine(&rd_pkt))
+            return false;
+
+        MachineID dir_id = cntrl->mapAddressToMachine(victim,
+                                                      MachineType_Directory);
+        Packet wr_pkt(&req, MemCmd::WriteReq);
+        wr_pkt.dataStatic(bytes.data());
+        m_abstract_controls[dir_id.getType()][dir_id.getNum()]->
+            functionalMemoryWrite(&wr_pkt);
+
+        DPRINTF(RubySystem, "Warmup of %#x evicts %#x from %s\n", line,
+                victim, cntrl->getMachineID());
+        DataBlock data;
+        data.setData(bytes.data(), 0, block_size);
+        for (auto evicted : m_abs_cntrl_vec)
+            evicted->functionalWarmupEvict(victim, cntrl->getMachineID(),
+                                           data);
+        updatePresence(victim);
+        return true;
+    }
+    return false;
+}
+
 void
 RubySystem::processRubyEvent()
 {
@@ -397,6 +615,14 @@ RubySystem::resetStats()
 
 bool
 RubySystem::functionalRead(PacketPtr pkt)
+{
+    // Controllers may be owned by other threads in parallel mode
+    EventQueue::ScopedLockAll lock_all;
+    return functionalReadLine(pkt);
+}
+
+bool
+RubySystem::functionalReadLine(PacketPtr pkt)
 {
     Addr address(pkt->getAddr());
     Addr line_address = makeLineAddress(address);
@@ -480,6 +706,13 @@ RubySystem::functionalRead(PacketPtr pkt)
 // in the packet.
 bool
 RubySystem::functionalWrite(PacketPtr pkt)
+{
+    EventQueue::ScopedLockAll lock_all;
+    return functionalWriteLine(pkt);
+}
+
+bool
+RubySystem::functionalWriteLine(PacketPtr pkt)
 {
     Addr addr(pkt->getAddr());
     Addr line_addr = makeLineAddress(addr);
@@ -508,6 +741,88 @@ RubySystem::functionalWrite(PacketPtr pkt)
     return true;
 }
 
+bool
+RubySystem::functionalReadRange(Addr addr, uint8_t *p, int size,
+                                const uint8_t *host)
+{
+    EventQueue::ScopedLockAll lock_all;
+
+    DPRINTF(RubySystem, "Functional Read range %#x, %d bytes\n", addr, size);
+
+    Addr end = addr + size;
+    Addr cur = addr;
+    while (cur < end) {
+        // Ruby holds nothing in [cur, present)
+        Addr present = cur;
+        if (m_presence)
+            present = std::max(cur, m_presence->findPresent(cur, end));
+        memcpy(p + (cur - addr), host + (cur - addr), present - cur);
+        if (present == end)
+            break;
+
+        Addr line = makeLineAddress(present);
+        Addr next = std::min(line + getBlockSizeBytes(), end);
+        Request req(present, next - present, 0, Request::funcMasterId);
+        Packet pkt(&req, MemCmd::ReadReq);
+        pkt.dataStatic(p + (present - addr));
+        if (!functionalReadLine(&pkt))
+            return false;
+        updatePresence(line);
+        cur = next;
+    }
+    return true;
+}
+
+bool
+RubySystem::functionalWriteRange(Addr addr, const uint8_t *p, int size,
+                                 uint8_t *host)
+{
+    EventQueue::ScopedLockAll lock_all;
+
+    DPRINTF(RubySystem, "Functional Write range %#x, %d bytes\n", addr, size);
+
+    Addr end = addr + size;
+    Addr cur = addr;
+    while (cur < end) {
+        Addr present = cur;
+        if (m_presence)
+            present = std::max(cur, m_presence->findPresent(cur, end));
+        memcpy(host + (cur - addr), p + (cur - addr), present - cur);
+        if (present == end)
+            break;
+
+        Addr line = makeLineAddress(present);
+        Addr next = std::min(line + getBlockSizeBytes(), end);
+        Request req(present, next - present, 0, Request::funcMasterId);
+        Packet pkt(&req, MemCmd::WriteReq);
+        pkt.dataStaticConst(p + (present - addr));
+        functionalWriteLine(&pkt);
+        updatePresence(line);
+        cur = next;
+    }
+    return true;
+}
+
+void
+RubySystem::updatePresence(Addr line)
+{
+    if (!m_presence)
+        return;
+
+    // The controllers connected to memory hold no data of their own in
+    // stable states, memory is up to date unless a cache has the line
+    for (auto cntrl : m_abs_cntrl_vec) {
+        AccessPermission perm = cntrl->getAccessPermission(line);
+        if (perm == AccessPermission_Busy)
+            return;
+        if (!cntrl->isMemorySide() &&
+            perm != AccessPermission_Invalid &&
+            perm != AccessPermission_NotPresent)
+            return;
+    }
+    m_presence->remove(line);
+}
+
 #ifdef CHECK_COHERENCE
 // This code will check for cases if the given cache block is exclusive in
 // one node and shared in another-- a coherence violation
@@ -41,11 +41,14 @@
 #include "mem/ruby/profiler/Profiler.hh"
 #include "mem/ruby/slicc_interface/AbstractController.hh"
 #include "mem/ruby/system/CacheRecorder.hh"
+#include "mem/ruby/system/WarmupSnapshot.hh"
 #include "params/RubySystem.hh"
 #include "sim/clocked_object.hh"
 
 class Network;
 class AbstractController;
+class ControllerScheduler;
+class PresenceFilter;
 
 class RubySystem : public ClockedObject
 {
@@ -62,6 +65,8 @@ class RubySystem : public ClockedObject
     static bool getWarmupEnabled() { return m_warmup_enabled; }
     static bool getCooldownEnabled() { return m_cooldown_enabled; }
 
+    unsigned getControllerThreads() const { return m_controller_threads; }
+
     SimpleMemory *getPhysMem() { return m_phys_mem; }
     Cycles getStartCycle() { return m_start_cycle; }
     bool getAccessBackingStore() { return m_access_backing_store; }
@@ -90,6 +95,36 @@ class RubySystem : public ClockedObject
     bool functionalRead(Packet *ptr);
     bool functionalWrite(Packet *ptr);
 
+    /**
+     * Functional accesses to a range of memory, e.g., the buffer of a
+     * syscall. The lines Ruby does not hold are copied directly from
+     * or to the backing store of memory, the others are accessed line
+     * by line as above.
+     *
+     * @param host Backing store of addr, the range must be contiguous
+     *             in it.
+     * @return False if a line could not be read.
+     */
+    bool functionalReadRange(Addr addr, uint8_t *p, int size,
+                             const uint8_t *host);
+    bool functionalWriteRange(Addr addr, const uint8_t *p, int size,
+                              uint8_t *host);
+
+    /**
+     * Load the line accessed by an atomic request of a core in its
+     * caches functionally, with the warm-state hooks of the protocol.
+     * A cache with no space for it first evicts the victim of its
+     * replacement policy.
+     *
+     * @param owner Version of the controller of the core.
+     * @param dir Directory of the line, memory is read through it.
+     */
+    void atomicWarmup(PacketPtr pkt, int owner, AbstractController *dir);
+
+    //! Lines Ruby may hold, NULL if functional accesses always go
+    //! through the controllers
+    PresenceFilter *getPresenceFilter() { return m_presence; }
+
     void registerNetwork(Network*);
     void registerAbstractController(AbstractController*);
 
@@ -117,6 +152,28 @@ class RubySystem : public ClockedObject
                                      uint64_t uncompressed_trace_size);
 
     void processRubyEvent();
+
+    bool functionalReadLine(PacketPtr pkt);
+    bool functionalWriteLine(PacketPtr pkt);
+    //! Remove the line from the presence filter if no cache holds it
+    void updatePresence(Addr line);
+
+    /**
+     * Load the caches functionally from a warm-state snapshot. The
+     * controllers store the lines directly in their caches, no request
+     * is simulated.
+     */
+    void loadWarmState(const std::string &filename);
+
+    //! True if all the controllers can take the line
+    bool functionalWarmupAvail(Addr line, WarmState state, int owner);
+    //! Evict the replacement victim of a controller with no space for
+    //! the line, false if none could make room
+    bool functionalWarmupEvict(Addr line, WarmState state, int owner);
+    //! Store the line in the controllers it maps to, false if none did
+    bool functionalWarmup(Addr line, WarmState state, int owner,
+                          const uint8_t *bytes);
+
   private:
     // configuration parameters
     static bool m_randomization;
@@ -129,6 +186,17 @@ class RubySystem : public ClockedObject
     static bool m_cooldown_enabled;
     SimpleMemory *m_phys_mem;
     const bool m_access_backing_store;
+    const std::string m_warm_state_file;
+
+    //! Snapshot of the caches taken by memWriteback() for checkpoints
+    WarmupSnapshot *m_warm_snapshot;
+
+    //! Parallel evaluation of the controllers, see ControllerScheduler
+    const unsigned m_controller_threads;
+    const bool m_controller_check;
+    ControllerScheduler *m_controller_scheduler;
+
+    PresenceFilter *m_presence;
 
     Network* m_network;
     std::vector<AbstractController *> m_abs_cntrl_vec;
@@ -46,8 +46,30 @@ class RubySystem(ClockedObject):
     access_backing_store = Param.Bool(False, "Use phys_mem as the functional \
         store and only use ruby for timing.")
 
+    warm_state = Param.String("", "Warm-state snapshot to load into the \
+        caches at startup, instead of replaying the checkpointed cache trace")
+
+    functional_filter = Param.Bool(False, "Track the lines held in Ruby, \
+        and serve functional accesses to the others from the backing \
+        store; only safe for protocols where only the controllers \
+        connected to memory can hold a line in a stable state without a \
+        cache holding it too, so each protocol config enables it")
+
+    controller_threads = Param.Unsigned(0, "Host threads evaluating the \
+        controllers woken up in the same tick in parallel, for the \
+        protocols that support it and deterministic replacement policies \
+        (0: one event per controller wakeup)")
+    controller_check = Param.Bool(False, "Check that the parallel \
+        evaluation of the controllers gives the same result as a serial \
+        one")
+
     # Profiler related configuration variables
     hot_lines = Param.Bool(False, "")
     all_instructions = Param.Bool(False, "")
+    address_trace = Param.String("", "Stream the requests of the \
+        sequencers and the transitions of the controllers to this gzipped \
+        file in the output directory, see util/ruby_addr_trace.py")
+    address_trace_buffer = Param.Unsigned(16384, "Records buffered per \
+        sequencer or controller before the address trace is written")
     num_of_sequencers = Param.Int("")
     number_of_virtual_networks = Param.Unsigned("")
@@ -41,6 +41,7 @@
 #include "mem/packet.hh"
 #include "mem/protocol/PrefetchBit.hh"
 #include "mem/protocol/RubyAccessMode.hh"
+#include "mem/ruby/common/DeferredEffects.hh"
 #include "mem/ruby/profiler/Profiler.hh"
 #include "mem/ruby/slicc_interface/RubyRequest.hh"
 #include "mem/ruby/system/RubySystem.hh"
@@ -57,7 +58,8 @@ RubySequencerParams::create()
 Sequencer::Sequencer(const Params *p)
     : RubyPort(p), m_IncompleteTimes(MachineType_NUM),
       deadlockCheckEvent([this]{ wakeup(); }, "Sequencer deadlock check"),
-      m_specBuf(33),
+      m_specBuf(p->spec_buffer_size),
+      m_spec_load_merging(p->spec_load_merging),
       specBufferHitEvent([this]{ specBufferHitCallback(); }, "Sequencer spec buffer hit")
 {
     m_outstanding_count = 0;
@@ -78,12 +80,27 @@ Sequencer::Sequencer(const Params *p)
     assert(m_inst_cache_hit_latency > 0);
 
     m_runningGarnetStandalone = p->garnet_standalone;
+    m_addr_trace = NULL;
 }
 
 Sequencer::~Sequencer()
 {
 }
 
+void
+Sequencer::init()
+{
+    RubyPort::init();
+
+    if (AddressTracer *tracer =
+            m_ruby_system->getProfiler()->getAddressTracer()) {
+        std::vector<std::string> types;
+        for (int i = 0; i < RubyRequestType_NUM; i++)
+            types.push_back(RubyRequestType_to_string(RubyRequestType(i)));
+        m_addr_trace = tracer->registerSource(name(), types, {});
+    }
+}
+
 void
 Sequencer::wakeup()
 {
@@ -239,17 +256,18 @@ Sequencer::insertRequest(PacketPtr pkt, RubyRequestType request_type)
             RequestTable::iterator i = r.first;
             i->second = new SequencerRequest(pkt, request_type, curCycle());
             m_outstanding_count++;
-        // comment for disabling MERGING spec load request
-        //} else if (request_type == RubyRequestType_SPEC_LD) {
-            //auto i = m_readRequestTable.find(line_addr);
-            //if (i->second->m_type == RubyRequestType_SPEC_LD) {
-                //DPRINTFR(SpecBuffer, "%10s Merging (idx=%d-%d, addr=%#x) with %d\n", curTick(), pkt->reqIdx, pkt->isFirst()? 0 : 1, printAddress(pkt->getAddr()), i->second->pkt->reqIdx);
-                //i->second->dependentSpecRequests.push_back(pkt);
-                //return RequestStatus_Merged;
-            //} else {
-                //m_load_waiting_on_load++;
-                //return RequestStatus_Aliased;
-            //}
+        } else if (m_spec_load_merging &&
+                   request_type == RubyRequestType_SPEC_LD &&
+                   r.first->second->m_type == RubyRequestType_SPEC_LD) {
+            // [SafeSpec] The data of the outstanding spec load is
+            // delivered to this one too, see readCallback().
+            SequencerRequest *primary = r.first->second;
+            DPRINTFR(SpecBuffer, "%10s Merging (idx=%d-%d, addr=%#x) with %d\n",
+                     curTick(), pkt->reqIdx, pkt->isFirst() ? 0 : 1,
+                     printAddress(pkt->getAddr()), primary->pkt->reqIdx);
+            primary->dependentSpecRequests.push_back(pkt);
+            m_spec_loads_merged++;
+            return RequestStatus_Merged;
         } else {
             // There is an outstanding read request for the cache line
             m_load_waiting_on_load++;
@@ -430,9 +448,19 @@ Sequencer::writeCallback(Addr address, DataBlock& data,
                 initialRequestTime, forwardRequestTime, firstResponseTime);
 }
 
+SBE&
+Sequencer::specBufEntry(int idx)
+{
+    if (idx < 0 || idx >= m_specBuf.size()) {
+        fatal("%s: load queue index %d is out of the spec buffer, "
+              "spec_buffer_size must be at least LQEntries + 1\n",
+              name(), idx);
+    }
+    return m_specBuf[idx];
+}
+
 bool Sequencer::updateSBB(PacketPtr pkt, DataBlock& data, Addr dataAddress) {
-    uint8_t idx = pkt->reqIdx;
-    SBE& sbe = m_specBuf[idx];
+    SBE& sbe = specBufEntry(pkt->reqIdx);
     int blkIdx = pkt->isFirst() ? 0 : 1;
     SBB& sbb = sbe.blocks[blkIdx];
     if (makeLineAddress(sbb.reqAddress) == dataAddress) {
@@ -470,6 +498,7 @@ Sequencer::readCallback(Addr address, DataBlock& data,
         assert(!pkt->onlyAccessSpecBuff());
         DPRINTFR(SpecBuffer, "%10s SPEC_LD callback (idx=%d-%d, addr=%#x)\n", curTick(), pkt->reqIdx, pkt->isFirst()? 0 : 1, printAddress(pkt->getAddr()));
         updateSBB(pkt, data, address);
+        m_spec_load_bytes += RubySystem::getBlockSizeBytes();
         if (!externalHit) {
             pkt->setL1Hit();
         }
@@ -477,8 +506,7 @@ Sequencer::readCallback(Addr address, DataBlock& data,
         DPRINTFR(SpecBuffer, "%10s EXPOSE callback (idx=%d-%d, addr=%#x)\n", curTick(), pkt->reqIdx, pkt->isFirst()? 0 : 1, printAddress(pkt->getAddr()));
     } else if (pkt->isValidate()) {
         DPRINTFR(SpecBuffer, "%10s VALIDATE callback (idx=%d-%d, addr=%#x)\n", curTick(), pkt->reqIdx, pkt->isFirst()? 0 : 1, printAddress(pkt->getAddr()));
-        uint8_t idx = pkt->reqIdx;
-        SBE& sbe = m_specBuf[idx];
+        SBE& sbe = specBufEntry(pkt->reqIdx);
         int blkIdx = pkt->isFirst() ? 0 : 1;
         SBB& sbb = sbe.blocks[blkIdx];
         assert(makeLineAddress(sbb.reqAddress) == address);
@@ -492,6 +520,7 @@ Sequencer::readCallback(Addr address, DataBlock& data,
             // data.print(os);
             // DPRINTFR(SpecBufferValidate, "%s\n", os.str());
             *(pkt->getPtr<uint8_t>()) = 0;
+            m_validate_failures++;
         }
     }
 
@@ -619,7 +648,11 @@ Sequencer::hitCallback(SequencerRequest* srequest, DataBlock& data,
         rs->m_cache_recorder->enqueueNextFetchRequest();
     } else if (RubySystem::getCooldownEnabled()) {
         delete pkt;
-        rs->m_cache_recorder->enqueueNextFlushRequest();
+        // The recorder is shared by all the sequencers
+        if (!DeferredEffects::defer([rs]
+                { rs->m_cache_recorder->enqueueNextFlushRequest(); })) {
+            rs->m_cache_recorder->enqueueNextFlushRequest();
+        }
     } else {
         ruby_hit_callback(pkt);
         testDrainComplete();
@@ -648,7 +681,7 @@ Sequencer::makeRequest(PacketPtr pkt)
         assert(pkt->cmd == MemCmd::ReadSpecReq);
         assert(pkt->isSplit || pkt->isFirst());
         uint8_t idx = pkt->reqIdx;
-        SBE& sbe = m_specBuf[idx];
+        SBE& sbe = specBufEntry(idx);
         sbe.isSplit = pkt->isSplit;
         int blkIdx = pkt->isFirst() ? 0 : 1;
         SBB& sbb = sbe.blocks[blkIdx];
@@ -656,7 +689,7 @@ Sequencer::makeRequest(PacketPtr pkt)
         sbb.reqSize = pkt->getSize();
         if (pkt->onlyAccessSpecBuff()) {
             int srcIdx = pkt->srcIdx;
-            SBE& srcEntry = m_specBuf[srcIdx];
+            SBE& srcEntry = specBufEntry(srcIdx);
             if (makeLineAddress(sbb.reqAddress) == makeLineAddress(srcEntry.blocks[0].reqAddress)) {
                 sbb.data = srcEntry.blocks[0].data;
             } else if (makeLineAddress(sbb.reqAddress) == makeLineAddress(srcEntry.blocks[1].reqAddress)) {
@@ -668,6 +701,7 @@ Sequencer::makeRequest(PacketPtr pkt)
                    sbb.data.getData(getOffset(sbb.reqAddress), sbb.reqSize),
                    sbb.reqSize);
             m_specRequestQueue.push({pkt, curTick()});
+            m_spec_buf_hits++;
             DPRINTFR(SpecBuffer, "%10s SB Hit (idx=%d, addr=%#x) on (srcIdx=%d)\n", curTick(), idx, printAddress(sbb.reqAddress), srcIdx);
             if (!specBufferHitEvent.scheduled()) {
                 schedule(specBufferHitEvent, clockEdge(Cycles(1)));
@@ -680,8 +714,7 @@ Sequencer::makeRequest(PacketPtr pkt)
     } else if (pkt->isExpose() || pkt->isValidate()) {
         assert(pkt->cmd == MemCmd::ExposeReq || pkt->cmd == MemCmd::ValidateReq);
         assert(pkt->isSplit || pkt->isFirst());
-        uint8_t idx = pkt->reqIdx;
-        SBE& sbe = m_specBuf[idx];
+        SBE& sbe = specBufEntry(pkt->reqIdx);
         sbe.isSplit = pkt->isSplit;
         int blkIdx = pkt->isFirst() ? 0 : 1;
         SBB& sbb = sbe.blocks[blkIdx];
@@ -772,12 +805,17 @@ Sequencer::makeRequest(PacketPtr pkt)
     if (pkt->isSpec()) {
         DPRINTFR(SpecBuffer, "%10s Issuing SPEC_LD (idx=%d-%d, addr=%#x)\n",
                  curTick(), pkt->reqIdx, pkt->isFirst()? 0 : 1, printAddress(pkt->getAddr()));
+        m_spec_loads++;
     } else if (pkt->isExpose()) {
         DPRINTFR(SpecBuffer, "%10s Issuing EXPOSE (idx=%d-%d, addr=%#x)\n",
                  curTick(), pkt->reqIdx, pkt->isFirst()? 0 : 1, printAddress(pkt->getAddr()));
+        m_exposes++;
+        m_expose_bytes += pkt->getSize();
     } else if (pkt->isValidate()) {
         DPRINTFR(SpecBuffer, "%10s Issuing VALIDATE (idx=%d-%d, addr=%#x)\n",
                  curTick(), pkt->reqIdx, pkt->isFirst()? 0 : 1, printAddress(pkt->getAddr()));
+        m_validates++;
+        m_validate_bytes += pkt->getSize();
     }
 
     issueRequest(pkt, secondary_type);
@@ -816,6 +854,11 @@ Sequencer::issueRequest(PacketPtr pkt, RubyRequestType secondary_type)
             printAddress(msg->getPhysicalAddress()),
             RubyRequestType_to_string(secondary_type));
 
+    if (m_addr_trace && !RubySystem::getCooldownEnabled()) {
+        m_addr_trace->recordRequest(curTick(), pkt->getAddr(), pc,
+                                    secondary_type);
+    }
+
     // The Sequencer currently assesses instruction and data cache hit latency
     // for the top-level caches at the beginning of a memory access.
     // TODO: Eventually, this latency should be moved to represent the actual
@@ -906,6 +949,49 @@ Sequencer::regStats()
         .desc("Number of times a load aliased with a pending store")
         .flags(Stats::nozero);
 
+    m_spec_loads
+        .name(name() + ".spec_loads")
+        .desc("Number of spec loads (GETSPEC) issued to the cache")
+        .flags(Stats::nozero);
+    m_spec_loads_merged
+        .name(name() + ".spec_loads_merged")
+        .desc("Number of spec loads merged with an outstanding spec load")
+        .flags(Stats::nozero);
+    m_spec_buf_hits
+        .name(name() + ".spec_buf_hits")
+        .desc("Number of spec loads served by the spec buffer")
+        .flags(Stats::nozero);
+    m_spec_buf_hit_rate
+        .name(name() + ".spec_buf_hit_rate")
+        .desc("Fraction of the spec loads served by the spec buffer")
+        .flags(Stats::nozero);
+    m_spec_buf_hit_rate = m_spec_buf_hits /
+        (m_spec_buf_hits + m_spec_loads + m_spec_loads_merged);
+    m_exposes
+        .name(name() + ".exposes")
+        .desc("Number of exposes issued to the cache")
+        .flags(Stats::nozero);
+    m_validates
+        .name(name() + ".validates")
+        .desc("Number of validations issued to the cache")
+        .flags(Stats::nozero);
+    m_validate_failures
+        .name(name() + ".validate_failures")
+        .desc("Number of validations that found different data")
+        .flags(Stats::nozero);
+    m_spec_load_bytes
+        .name(name() + ".spec_load_bytes")
+        .desc("Bytes moved into the spec buffer by spec loads")
+        .flags(Stats::nozero);
+    m_expose_bytes
+        .name(name() + ".expose_bytes")
+        .desc("Bytes requested by exposes")
+        .flags(Stats::nozero);
+    m_validate_bytes
+        .name(name() + ".validate_bytes")
+        .desc("Bytes requested by validations")
+        .flags(Stats::nozero);
+
     // These statistical variables are not for display.
     // The profiler will collate these across different
     // sequencers and display those collated statistics.
@@ -37,6 +37,7 @@
 #include "mem/protocol/RubyRequestType.hh"
 #include "mem/protocol/SequencerRequestType.hh"
 #include "mem/ruby/common/Address.hh"
+#include "mem/ruby/profiler/AddressTracer.hh"
 #include "mem/ruby/structures/CacheMemory.hh"
 #include "mem/ruby/system/RubyPort.hh"
 #include "params/RubySequencer.hh"
@@ -77,6 +78,7 @@ class Sequencer : public RubyPort
     ~Sequencer();
 
     // Public Methods
+    void init() override;
     void wakeup(); // Used only for deadlock detection
     void resetStats();
     void collateStats();
@@ -186,6 +188,9 @@ class Sequencer : public RubyPort
     RequestStatus insertRequest(PacketPtr pkt, RubyRequestType request_type);
     bool handleLlsc(Addr address, SequencerRequest* request);
 
+    //! [SafeSpec] Spec buffer entry of a load queue index
+    SBE& specBufEntry(int idx);
+
     // Private copy constructor and assignment operator
     Sequencer(const Sequencer& obj);
     Sequencer& operator=(const Sequencer& obj);
@@ -217,10 +222,27 @@ class Sequencer : public RubyPort
     Stats::Scalar m_load_waiting_on_store;
     Stats::Scalar m_load_waiting_on_load;
 
+    //! [SafeSpec] Spec buffer statistics.
+    Stats::Scalar m_spec_loads;
+    Stats::Scalar m_spec_loads_merged;
+    Stats::Scalar m_spec_buf_hits;
+    Stats::Formula m_spec_buf_hit_rate;
+    Stats::Scalar m_exposes;
+    Stats::Scalar m_validates;
+    Stats::Scalar m_validate_failures;
+    //! Bytes moved into the spec buffer by GETSPEC and requested by
+    //! the exposes and validations.
+    Stats::Scalar m_spec_load_bytes;
+    Stats::Scalar m_expose_bytes;
+    Stats::Scalar m_validate_bytes;
+
     int m_coreId;
 
     bool m_runningGarnetStandalone;
 
+    //! Address trace buffer of this sequencer, NULL if not tracing
+    AddressTraceBuffer *m_addr_trace;
+
     //! Histogram for number of outstanding requests per cycle.
     Stats::Histogram m_outstandReqHist;
 
@@ -258,6 +280,7 @@ class Sequencer : public RubyPort
     EventFunctionWrapper deadlockCheckEvent;
 
     std::vector<SBE> m_specBuf;
+    const bool m_spec_load_merging;
     std::queue<std::pair<PacketPtr, Tick>> m_specRequestQueue;
     EventFunctionWrapper specBufferHitEvent;
 };
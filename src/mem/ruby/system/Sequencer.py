@@ -77,6 +77,12 @@ class RubySequencer(RubyPort):
    # id used by protocols that support multiple sequencers per controller
    # 99 is the dummy default value
    coreid = Param.Int(99, "CorePair core id")
+   # [SafeSpec] entries are indexed by the load queue index of the load
+   spec_buffer_size = Param.Unsigned(33,
+       "Number of spec buffer entries, at least the number of load queue "
+       "slots of the core (LQEntries + 1)")
+   spec_load_merging = Param.Bool(True, "Merge spec loads to a line with "
+       "an outstanding spec load instead of retrying them")
 
 class DMASequencer(RubyPort):
    type = 'DMASequencer'
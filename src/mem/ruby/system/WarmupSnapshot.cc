@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2018 The University of Illinois at Urbana-Champaign
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/ruby/system/WarmupSnapshot.hh"
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+
+#include "base/logging.hh"
+
+using namespace std;
+
+const char WarmupSnapshot::magic[8] = { 'R', 'U', 'B', 'Y', 'W', 'A', 'R',
+                                        'M' };
+
+WarmupSnapshot::WarmupSnapshot(uint32_t block_size_bytes)
+    : m_block_size_bytes(block_size_bytes)
+{
+}
+
+void
+WarmupSnapshot::addRecord(Addr line_addr, WarmState state, int owner,
+                          const DataBlock &data)
+{
+    Record rec = { line_addr, owner, state };
+    m_records.push_back(rec);
+
+    const uint8_t *bytes = data.getData(0, m_block_size_bytes);
+    m_data.insert(m_data.end(), bytes, bytes + m_block_size_bytes);
+}
+
+void
+WarmupSnapshot::write(const string &filename)
+{
+    // Shared caches first, so that a line is loaded in the lower levels
+    // of the hierarchy before the private caches.
+    vector<size_t> order(m_records.size());
+    iota(order.begin(), order.end(), 0);
+    stable_sort(order.begin(), order.end(), [this](size_t a, size_t b) {
+        const Record &ra = m_records[a];
+        const Record &rb = m_records[b];
+        if (ra.address != rb.address)
+            return ra.address < rb.address;
+        return ra.owner < rb.owner;
+    });
+
+    gzFile file = gzopen(filename.c_str(), "wb");
+    if (file == NULL)
+        fatal("Can't open warm-state snapshot '%s'\n", filename);
+
+    Header header;
+    memcpy(header.magic, magic, sizeof(magic));
+    header.version = version;
+    header.block_size_bytes = m_block_size_bytes;
+    header.num_records = m_records.size();
+    if (gzwrite(file, &header, sizeof(header)) != sizeof(header))
+        fatal("Write failed on warm-state snapshot '%s'\n", filename);
+
+    for (size_t i : order) {
+        const Record &rec = m_records[i];
+        FileRecord frec = { rec.address, rec.owner, (uint32_t)rec.state };
+        if (gzwrite(file, &frec, sizeof(frec)) != sizeof(frec) ||
+            gzwrite(file, data(i), m_block_size_bytes) != m_block_size_bytes) {
+            fatal("Write failed on warm-state snapshot '%s'\n", filename);
+        }
+    }
+
+    if (gzclose(file))
+        fatal("Close failed on warm-state snapshot '%s'\n", filename);
+}
+
+void
+WarmupSnapshot::read(const string &filename)
+{
+    gzFile file = gzopen(filename.c_str(), "rb");
+    if (file == NULL)
+        fatal("Unable to open warm-state snapshot '%s'\n", filename);
+
+    Header header;
+    if (gzread(file, &header, sizeof(header)) != sizeof(header) ||
+        memcmp(header.magic, magic, sizeof(magic)) != 0) {
+        fatal("'%s' is not a warm-state snapshot\n", filename);
+    }
+    if (header.version != version) {
+        fatal("Warm-state snapshot '%s' has version %d, expected %d\n",
+              filename, header.version, version);
+    }
+
+    m_block_size_bytes = header.block_size_bytes;
+    m_records.resize(header.num_records);
+    m_data.resize(header.num_records * m_block_size_bytes);
+
+    for (size_t i = 0; i < header.num_records; ++i) {
+        FileRecord frec;
+        if (gzread(file, &frec, sizeof(frec)) != sizeof(frec) ||
+            gzread(file, &m_data[i * m_block_size_bytes],
+                   m_block_size_bytes) != m_block_size_bytes) {
+            fatal("Unable to read complete warm-state snapshot '%s'\n",
+                  filename);
+        }
+        if (frec.state >= WarmState_NUM) {
+            fatal("Invalid state %d in warm-state snapshot '%s'\n",
+                  frec.state, filename);
+        }
+
+        Record &rec = m_records[i];
+        rec.address = frec.address;
+        rec.owner = frec.owner;
+        rec.state = (WarmState)frec.state;
+    }
+
+    if (gzclose(file))
+        fatal("Failed to close warm-state snapshot '%s'\n", filename);
+}
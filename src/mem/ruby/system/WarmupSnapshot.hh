@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2018 The University of Illinois at Urbana-Champaign
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * A protocol-neutral snapshot of the contents of the Ruby caches. For
+ * every valid line it records the line address, the class of state the
+ * line is in, the core owning the cache it was found in and the data.
+ * Unlike the CacheRecorder trace, it does not depend on the protocol or
+ * on the number and order of the controllers, and it is loaded
+ * functionally by the controllers instead of being replayed through
+ * the sequencers (see RubySystem::loadWarmState()).
+ */
+
+#ifndef __MEM_RUBY_SYSTEM_WARMUPSNAPSHOT_HH__
+#define __MEM_RUBY_SYSTEM_WARMUPSNAPSHOT_HH__
+
+#include <string>
+#include <vector>
+
+#include "base/types.hh"
+#include "mem/protocol/WarmState.hh"
+#include "mem/ruby/common/DataBlock.hh"
+
+class WarmupSnapshot
+{
+  public:
+    struct Record
+    {
+        Addr address;
+        //! Core of the private cache holding the line, -1 for lines
+        //! found in a shared cache.
+        int owner;
+        WarmState state;
+    };
+
+    explicit WarmupSnapshot(uint32_t block_size_bytes = 0);
+
+    void addRecord(Addr line_addr, WarmState state, int owner,
+                   const DataBlock &data);
+
+    /**
+     * Write the snapshot to a gzipped file. Records are sorted by
+     * address, with the lines of shared caches before the ones of the
+     * private caches.
+     */
+    void write(const std::string &filename);
+    void read(const std::string &filename);
+
+    size_t size() const { return m_records.size(); }
+    const Record &record(size_t i) const { return m_records[i]; }
+    const uint8_t *data(size_t i) const
+    { return &m_data[i * m_block_size_bytes]; }
+
+    uint32_t getBlockSizeBytes() const { return m_block_size_bytes; }
+
+  private:
+    /** File header, followed by the records and their data. */
+    struct Header
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t block_size_bytes;
+        uint64_t num_records;
+    };
+
+    /** A record as stored in the file, followed by its data. */
+    struct FileRecord
+    {
+        uint64_t address;
+        int32_t owner;
+        uint32_t state;
+    };
+
+    static const char magic[8];
+    static const uint32_t version = 1;
+
+    uint32_t m_block_size_bytes;
+    std::vector<Record> m_records;
+    std::vector<uint8_t> m_data;
+};
+
+#endif // __MEM_RUBY_SYSTEM_WARMUPSNAPSHOT_HH__
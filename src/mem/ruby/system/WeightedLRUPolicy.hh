@@ -54,6 +54,7 @@ class WeightedLRUPolicy : public AbstractReplacementPolicy
     int64_t getVictim(int64_t set) const override;
 
     bool useOccupancy() const override { return true; }
+    bool isDeterministic() const override { return true; }
 
     CacheMemory * m_cache;
     int **m_last_occ_ptr;
@@ -68,17 +68,32 @@ bool
 SETranslatingPortProxy::tryReadBlob(Addr addr, uint8_t *p, int size) const
 {
     int prevSize = 0;
+    // Pages contiguous in physical memory are read in one go
+    Addr runAddr = 0;
+    int runSize = 0;
 
     for (ChunkGenerator gen(addr, size, PageBytes); !gen.done(); gen.next()) {
         Addr paddr;
 
-        if (!pTable->translate(gen.addr(),paddr))
+        if (!pTable->translate(gen.addr(),paddr)) {
+            if (runSize)
+                PortProxy::readBlobPhys(runAddr, 0, p + prevSize, runSize);
             return false;
+        }
 
-        PortProxy::readBlobPhys(paddr, 0, p + prevSize, gen.size());
-        prevSize += gen.size();
+        if (runSize && paddr != runAddr + runSize) {
+            PortProxy::readBlobPhys(runAddr, 0, p + prevSize, runSize);
+            prevSize += runSize;
+            runSize = 0;
+        }
+        if (!runSize)
+            runAddr = paddr;
+        runSize += gen.size();
     }
 
+    if (runSize)
+        PortProxy::readBlobPhys(runAddr, 0, p + prevSize, runSize);
+
     return true;
 }
 
@@ -95,11 +110,19 @@ SETranslatingPortProxy::tryWriteBlob(Addr addr, const uint8_t *p,
                                      int size) const
 {
     int prevSize = 0;
+    Addr runAddr = 0;
+    int runSize = 0;
 
     for (ChunkGenerator gen(addr, size, PageBytes); !gen.done(); gen.next()) {
         Addr paddr;
 
         if (!pTable->translate(gen.addr(), paddr)) {
+            // The pages before are written even if this one faults
+            if (runSize) {
+                PortProxy::writeBlobPhys(runAddr, 0, p + prevSize, runSize);
+                prevSize += runSize;
+                runSize = 0;
+            }
             if (allocating == Always) {
                 process->allocateMem(roundDown(gen.addr(), PageBytes),
                                      PageBytes);
@@ -114,10 +137,19 @@ SETranslatingPortProxy::tryWriteBlob(Addr addr, const uint8_t *p,
             pTable->translate(gen.addr(), paddr);
         }
 
-        PortProxy::writeBlobPhys(paddr, 0, p + prevSize, gen.size());
-        prevSize += gen.size();
+        if (runSize && paddr != runAddr + runSize) {
+            PortProxy::writeBlobPhys(runAddr, 0, p + prevSize, runSize);
+            prevSize += runSize;
+            runSize = 0;
+        }
+        if (!runSize)
+            runAddr = paddr;
+        runSize += gen.size();
     }
 
+    if (runSize)
+        PortProxy::writeBlobPhys(runAddr, 0, p + prevSize, runSize);
+
     return true;
 }
 
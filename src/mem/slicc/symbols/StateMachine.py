@@ -286,10 +286,14 @@ class $py_ident(RubyController):
                 code('#include "mem/protocol/${{var.type.c_ident}}.hh"')
                 seen_types.add(var.type.ident)
 
-        # for adding information to the protocol debug trace
-        code('''
-extern std::stringstream ${ident}_transitionComment;
+        # Controllers of machines declared with parallel="yes" can be
+        # evaluated in parallel with the others woken up in the same tick
+        if "parallel" in self and self["parallel"] == "yes":
+            parallel_safe = "true"
+        else:
+            parallel_safe = "false"
 
+        code('''
 class $c_ident : public AbstractController
 {
   public:
@@ -304,11 +308,13 @@ class $c_ident : public AbstractController
 
     void print(std::ostream& out) const;
     void wakeup();
+    bool parallelSafe() const { return $parallel_safe; }
     void resetStats();
     void regStats();
     void collateStats();
 
     void recordCacheTrace(int cntrl, CacheRecorder* tr);
+    void recordWarmState(WarmupSnapshot *snapshot);
     Sequencer* getCPUSequencer() const;
     GPUCoalescer* getGPUCoalescer() const;
 
@@ -372,6 +378,10 @@ static std::vector<Stats::Vector *> eventVec;
 static std::vector<std::vector<Stats::Vector *> > transVec;
 static int m_num_controllers;
 
+// for adding information to the protocol debug trace, per controller
+// so that controllers can be evaluated in parallel
+std::stringstream m_transitionComment;
+
 // Internal functions
 ''')
 
@@ -502,11 +512,8 @@ int $c_ident::m_num_controllers = 0;
 std::vector<Stats::Vector *>  $c_ident::eventVec;
 std::vector<std::vector<Stats::Vector *> >  $c_ident::transVec;
 
-// for adding information to the protocol debug trace
-stringstream ${ident}_transitionComment;
-
 #ifndef NDEBUG
-#define APPEND_TRANSITION_COMMENT(str) (${ident}_transitionComment << str)
+#define APPEND_TRANSITION_COMMENT(str) (m_transitionComment << str)
 #else
 #define APPEND_TRANSITION_COMMENT(str) do {} while (0)
 #endif
@@ -660,6 +667,19 @@ $c_ident::init()
                 event = "%s_Event_%s" % (self.ident, trans.event.ident)
                 code('possibleTransition($state, $event);')
 
+        code('''
+
+if (AddressTracer *tracer =
+        params()->ruby_system->getProfiler()->getAddressTracer()) {
+    std::vector<std::string> events, states;
+    for (int i = 0; i < ${ident}_Event_NUM; i++)
+        events.push_back(${ident}_Event_to_string(${ident}_Event(i)));
+    for (int i = 0; i < ${ident}_State_NUM; i++)
+        states.push_back(${ident}_State_to_string(${ident}_State(i)));
+    m_addr_trace = tracer->registerSource(name(), events, states);
+}
+''')
+
         code.dedent()
         code('''
     AbstractController::init();
@@ -934,6 +954,21 @@ $c_ident::recordCacheTrace(int cntrl, CacheRecorder* tr)
         code('''
 }
 
+void
+$c_ident::recordWarmState(WarmupSnapshot *snapshot)
+{
+    // Lines of the caches of a core are owned by it
+    int owner M5_VAR_USED = getCPUSequencer() != NULL ? m_version : -1;
+''')
+        code.indent()
+        for param in self.config_parameters:
+            if param.type_ast.type.ident == "CacheMemory":
+                code('m_${{param.ident}}_ptr->recordWarmState(owner, snapshot);')
+
+        code.dedent()
+        code('''
+}
+
 // Actions
 ''')
         if self.TBEType != None and self.EntryType != None:
@@ -1180,8 +1215,8 @@ ${ident}_Controller::wakeup()
 
 #define HASH_FUN(state, event)  ((int(state)*${ident}_Event_NUM)+int(event))
 
-#define GET_TRANSITION_COMMENT() (${ident}_transitionComment.str())
-#define CLEAR_TRANSITION_COMMENT() (${ident}_transitionComment.str(""))
+#define GET_TRANSITION_COMMENT() (m_transitionComment.str())
+#define CLEAR_TRANSITION_COMMENT() (m_transitionComment.str(""))
 
 TransitionResult
 ${ident}_Controller::doTransition(${ident}_Event event,
@@ -1235,6 +1270,9 @@ if (result == TransitionResult_Valid) {
     DPRINTF(RubyGenerated, "next_state: %s\\n",
             ${ident}_State_to_string(next_state));
     countTransition(state, event);
+    if (m_addr_trace && !RubySystem::getCooldownEnabled())
+        m_addr_trace->recordTransition(curTick(), addr, event, state,
+                                       next_state);
 
     DPRINTFR(ProtocolTrace, "%15d %3s %10s%20s %6s>%-6s %#x %s\\n",
              curTick(), m_version, "${ident}",
@@ -102,24 +102,46 @@ def _url_factory(func):
     return wrapper
 
 @_url_factory
-def _textFactory(fn, desc=True):
+def _textFactory(fn, desc=True, skip_zero=False, skip_unchanged=False):
     """Output stats in text format.
 
     Text stat files contain one stat per line with an optional
     description. The description is enabled by default, but can be
     disabled by setting the desc parameter to False.
 
-    Example: text://stats.txt?desc=False
+    Vectors and distributions that are all zero are left out if
+    skip_zero is True. If skip_unchanged is True, stats that haven't
+    been written since the previous dump are left out, which is mostly
+    useful for frequent periodic dumps. Formulas are always printed.
+
+    Example: text://stats.txt?desc=False&skip_zero=True
 
     """
 
-    return _m5.stats.initText(fn, desc)
+    return _m5.stats.initText(fn, desc, skip_zero, skip_unchanged)
+
+@_url_factory
+def _binaryFactory(fn):
+    """Output stats in a binary, column oriented format.
+
+    Binary stat files start with a schema listing the name of every
+    column, followed by one row of doubles per dump. They are much
+    faster to write and to load than text files when stats are dumped
+    frequently. Use m5.stats.binary (or run it as a script) to read
+    them.
+
+    Example: binary://stats.bin
+
+    """
+
+    return _m5.stats.initBinary(fn)
 
 factories = {
     # Default to the text factory if we're given a naked path
     "" : _textFactory,
     "file" : _textFactory,
     "text" : _textFactory,
+    "binary" : _binaryFactory,
 }
 
 def addStatVisitor(url):
@@ -202,6 +224,7 @@ def dump():
 
     _m5.stats.processDumpQueue()
 
+    _m5.stats.beginDump()
     prepare()
 
     for output in outputList:
@@ -211,6 +234,8 @@ def dump():
                 stat.visit(output)
             output.end()
 
+    _m5.stats.endDump()
+
 def reset():
     '''Reset all statistics to the base state'''
 
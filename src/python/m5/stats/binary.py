@@ -0,0 +1,147 @@
+# Copyright (c) 2018 The University of Illinois at Urbana-Champaign
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+"""Reader for stat files written by the binary stats output.
+
+The file starts with a schema naming every column, followed by one
+row of doubles per stats dump (see src/base/stats/binary.hh). This
+module doesn't depend on gem5 and can be used from any Python
+interpreter, or run as a script to print the stats of a file:
+
+  python binary.py m5out/stats.bin [regex]
+"""
+
+import math
+import re
+import struct
+import sys
+
+MAGIC = 'gem5stat'
+VERSION = 1
+BYTE_ORDER = 0x01020304
+
+class BinaryStats(object):
+    """All the dumps of a binary stats file.
+
+    Columns are looked up by name, e.g. stats['sim_ticks'] returns the
+    value of sim_ticks in every dump, and stats.row(i) returns a
+    dictionary of the values of dump i.
+    """
+
+    def __init__(self, filename):
+        f = open(filename, 'rb')
+        try:
+            data = f.read()
+        finally:
+            f.close()
+
+        if data[:8] != MAGIC:
+            raise IOError("%s is not a binary stats file" % filename)
+
+        # The byte order marker tells us the endianness of the writer
+        for endian in '<>':
+            version, marker, ncols = struct.unpack_from(endian + 'III',
+                                                        data, 8)
+            if marker == BYTE_ORDER:
+                break
+        else:
+            raise IOError("%s has an invalid byte order marker" % filename)
+
+        if version != VERSION:
+            raise IOError("%s has unsupported version %d" %
+                          (filename, version))
+
+        offset = 20
+        self.columns = []
+        for i in xrange(ncols):
+            length, = struct.unpack_from(endian + 'H', data, offset)
+            offset += 2
+            self.columns.append(data[offset:offset + length])
+            offset += length
+
+        self.index = dict((name, i) for i, name in enumerate(self.columns))
+
+        row_size = 8 * ncols
+        nrows = (len(data) - offset) // row_size if ncols else 0
+        row_format = endian + 'd' * ncols
+        self.rows = [ struct.unpack_from(row_format, data,
+                                         offset + i * row_size)
+                      for i in xrange(nrows) ]
+
+    def __len__(self):
+        return len(self.rows)
+
+    def __contains__(self, name):
+        return name in self.index
+
+    def __getitem__(self, name):
+        col = self.index[name]
+        return [ row[col] for row in self.rows ]
+
+    def row(self, i):
+        return dict(zip(self.columns, self.rows[i]))
+
+    def match(self, regex):
+        """Names of the columns matching a regular expression."""
+        expr = re.compile(regex)
+        return [ name for name in self.columns if expr.search(name) ]
+
+    def mean(self, dist, i=-1):
+        """Mean of a distribution in dump i."""
+        samples = self[dist + '::samples'][i]
+        if not samples:
+            return float('nan')
+        return self[dist + '::sum'][i] / samples
+
+    def stdev(self, dist, i=-1):
+        """Standard deviation of a distribution in dump i."""
+        samples = self[dist + '::samples'][i]
+        if samples <= 1:
+            return float('nan')
+        total = self[dist + '::sum'][i]
+        squares = self[dist + '::squares'][i]
+        var = (samples * squares - total * total) / (samples * (samples - 1))
+        return math.sqrt(max(var, 0.0))
+
+def main(args):
+    if len(args) not in (1, 2):
+        print >>sys.stderr, 'usage: %s <stats.bin> [regex]' % sys.argv[0]
+        return 1
+
+    stats = BinaryStats(args[0])
+    names = stats.match(args[1]) if len(args) > 1 else stats.columns
+
+    for i in xrange(len(stats)):
+        row = stats.row(i)
+        print '---------- Begin Simulation Statistics ----------'
+        for name in names:
+            print '%-60s %s' % (name, repr(row[name]))
+        print '---------- End Simulation Statistics   ----------'
+        print
+    return 0
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv[1:]))
@@ -32,6 +32,9 @@ from m5.SimObject import SimObject
 from m5.params import *
 from m5.util import fatal
 
+# Data structure used by the main event queues to hold pending events.
+class EventQueueImpl(Enum): vals = ['list', 'calendar']
+
 class Root(SimObject):
 
     _the_instance = None
@@ -67,6 +70,13 @@ class Root(SimObject):
     # Simulation Quantum for multiple main event queue simulation.
     # Needs to be set explicitly for a multi-eventq simulation.
     sim_quantum = Param.Tick(0, "simulation quantum")
+    deterministic_async = Param.Bool(True, "merge events scheduled across "
+        "event queues in an order independent of host thread timing")
+
+    # The calendar queue gives O(1) amortized scheduling, which pays
+    # off when many events are pending (e.g., large multicore systems).
+    eventq_impl = Param.EventQueueImpl('list',
+        "data structure used by the main event queues")
 
     full_system = Param.Bool("if this is a full system simulation")
 
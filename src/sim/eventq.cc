@@ -32,6 +32,7 @@
  *          Steve Raasch
  */
 
+#include <algorithm>
 #include <cassert>
 #include <iostream>
 #include <string>
@@ -59,14 +60,18 @@ uint32_t numMainEventQueues = 0;
 vector<EventQueue *> mainEventQueue;
 __thread EventQueue *_curEventQueue = NULL;
 bool inParallelMode = false;
+bool deterministicAsyncInsertions = true;
+EventQueueImpl defaultEventQueueImpl = EventQueueImpl::List;
 
 EventQueue *
 getEventQueue(uint32_t index)
 {
     while (numMainEventQueues <= index) {
+        EventQueue *eq =
+            new EventQueue(csprintf("MainEventQueue-%d", numMainEventQueues));
+        eq->index(numMainEventQueues);
         numMainEventQueues++;
-        mainEventQueue.push_back(
-            new EventQueue(csprintf("MainEventQueue-%d", index)));
+        mainEventQueue.push_back(eq);
     }
 
     return mainEventQueue[index];
@@ -117,6 +122,11 @@ Event::insertBefore(Event *event, Event *curr)
 void
 EventQueue::insert(Event *event)
 {
+    if (impl == EventQueueImpl::Calendar) {
+        calInsert(event);
+        return;
+    }
+
     // Deal with the head case
     if (!head || *event <= *head) {
         head = Event::insertBefore(event, head);
@@ -176,6 +186,11 @@ EventQueue::remove(Event *event)
 
     assert(event->queue == this);
 
+    if (impl == EventQueueImpl::Calendar) {
+        calRemove(event);
+        return;
+    }
+
     // deal with an event on the head's 'in bin' list (event has the same
     // time as the head)
     if (*head == *event) {
@@ -208,7 +223,9 @@ EventQueue::serviceOne()
     Event *next = head->nextInBin;
     event->flags.clear(Event::Scheduled);
 
-    if (next) {
+    if (impl == EventQueueImpl::Calendar) {
+        calPopHead();
+    } else if (next) {
         // update the next bin pointer since it could be stale
         next->nextBin = head->nextBin;
 
@@ -240,6 +257,247 @@ EventQueue::serviceOne()
     return NULL;
 }
 
+void
+EventQueue::calInsert(Event *event)
+{
+    // Find the bin the event belongs to (or the bin it goes in front
+    // of) within its bucket. Buckets are short on average, so this
+    // is constant time as long as the bucket width is reasonable.
+    const size_t bucket = calBucket(event->when());
+    Event **link = &calBuckets[bucket];
+    while (*link && **link < *event)
+        link = &(*link)->nextBin;
+
+    *link = Event::insertBefore(event, *link);
+    if (!event->nextInBin)
+        ++calNumBins;
+
+    // A new top of the head bin becomes the head of the queue, just
+    // like in the list implementation.
+    if (!head || *event <= *head) {
+        head = event;
+        calCur = bucket;
+        calWindowStart = event->when() - event->when() % calWidth;
+    }
+
+    if (calNumBins > 2 * calBuckets.size())
+        calResize(2 * calBuckets.size());
+}
+
+void
+EventQueue::calRemove(Event *event)
+{
+    Event **link = &calBuckets[calBucket(event->when())];
+    while (*link && **link < *event)
+        link = &(*link)->nextBin;
+
+    if (!*link || **link != *event)
+        panic("event not found!");
+
+    const bool last_in_bin = event == *link && !event->nextInBin;
+    *link = Event::removeItem(event, *link);
+
+    if (last_in_bin)
+        --calNumBins;
+
+    if (event == head) {
+        // Either the next event in the head bin takes over, or the
+        // bin is gone and we need to look for the next one.
+        if (last_in_bin)
+            calFindHead();
+        else
+            head = *link;
+    }
+
+    if (calBuckets.size() > calMinBuckets &&
+        calNumBins < calBuckets.size() / 2)
+        calResize(calBuckets.size() / 2);
+}
+
+void
+EventQueue::calPopHead()
+{
+    assert(calBuckets[calCur] == head);
+
+    Event *next = head->nextInBin;
+    if (next) {
+        // update the next bin pointer since it could be stale
+        next->nextBin = head->nextBin;
+        calBuckets[calCur] = next;
+        head = next;
+        return;
+    }
+
+    calBuckets[calCur] = head->nextBin;
+    --calNumBins;
+    calFindHead();
+
+    if (calBuckets.size() > calMinBuckets &&
+        calNumBins < calBuckets.size() / 2)
+        calResize(calBuckets.size() / 2);
+}
+
+void
+EventQueue::calFindHead()
+{
+    if (calNumBins == 0) {
+        head = NULL;
+        return;
+    }
+
+    // Walk the buckets starting at the current one, looking for a bin
+    // that falls in the current window of its bucket. Nothing pending
+    // can be earlier than the current window, so the first such bin
+    // is the smallest one.
+    const size_t nbuckets = calBuckets.size();
+    size_t bucket = calCur;
+    Tick window = calWindowStart;
+    for (size_t i = 0; i < nbuckets; ++i) {
+        Event *top = calBuckets[bucket];
+        if (top && top->when() >= window && top->when() - window < calWidth) {
+            head = top;
+            calCur = bucket;
+            calWindowStart = window;
+            return;
+        }
+
+        // The next window would start past MaxTick and wrap around
+        if (window > MaxTick - calWidth)
+            break;
+
+        bucket = bucket + 1 == nbuckets ? 0 : bucket + 1;
+        window += calWidth;
+    }
+
+    // All pending bins are more than a calendar year away, or the year
+    // would run past MaxTick. Fall back to a direct search of the first
+    // bin of every bucket.
+    Event *min = NULL;
+    for (size_t i = 0; i < nbuckets; ++i) {
+        Event *top = calBuckets[i];
+        if (top && (!min || *top < *min)) {
+            min = top;
+            bucket = i;
+        }
+    }
+
+    assert(min);
+    head = min;
+    calCur = bucket;
+    calWindowStart = min->when() - min->when() % calWidth;
+}
+
+void
+EventQueue::calResize(size_t nbuckets)
+{
+    calRebuild(sortedBins(), nbuckets);
+}
+
+void
+EventQueue::calRebuild(const std::vector<Event *> &bins, size_t nbuckets)
+{
+    // Estimate a new bucket width from the average separation of the
+    // bins closest to the head of the queue, which are the ones that
+    // will be serviced next. The factor of three comes from Brown's
+    // original calendar queue paper.
+    const size_t samples = std::min<size_t>(bins.size(), 25);
+    Tick span = 0;
+    size_t gaps = 0;
+    for (size_t i = 1; i < samples; ++i) {
+        Tick gap = bins[i]->when() - bins[i - 1]->when();
+        if (gap) {
+            span += gap;
+            ++gaps;
+        }
+    }
+    if (gaps) {
+        Tick gap = span / gaps;
+        calWidth = gap > MaxTick / 3 ? MaxTick : std::max<Tick>(1, 3 * gap);
+    }
+
+    calBuckets.assign(nbuckets, NULL);
+
+    // Pushing the bins in reverse order on the front of their buckets
+    // leaves every bucket sorted.
+    for (auto i = bins.rbegin(); i != bins.rend(); ++i) {
+        Event **bucket = &calBuckets[calBucket((*i)->when())];
+        (*i)->nextBin = *bucket;
+        *bucket = *i;
+    }
+
+    calNumBins = bins.size();
+    if (bins.empty()) {
+        head = NULL;
+        calCur = 0;
+        calWindowStart = 0;
+    } else {
+        head = bins.front();
+        calCur = calBucket(head->when());
+        calWindowStart = head->when() - head->when() % calWidth;
+    }
+}
+
+size_t
+EventQueue::calBucketsFor(size_t nbins)
+{
+    size_t nbuckets = calMinBuckets;
+    while (nbuckets < nbins)
+        nbuckets *= 2;
+    return nbuckets;
+}
+
+std::vector<Event *>
+EventQueue::sortedBins() const
+{
+    std::vector<Event *> bins;
+
+    if (impl == EventQueueImpl::List) {
+        for (Event *bin = head; bin; bin = bin->nextBin)
+            bins.push_back(bin);
+        return bins;
+    }
+
+    bins.reserve(calNumBins);
+    for (Event *bucket : calBuckets) {
+        for (Event *bin = bucket; bin; bin = bin->nextBin)
+            bins.push_back(bin);
+    }
+
+    // Bins are unique in (when, priority), so there are no ties.
+    std::sort(bins.begin(), bins.end(),
+              [](const Event *l, const Event *r) { return *l < *r; });
+    return bins;
+}
+
+Event *
+EventQueue::linkBins(const std::vector<Event *> &bins)
+{
+    Event *next = NULL;
+    for (auto i = bins.rbegin(); i != bins.rend(); ++i) {
+        (*i)->nextBin = next;
+        next = *i;
+    }
+    return next;
+}
+
+void
+EventQueue::setImpl(EventQueueImpl new_impl)
+{
+    if (new_impl == impl)
+        return;
+
+    std::vector<Event *> bins = sortedBins();
+    impl = new_impl;
+
+    if (impl == EventQueueImpl::Calendar) {
+        calRebuild(bins, calBucketsFor(bins.size()));
+    } else {
+        calBuckets.clear();
+        calNumBins = 0;
+        head = linkBins(bins);
+    }
+}
+
 void
 Event::serialize(CheckpointOut &cp) const
 {
@@ -300,15 +558,12 @@ EventQueue::dump() const
     if (empty())
         cprintf("<No Events>\n");
     else {
-        Event *nextBin = head;
-        while (nextBin) {
+        for (Event *nextBin : sortedBins()) {
             Event *nextInBin = nextBin;
             while (nextInBin) {
                 nextInBin->dump();
                 nextInBin = nextInBin->nextInBin;
             }
-
-            nextBin = nextBin->nextBin;
         }
     }
 
@@ -323,8 +578,7 @@ EventQueue::debugVerify() const
     Tick time = 0;
     short priority = 0;
 
-    Event *nextBin = head;
-    while (nextBin) {
+    for (Event *nextBin : sortedBins()) {
         Event *nextInBin = nextBin;
         while (nextInBin) {
             if (nextInBin->when() < time) {
@@ -350,8 +604,6 @@ EventQueue::debugVerify() const
 
             nextInBin = nextInBin->nextInBin;
         }
-
-        nextBin = nextBin->nextBin;
     }
 
     return true;
@@ -360,8 +612,19 @@ EventQueue::debugVerify() const
 Event*
 EventQueue::replaceHead(Event* s)
 {
-    Event* t = head;
-    head = s;
+    if (impl == EventQueueImpl::List) {
+        Event* t = head;
+        head = s;
+        return t;
+    }
+
+    // The calendar does not keep a single list of bins, so hand out
+    // the current contents as one and rebuild from the new list.
+    Event* t = linkBins(sortedBins());
+    std::vector<Event *> bins;
+    for (Event *bin = s; bin; bin = bin->nextBin)
+        bins.push_back(bin);
+    calRebuild(bins, calBucketsFor(bins.size()));
     return t;
 }
 
@@ -413,16 +676,20 @@ Event::dump() const
     }
 }
 
-EventQueue::EventQueue(const string &n)
-    : objName(n), head(NULL), _curTick(0)
+EventQueue::EventQueue(const string &n, EventQueueImpl _impl)
+    : objName(n), head(NULL), _curTick(0), _index(0),
+      impl(EventQueueImpl::List),
+      calWidth(1), calWindowStart(0), calCur(0), calNumBins(0)
 {
+    setImpl(_impl);
 }
 
 void
 EventQueue::asyncInsert(Event *event)
 {
+    EventQueue *source = curEventQueue();
     async_queue_mutex.lock();
-    async_queue.push_back(event);
+    async_queue.emplace_back(source ? source->index() : 0, event);
     async_queue_mutex.unlock();
 }
 
@@ -432,8 +699,17 @@ EventQueue::handleAsyncInsertions()
     assert(this == curEventQueue());
     async_queue_mutex.lock();
 
+    // Events from the same thread are already in program order, so a
+    // stable sort on the source queue makes the order of events that
+    // end up in the same bin independent of the host scheduling.
+    if (deterministicAsyncInsertions) {
+        async_queue.sort([](const std::pair<uint32_t, Event*> &l,
+                            const std::pair<uint32_t, Event*> &r)
+                         { return l.first < r.first; });
+    }
+
     while (!async_queue.empty()) {
-        insert(async_queue.front());
+        insert(async_queue.front().second);
         async_queue.pop_front();
     }
 
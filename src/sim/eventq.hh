@@ -46,6 +46,7 @@
 #include <memory>
 #include <mutex>
 #include <string>
+#include <vector>
 
 #include "base/flags.hh"
 #include "base/types.hh"
@@ -62,6 +63,23 @@ class BaseGlobalEvent;
 //! Queue B should be at least simQuantum ticks away in future.
 extern Tick simQuantum;
 
+/**
+ * Data structure used by an event queue to hold its pending events.
+ *
+ * List keeps the bins of events in a single sorted linked list, which
+ * makes scheduling linear in the number of pending bins. Calendar
+ * hashes the bins into an array of time buckets that is resized as
+ * the queue grows and shrinks, giving O(1) amortized scheduling and
+ * servicing. Both provide exactly the same event ordering.
+ */
+enum class EventQueueImpl {
+    List,
+    Calendar
+};
+
+//! Implementation used by main event queues allocated from now on.
+extern EventQueueImpl defaultEventQueueImpl;
+
 //! Current number of allocated main event queues.
 extern uint32_t numMainEventQueues;
 
@@ -76,6 +94,10 @@ extern __thread EventQueue *_curEventQueue;
 //! Current mode of execution: parallel / serial
 extern bool inParallelMode;
 
+//! Merge events scheduled by other threads in an order that does not
+//! depend on how the host threads were interleaved.
+extern bool deterministicAsyncInsertions;
+
 //! Function for returning eventq queue for the provided
 //! index. The function allocates a new queue in case one
 //! does not exist for the index, provided that the index
@@ -493,11 +515,69 @@ class EventQueue
     Event *head;
     Tick _curTick;
 
+    //! Index of this queue in mainEventQueue.
+    uint32_t _index;
+
+    //! Data structure holding the pending bins of this queue.
+    EventQueueImpl impl;
+
+    /**
+     * @{
+     * Calendar queue state, only used when impl is
+     * EventQueueImpl::Calendar. Bin i holds the sorted list (through
+     * nextBin) of all the event bins whose time falls in a window of
+     * calWidth ticks that maps to i modulo the number of buckets. The
+     * head of the queue is always the first bin of bucket calCur,
+     * whose current window starts at calWindowStart.
+     */
+    std::vector<Event *> calBuckets;
+    Tick calWidth;
+    Tick calWindowStart;
+    size_t calCur;
+    size_t calNumBins;
+    /** @} */
+
+    //! Minimum number of buckets in the calendar.
+    static const size_t calMinBuckets = 4;
+
+    size_t
+    calBucket(Tick when) const
+    {
+        return (when / calWidth) % calBuckets.size();
+    }
+
+    //! Calendar queue insertion / removal of a single event.
+    void calInsert(Event *event);
+    void calRemove(Event *event);
+
+    //! Remove the head event of the calendar and find the new head.
+    void calPopHead();
+
+    //! Scan the calendar for the smallest bin and make it the head.
+    void calFindHead();
+
+    //! Redistribute the bins over a calendar with nbuckets buckets.
+    void calResize(size_t nbuckets);
+
+    //! Rebuild the calendar from a sorted list of bins, re-estimating
+    //! the bucket width from the bins at the front of the queue.
+    void calRebuild(const std::vector<Event *> &bins, size_t nbuckets);
+
+    //! Number of buckets to use for a calendar holding nbins bins.
+    static size_t calBucketsFor(size_t nbins);
+
+    //! Return the tops of all the pending bins in time order.
+    std::vector<Event *> sortedBins() const;
+
+    //! Thread the given sorted bins into a nextBin linked list.
+    static Event *linkBins(const std::vector<Event *> &bins);
+
     //! Mutex to protect async queue.
     std::mutex async_queue_mutex;
 
-    //! List of events added by other threads to this event queue.
-    std::list<Event*> async_queue;
+    //! List of events added by other threads to this event queue,
+    //! tagged with the index of the queue that scheduled them.
+    std::list<std::pair<uint32_t, Event*>> async_queue;
 
     /**
      * Lock protecting event handling.
@@ -575,6 +655,44 @@ class EventQueue
         bool doMigrate;
     };
 
+    /**
+     * Temporarily take the service locks of all the main event queues.
+     *
+     * While an instance of this class is alive no other thread is
+     * servicing events, so state owned by objects on other queues can
+     * be accessed safely (e.g., for functional accesses that walk the
+     * whole memory system). The current queue is released first and
+     * the locks are then taken in queue order, which prevents
+     * deadlocks with other threads doing the same. This does nothing
+     * when not running in parallel mode.
+     */
+    class ScopedLockAll
+    {
+      public:
+        ScopedLockAll()
+            : eq(curEventQueue()), doLock(inParallelMode && eq)
+        {
+            if (doLock) {
+                eq->unlock();
+                for (uint32_t i = 0; i < numMainEventQueues; ++i)
+                    mainEventQueue[i]->lock();
+            }
+        }
+
+        ~ScopedLockAll()
+        {
+            if (doLock) {
+                for (uint32_t i = numMainEventQueues; i > 0; --i)
+                    mainEventQueue[i - 1]->unlock();
+                eq->lock();
+            }
+        }
+
+      private:
+        EventQueue *eq;
+        bool doLock;
+    };
+
     /**
      * Temporarily release the event queue service lock.
      *
@@ -602,9 +720,22 @@ class EventQueue
         EventQueue &eq;
     };
 
-    EventQueue(const std::string &n);
+    EventQueue(const std::string &n,
+               EventQueueImpl _impl = defaultEventQueueImpl);
 
     virtual const std::string name() const { return objName; }
+
+    //! Data structure currently used to hold pending events.
+    EventQueueImpl getImpl() const { return impl; }
+
+    uint32_t index() const { return _index; }
+    void index(uint32_t i) { _index = i; }
+
+    /**
+     * Switch to another data structure for the pending events. Events
+     * that are already scheduled are moved over and keep their order.
+     */
+    void setImpl(EventQueueImpl new_impl);
     void name(const std::string &st) { objName = st; }
 
     //! Schedule the given event on this queue. Safe to call from any
@@ -676,7 +807,9 @@ class EventQueue
      *  function for replacing the head of the event queue, so that a
      *  different set of events can run without disturbing events that have
      *  already been scheduled. Already scheduled events can be processed
-     *  by replacing the original head back.
+     *  by replacing the original head back. With the calendar
+     *  implementation the events are handed out and taken back as a
+     *  list of bins linked through nextBin.
      *  USING THIS FUNCTION CAN BE DANGEROUS TO THE HEALTH OF THE SIMULATOR.
      *  NOT RECOMMENDED FOR USE.
      */
@@ -116,6 +116,12 @@ Root::Root(RootParams *p)
     lastTime.setTimer();
 
     simQuantum = p->sim_quantum;
+    deterministicAsyncInsertions = p->deterministic_async;
+
+    defaultEventQueueImpl = p->eventq_impl == Enums::calendar ?
+        EventQueueImpl::Calendar : EventQueueImpl::List;
+    for (uint32_t i = 0; i < numMainEventQueues; ++i)
+        mainEventQueue[i]->setImpl(defaultEventQueueImpl);
 }
 
 void
@@ -371,6 +371,8 @@ System::validKvmEnvironment() const
 Addr
 System::allocPhysPages(int npages)
 {
+    std::lock_guard<std::mutex> lock(pagePtrMutex);
+
     Addr return_addr = pagePtr << PageShift;
     pagePtr += npages;
 
@@ -47,6 +47,7 @@
 #ifndef __SYSTEM_HH__
 #define __SYSTEM_HH__
 
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -211,6 +212,9 @@ class System : public MemObject
 
     Addr pagePtr;
 
+    /** Protects pagePtr when processes run on different event queues. */
+    std::mutex pagePtrMutex;
+
     uint64_t init_param;
 
     /** Port to physical memory used for writing object files into ram at
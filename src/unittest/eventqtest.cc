@@ -0,0 +1,224 @@
+/*
+ * Copyright (c) 2018 The University of Illinois at Urbana-Champaign
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Checks that the list and calendar event queue implementations
+ * service events in exactly the same order, and compares how fast
+ * they are with a large number of pending events.
+ */
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "sim/eventq_impl.hh"
+#include "unittest/unittest.hh"
+
+using namespace std;
+
+namespace {
+
+/** Records its id in a shared trace and optionally reschedules. */
+class TestEvent : public Event
+{
+  public:
+    TestEvent(EventQueue &_eq, vector<int> &_trace, int _id,
+              Priority p, Tick _period = 0)
+        : Event(p), eq(_eq), trace(_trace), id(_id), period(_period),
+          remaining(0)
+    {}
+
+    void
+    process() override
+    {
+        trace.push_back(id);
+        if (remaining) {
+            --remaining;
+            eq.schedule(this, when() + period);
+        }
+    }
+
+    EventQueue &eq;
+    vector<int> &trace;
+    const int id;
+    const Tick period;
+    unsigned remaining;
+};
+
+/** Run a fixed event pattern on a queue and return the service order. */
+vector<int>
+orderTrace(EventQueueImpl impl)
+{
+    EventQueue eq("orderq", impl);
+    vector<int> trace;
+    vector<TestEvent *> events;
+
+    // Several events sharing the same tick and priority exercise the
+    // LIFO order inside a bin; mixed priorities exercise ordering
+    // within a tick.
+    const Tick whens[] = { 10, 10, 10, 5, 10, 20, 5, 1000000, 10 };
+    const Event::Priority prios[] = { 0, 0, -1, 0, 0, 50, 0, 0, 50 };
+    for (int i = 0; i < 9; ++i) {
+        events.push_back(new TestEvent(eq, trace, i, prios[i]));
+        eq.schedule(events.back(), whens[i]);
+    }
+
+    // Removing from the middle and the front of bins.
+    eq.deschedule(events[1]);
+    eq.deschedule(events[6]);
+    eq.reschedule(events[3], 10);
+
+    while (!eq.empty())
+        eq.serviceOne();
+
+    for (auto e : events) {
+        if (e->scheduled())
+            eq.deschedule(e);
+        delete e;
+    }
+
+    return trace;
+}
+
+/**
+ * Many periodic events with different periods, similar to the clocked
+ * objects of a large system.
+ */
+struct BenchResult
+{
+    vector<int> trace;
+    double seconds;
+};
+
+BenchResult
+bench(EventQueueImpl impl, int num_events, unsigned rounds)
+{
+    EventQueue eq("benchq", impl);
+    BenchResult res;
+    vector<TestEvent *> events;
+    mt19937 rng(1);
+
+    res.trace.reserve(num_events * (rounds + 1));
+    for (int i = 0; i < num_events; ++i) {
+        Tick period = 250 * (1 + rng() % 64);
+        Event::Priority prio = rng() % 3;
+        events.push_back(new TestEvent(eq, res.trace, i, prio, period));
+        events.back()->remaining = rounds;
+        eq.schedule(events.back(), rng() % period);
+    }
+
+    auto start = chrono::steady_clock::now();
+    while (!eq.empty())
+        eq.serviceOne();
+    auto end = chrono::steady_clock::now();
+    res.seconds = chrono::duration<double>(end - start).count();
+
+    for (auto e : events)
+        delete e;
+
+    return res;
+}
+
+} // anonymous namespace
+
+int
+main(int argc, char *argv[])
+{
+    UnitTest::setCase("Same service order for list and calendar queues");
+    {
+        vector<int> list_trace = orderTrace(EventQueueImpl::List);
+        vector<int> cal_trace = orderTrace(EventQueueImpl::Calendar);
+        EXPECT_EQ(list_trace.size(), 7U);
+        EXPECT_TRUE(list_trace == cal_trace);
+    }
+
+    UnitTest::setCase("Switching implementation keeps pending events");
+    {
+        vector<int> trace;
+        EventQueue eq("switchq", EventQueueImpl::List);
+        TestEvent a(eq, trace, 0, 0), b(eq, trace, 1, 0), c(eq, trace, 2, 5);
+        eq.schedule(&a, 100);
+        eq.schedule(&b, 100);
+        eq.schedule(&c, 50);
+        eq.setImpl(EventQueueImpl::Calendar);
+        EXPECT_TRUE(eq.debugVerify());
+        while (!eq.empty())
+            eq.serviceOne();
+        EXPECT_TRUE(trace == vector<int>({ 2, 1, 0 }));
+    }
+
+    UnitTest::setCase("Same service order for events close to MaxTick");
+    {
+        // Bins spread over the whole tick range make the buckets so
+        // wide that a calendar year extends past MaxTick, and the few
+        // bins of a queue switched to a calendar even wider
+        vector<Tick> whens = { 1, MaxTick };
+        for (Tick i = 1; i < 11; ++i)
+            whens.push_back(MaxTick - i * (MaxTick / 11));
+        whens.push_back(MaxTick - 1);
+        whens.push_back(MaxTick);
+
+        vector<int> traces[3];
+        for (int i = 0; i < 3; ++i) {
+            EventQueue eq("maxq", i == 1 ? EventQueueImpl::Calendar :
+                          EventQueueImpl::List);
+            vector<TestEvent *> events;
+            for (size_t j = 0; j < whens.size(); ++j) {
+                events.push_back(new TestEvent(eq, traces[i], j, 0));
+                eq.schedule(events.back(), whens[j]);
+                if (i == 2 && j == 1)
+                    eq.setImpl(EventQueueImpl::Calendar);
+            }
+            EXPECT_TRUE(eq.debugVerify());
+            while (!eq.empty())
+                eq.serviceOne();
+            for (auto e : events)
+                delete e;
+        }
+        EXPECT_EQ(traces[0].size(), whens.size());
+        EXPECT_TRUE(traces[0] == traces[1]);
+        EXPECT_TRUE(traces[0] == traces[2]);
+    }
+
+    UnitTest::setCase("Microbenchmark: list vs. calendar queue");
+    {
+        const int sizes[] = { 16, 256, 4096 };
+        for (int size : sizes) {
+            unsigned rounds = 400000 / size;
+            BenchResult list = bench(EventQueueImpl::List, size, rounds);
+            BenchResult cal = bench(EventQueueImpl::Calendar, size, rounds);
+            EXPECT_TRUE(list.trace == cal.trace);
+
+            cout << size << " pending events: list " << list.seconds
+                 << "s, calendar " << cal.seconds << "s" << endl;
+        }
+    }
+
+    return UnitTest::printResults();
+}
@@ -0,0 +1,41 @@
+# Copyright (c) 2018 The University of Illinois at Urbana-Champaign
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# simple-timing-mp-ruby with every core, its sequencer and its L1
+# controller on an event queue of its own (see se.py --parallel-cores).
+# Its reference is the serial run of the same workload, for the
+# architectural statistics only (see serial-stats in its ref dir).
+
+execfile(joinpath(tests_root, 'configs', 'simple-timing-mp-ruby.py'))
+
+Ruby.assign_core_event_queues(system)
+
+# One Ruby cycle is the shortest latency between a core's L1 and the
+# shared part of the hierarchy
+m5.ticks.fixGlobalFrequency()
+root.sim_quantum = m5.ticks.fromSeconds(
+    1.0 / m5.util.convert.toFrequency(options.ruby_clock))
+root.deterministic_async = True
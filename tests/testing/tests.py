@@ -140,8 +140,11 @@ arch_configs = {
 generic_configs = (
     'simple-atomic',
     'simple-atomic-mp',
+    'simple-atomic-fbc',
     'simple-timing',
     'simple-timing-mp',
+    'simple-timing-mp-parallel',
+    'simple-timing-mp-threads',
 
     'minor-timing',
     'minor-timing-mp',
@@ -154,6 +157,7 @@ generic_configs = (
     'memcheck',
     'memtest',
     'memtest-filter',
+    'memtest-functional',
     'tgen-simple-mem',
     'tgen-dram-ctrl',
     'dram-lowp',
@@ -245,6 +249,10 @@ class ClassicTest(Test):
     ref_ignore_files = FileIgnoreList(
         names=(
             "EMPTY",
+            # Configuration of the run to compare the statistics with
+            "serial-config",
+            # Regex of the statistics compared with that run
+            "serial-stats",
         ), rex=(
             # Mercurial sometimes leaves backups when applying MQ patches
             r"\.orig$",
@@ -272,6 +280,28 @@ class ClassicTest(Test):
         self.skip_diff_out = skip or skip_diff_out
         self.skip_diff_stat = skip or skip_diff_stat
 
+        # A test with a serial-config file in its reference directory
+        # compares its statistics with those of a run of the same
+        # workload with the configuration named in the file, e.g., to
+        # check that simulating the cores in parallel gives the same
+        # results as simulating them serially. A serial-stats file
+        # restricts the comparison to the statistics matching the
+        # regex it contains, e.g., the architectural ones when the
+        # timing is not expected to match.
+        serial_file = os.path.join(self.ref_dir, "serial-config")
+        if os.path.exists(serial_file):
+            with open(serial_file) as f:
+                self.serial_tuple = ct._replace(config=f.read().strip())
+            self.serial_dir = os.path.join(output_dir, "serial")
+        else:
+            self.serial_tuple = None
+
+        self.serial_stats = None
+        stats_file = os.path.join(self.ref_dir, "serial-stats")
+        if os.path.exists(stats_file):
+            with open(stats_file) as f:
+                self.serial_stats = f.read().strip()
+
     def ref_files(self):
         ref_dir = os.path.abspath(self.ref_dir)
         for root, dirs, files in os.walk(ref_dir, topdown=False):
@@ -286,15 +316,29 @@ class ClassicTest(Test):
             "/".join(self.config_tuple),
         ]
 
-        return [
+        units = [
             RunGem5(self.gem5, args,
                     ref_dir=self.ref_dir, test_dir=self.output_dir,
                     skip=self.skip_run),
         ]
+        if self.serial_tuple:
+            units.append(
+                RunGem5(self.gem5,
+                        [ self.script, "/".join(self.serial_tuple) ],
+                        ref_dir=self.ref_dir, test_dir=self.serial_dir,
+                        skip=self.skip_run))
+
+        return units
 
     def verify_units(self):
         ref_files = set(self.ref_files())
         units = []
+        if self.serial_tuple:
+            units.append(
+                DiffStatFile(ref_dir=self.serial_dir,
+                             test_dir=self.output_dir,
+                             stats_regex=self.serial_stats,
+                             skip=self.skip_diff_stat))
         if "stats.txt" in ref_files:
             units.append(
                 DiffStatFile(ref_dir=self.ref_dir, test_dir=self.output_dir,
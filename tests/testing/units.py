@@ -264,10 +264,12 @@ class DiffOutFile(TestUnit):
 class DiffStatFile(TestUnit):
     """Test unit comparing two gem5 stat files."""
 
-    def __init__(self, **kwargs):
+    def __init__(self, stats_regex=None, **kwargs):
         super(DiffStatFile, self).__init__("stat_diff", **kwargs)
 
         self.stat_diff = os.path.join(_test_base, "diff-out")
+        # Only the stats matching this regex are compared, if set
+        self.stats_regex = stats_regex
 
     def _run(self):
         STATUS_OK = 0
@@ -276,10 +278,10 @@ class DiffStatFile(TestUnit):
 
         stats = "stats.txt"
 
-        cmd = [
-            self.stat_diff,
-            self.ref_file(stats), self.out_file(stats),
-        ]
+        cmd = [ self.stat_diff ]
+        if self.stats_regex:
+            cmd += [ "-s", self.stats_regex ]
+        cmd += [ self.ref_file(stats), self.out_file(stats) ]
         with ProcessHelper(cmd,
                            stdout=subprocess.PIPE,
                            stderr=subprocess.PIPE) as p:
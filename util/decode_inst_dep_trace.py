@@ -88,6 +88,12 @@
 # 7,35666,1,COMP,3000::,4
 # 8,35670,1,STORE,1748748,4,74,0:,6,3:,7
 # 9,35670,1,COMP,500::,7
+#
+# Traces captured with taint tracing have two more fields, the (repeated)
+# access roots tainting the address of a load/store and 1 for a control
+# instruction:
+# seq_num,[pc],[weight,]type,[p_addr,size,flags,]comp_delay:[rob_dep]:
+# [reg_dep]:[taint_dep]:[control]
 
 import protolib
 import sys
@@ -151,6 +157,7 @@ def main():
     num_packets = 0
     num_regdeps = 0
     num_robdeps = 0
+    num_taintdeps = 0
     packet = inst_dep_record_pb2.InstDepRecord()
 
     # Decode the packet messages until we hit the end of the file
@@ -202,12 +209,24 @@ def main():
             num_regdeps += 1 # No. of packets with atleast 1 register dependency
             for dep in packet.reg_dep:
                 ascii_out.write(',%s' % dep)
+        # Write to file the taint dependencies and the control flag
+        if header.taint:
+            ascii_out.write(':')
+            if packet.taint_dep:
+                num_taintdeps += 1
+                for dep in packet.taint_dep:
+                    ascii_out.write(',%s' % dep)
+            ascii_out.write(':')
+            if packet.control:
+                ascii_out.write('1')
         # New line
         ascii_out.write('\n')
 
     print "Parsed packets:", num_packets
     print "Packets with at least 1 reg dep:", num_regdeps
     print "Packets with at least 1 rob dep:", num_robdeps
+    if header.taint:
+        print "Packets with at least 1 taint dep:", num_taintdeps
 
     # We're done
     ascii_out.close()
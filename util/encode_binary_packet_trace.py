@@ -0,0 +1,112 @@
+#! /usr/bin/env python2
+
+# Copyright (c) 2018 The University of Illinois at Urbana-Champaign
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Converts a protobuf packet trace, as recorded by the communication
+# monitor or written by encode_packet_trace.py, to the binary packet
+# trace format of the traffic generator (see BinaryTraceHeader in
+# src/cpu/testers/traffic_gen/trace_gen.hh). Binary traces are larger
+# but are mapped in memory by the trace player instead of being
+# decompressed and parsed, and they can start playing at any record.
+#
+# Example:
+#
+# util/encode_binary_packet_trace.py m5out/mon.trc.gz mon.bin
+#
+
+import os
+import protolib
+import struct
+import subprocess
+import sys
+
+util_dir = os.path.dirname(os.path.realpath(__file__))
+# Make sure the proto definitions are up to date.
+subprocess.check_call(['make', '--quiet', '-C', util_dir, 'packet_pb2.py'])
+import packet_pb2
+
+MAGIC = 'GEM5PKTB'
+VERSION = 1
+
+# magic, version, record size, tick frequency, number of records
+HEADER = struct.Struct('<8sIIQQ')
+# tick, addr, flags, size, cmd
+RECORD = struct.Struct('<QQQII')
+
+def main():
+    if len(sys.argv) != 3:
+        print "Usage: ", sys.argv[0], " <protobuf input> <binary output>"
+        exit(-1)
+
+    # Open the file in read mode
+    proto_in = protolib.openFileRd(sys.argv[1])
+
+    try:
+        bin_out = open(sys.argv[2], 'wb')
+    except IOError:
+        print "Failed to open ", sys.argv[2], " for writing"
+        exit(-1)
+
+    # Read the magic number in 4-byte Little Endian
+    magic_number = proto_in.read(4)
+
+    if magic_number != "gem5":
+        print "Unrecognized file", sys.argv[1]
+        exit(-1)
+
+    header = packet_pb2.PacketHeader()
+    protolib.decodeMessage(proto_in, header)
+
+    print "Object id:", header.obj_id
+    print "Tick frequency:", header.tick_freq
+
+    # The number of records is filled in once they are all written
+    bin_out.write(HEADER.pack(MAGIC, VERSION, RECORD.size,
+                              header.tick_freq, 0))
+
+    num_packets = 0
+    packet = packet_pb2.Packet()
+
+    # Decode the packet messages until we hit the end of the file
+    while protolib.decodeMessage(proto_in, packet):
+        num_packets += 1
+        flags = packet.flags if packet.HasField('flags') else 0
+        bin_out.write(RECORD.pack(packet.tick, packet.addr, flags,
+                                  packet.size, packet.cmd))
+
+    bin_out.seek(0)
+    bin_out.write(HEADER.pack(MAGIC, VERSION, RECORD.size,
+                              header.tick_freq, num_packets))
+
+    print "Converted packets:", num_packets
+
+    # We're done
+    bin_out.close()
+    proto_in.close()
+
+if __name__ == "__main__":
+    main()
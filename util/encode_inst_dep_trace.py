@@ -88,6 +88,11 @@
 # 7,35666,1,COMP,3000::,4
 # 8,35670,1,STORE,1748748,4,74,0:,6,3:,7
 # 9,35670,1,COMP,500::,7
+#
+# A trace may also have the taint dependencies and control flag fields of
+# traces captured with taint tracing, see decode_inst_dep_trace.py:
+# seq_num,[pc],[weight,]type,[p_addr,size,flags,]comp_delay:[rob_dep]:
+# [reg_dep]:[taint_dep]:[control]
 
 import protolib
 import sys
@@ -136,6 +141,9 @@ def main():
     # Assume the default tick rate
     header.tick_freq = 1000000000
     header.window_size = 120
+    # The lines of a taint trace have five fields
+    lines = ascii_in.readlines()
+    header.taint = bool(lines) and len(lines[0].strip().split(':')) == 5
     protolib.encodeMessage(proto_out, header)
 
     print "Creating enum name,value lookup from proto"
@@ -147,8 +155,9 @@ def main():
     num_records = 0
     # For each line in the ASCII trace, create a packet message and
     # write it to the encoded output
-    for line in ascii_in:
-        inst_info_str, rob_dep_str, reg_dep_str = (line.strip()).split(':')
+    for line in lines:
+        fields = (line.strip()).split(':')
+        inst_info_str, rob_dep_str, reg_dep_str = fields[0:3]
         inst_info_list = inst_info_str.split(',')
         dep_record = DepRecord()
 
@@ -194,6 +203,14 @@ def main():
             if a_dep:
                 dep_record.reg_dep.append(long(a_dep))
 
+        if header.taint:
+            taint_dep_str, control_str = fields[3:5]
+            for a_dep in taint_dep_str.split(','):
+                if a_dep:
+                    dep_record.taint_dep.append(long(a_dep))
+            if control_str:
+                dep_record.control = True
+
         protolib.encodeMessage(proto_out, dep_record)
         num_records += 1
 
@@ -0,0 +1,127 @@
+#! /usr/bin/env python2
+
+# Copyright (c) 2018 The University of Illinois at Urbana-Champaign
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+# Benchmark for garnet2.0 active scheduling.
+#
+# Runs configs/example/garnet_synth_traffic.py with and without
+# --no-garnet-active-scheduling, for each of the given injection rates,
+# checks that the network statistics of both runs are identical and
+# reports the host time of each run.
+#
+# Note that '--' must be used to separate the script options from the
+# M5 binary and the extra garnet_synth_traffic.py options.
+#
+# Example:
+#
+# util/garnet-sched-bench.py -r 0.01,0.1,0.3 -- \
+#      build/Garnet_standalone/gem5.opt --num-cpus=64 --num-dirs=64 \
+#      --mesh-rows=8 --sim-cycles=100000
+#
+
+import os, sys, re
+import subprocess
+import optparse
+
+parser = optparse.OptionParser()
+
+parser.add_option('-d', '--directory', default='garnet-sched-bench')
+parser.add_option('-r', '--rates', default='0.01,0.1,0.3',
+                  help='comma separated injection rates')
+parser.add_option('--config', default='configs/example/garnet_synth_traffic.py')
+parser.add_option('--exact', default='^system\.ruby\.network\.|^sim_ticks',
+                  help='regex of the stats that must be identical')
+
+(options, args) = parser.parse_args()
+
+if len(args) < 1:
+    parser.error('expected the M5 binary after --')
+
+if os.path.exists(options.directory):
+    print 'Error: test directory', options.directory, 'exists'
+    print '       Tester needs to create directory from scratch'
+    sys.exit(1)
+
+top_dir = options.directory
+os.mkdir(top_dir)
+
+m5_binary = args[0]
+m5_args = [ '--network=garnet2.0', '--topology=Mesh_XY' ] + args[1:]
+
+stat_expr = re.compile('^(\S+)\s+([-+0-9.e]+|nan|inf)\s')
+exact_expr = re.compile(options.exact)
+
+def run(name, extra_args):
+    outdir = os.path.join(top_dir, name)
+    print '===> Running %s simulation.' % name
+    status = subprocess.call([m5_binary, '-re', '-d', outdir,
+                              options.config] + m5_args + extra_args)
+    if status != 0:
+        print 'Error: %s simulation failed with status %d' % (name, status)
+        sys.exit(1)
+
+    stats = {}
+    for line in open(os.path.join(outdir, 'stats.txt')):
+        if line.startswith('---------- End Simulation Statistics'):
+            break
+        match = stat_expr.match(line)
+        if match:
+            stats[match.group(1)] = float(match.group(2))
+    return stats
+
+failures = 0
+results = []
+
+for rate in options.rates.split(','):
+    rate_args = [ '--injectionrate=%s' % rate ]
+    active = run('active.%s' % rate, rate_args)
+    legacy = run('events.%s' % rate, rate_args +
+                 [ '--no-garnet-active-scheduling' ])
+
+    for name in sorted(legacy):
+        if not exact_expr.search(name):
+            continue
+        if active.get(name) != legacy[name]:
+            print 'FAIL: %s is %s with active scheduling, %s without ' \
+                  '(rate %s)' % (name, active.get(name), legacy[name], rate)
+            failures += 1
+
+    results.append((rate, legacy.get('host_seconds', 0),
+                    active.get('host_seconds', 0)))
+
+print '%-10s %14s %14s %10s' % ('rate', 'events (s)', 'active (s)', 'speedup')
+for rate, legacy_time, active_time in results:
+    print '%-10s %14.2f %14.2f %9.2fx' % \
+          (rate, legacy_time, active_time,
+           legacy_time / active_time if active_time else 0)
+
+if failures:
+    print '===> %d checks failed.' % failures
+    sys.exit(1)
+
+print '===> All checks passed.'
@@ -0,0 +1,147 @@
+#! /usr/bin/env python2
+
+# Copyright (c) 2018 The University of Illinois at Urbana-Champaign
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Correctness test for parallel (multi event queue) simulation.
+#
+# Given an M5 command line for se.py, this script will:
+# 1. Run the command on a single event queue.
+# 2. Run the command with --parallel-cores (or --parallel-args), a given
+#    number of times.
+# 3. Compare the architectural statistics (committed instructions and
+#    operations) of every run with the single threaded one, and check
+#    that all the parallel runs produced identical statistics.
+# 4. Report the relative difference of the timing statistics (e.g.,
+#    sim_ticks) between the single threaded and the parallel runs.
+#
+# Note that '--' must be used to separate the script options from the
+# M5 command line.
+#
+# Example:
+#
+# util/parallel-tester.py -r 2 -- build/X86_MESI_Two_Level/gem5.opt \
+#      configs/example/se.py --ruby --cpu-type=DerivO3CPU -n 4 \
+#      -c "hello;hello;hello;hello"
+#
+# The parallel evaluation of the Ruby controllers must give the same
+# statistics for any number of threads:
+#
+# util/parallel-tester.py --serial-args=--ruby-controller-threads=1 \
+#      --parallel-args=--ruby-controller-threads=4 --exact='^(?!host_)' \
+#      -- build/X86_MESI_Two_Level/gem5.opt configs/example/se.py ...
+#
+
+import os, sys, re
+import subprocess
+import optparse
+
+parser = optparse.OptionParser()
+
+parser.add_option('-d', '--directory', default='parallel-test')
+parser.add_option('-r', '--repeat', type='int', default=2,
+                  help='number of parallel runs to check for determinism')
+parser.add_option('--exact', default='committedInsts|committedOps|sim_insts'
+                  '|sim_ops', help='regex of the stats that must match the '
+                  'single threaded run exactly')
+parser.add_option('--timing', default='sim_ticks|numCycles',
+                  help='regex of the stats to report the difference of')
+parser.add_option('--serial-args', default='',
+                  help='extra options of the serial run')
+parser.add_option('--parallel-args', default='--parallel-cores',
+                  help='extra options of the parallel runs')
+
+(options, args) = parser.parse_args()
+
+if os.path.exists(options.directory):
+    print 'Error: test directory', options.directory, 'exists'
+    print '       Tester needs to create directory from scratch'
+    sys.exit(1)
+
+top_dir = options.directory
+os.mkdir(top_dir)
+
+m5_binary = args[0]
+m5_args = args[1:]
+
+stat_expr = re.compile('^(\S+)\s+([-+0-9.e]+|nan|inf)\s')
+
+def run(name, extra_args):
+    outdir = os.path.join(top_dir, name)
+    print '===> Running %s simulation.' % name
+    status = subprocess.call([m5_binary, '-re', '-d', outdir] +
+                             m5_args + extra_args)
+    if status != 0:
+        print 'Error: %s simulation failed with status %d' % (name, status)
+        sys.exit(1)
+
+    # Only the first dump is compared
+    stats = {}
+    for line in open(os.path.join(outdir, 'stats.txt')):
+        if line.startswith('---------- End Simulation Statistics'):
+            break
+        match = stat_expr.match(line)
+        if match:
+            stats[match.group(1)] = float(match.group(2))
+    return stats
+
+def select(stats, regex):
+    expr = re.compile(regex)
+    return dict((k, v) for k, v in stats.iteritems() if expr.search(k))
+
+serial = run('serial', options.serial_args.split())
+parallel = [ run('parallel.%d' % i, options.parallel_args.split())
+             for i in range(options.repeat) ]
+
+failures = 0
+
+exact = select(serial, options.exact)
+for i, stats in enumerate(parallel):
+    # Every parallel run must match the first one bit for bit
+    if stats != parallel[0]:
+        diff = [ k for k in stats if stats[k] != parallel[0].get(k) ]
+        print 'FAIL: parallel run %d differs from run 0 in %d stats, ' \
+              'e.g. %s' % (i, len(diff), ', '.join(sorted(diff)[:5]))
+        failures += 1
+
+    for name, value in sorted(exact.iteritems()):
+        if stats.get(name) != value:
+            print 'FAIL: %s is %s in parallel run %d, %s in serial run' % \
+                  (name, stats.get(name), i, value)
+            failures += 1
+
+for name, value in sorted(select(serial, options.timing).iteritems()):
+    par = parallel[0].get(name)
+    if par is None or value == 0:
+        continue
+    print '%-60s serial %14d parallel %14d (%+.3f%%)' % \
+          (name, value, par, 100.0 * (par - value) / value)
+
+if failures:
+    print '===> %d checks failed.' % failures
+    sys.exit(1)
+
+print '===> All checks passed.'
@@ -0,0 +1,230 @@
+#! /usr/bin/env python2
+
+# Copyright (c) 2018 The University of Illinois at Urbana-Champaign
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Offline aggregation of a Ruby address trace, as written by the
+# --ruby-address-trace option (see src/mem/ruby/profiler/AddressTracer.hh).
+#
+# Prints the same kind of profiles as the Ruby AddressProfiler: the hot
+# data blocks, macro blocks and instructions of the requests issued by
+# the sequencers, and the number of times each transition was taken by
+# every type of controller.
+#
+# Example:
+#
+# util/ruby_addr_trace.py -n 20 m5out/addr_trace.gz
+#
+
+import gzip
+import optparse
+import re
+import struct
+import sys
+from collections import defaultdict
+
+MAGIC = 'RUBYATRC'
+VERSION = 1
+
+# tick, addr, pc, kind, type, state, next_state
+RECORD = struct.Struct('<QQQHHHH')
+KIND_REQUEST = 0
+KIND_TRANSITION = 1
+
+class Source(object):
+    def __init__(self, name, types, states):
+        self.name = name
+        self.types = types
+        self.states = states
+        # Controllers of the same type are aggregated together
+        self.group = re.sub(r'\d+$', '', name)
+
+def read_fmt(f, fmt):
+    size = struct.calcsize(fmt)
+    data = f.read(size)
+    if len(data) != size:
+        return None
+    return struct.unpack(fmt, data)
+
+def read_string(f):
+    (length,) = read_fmt(f, '<I')
+    return f.read(length)
+
+def read_strings(f):
+    (count,) = read_fmt(f, '<I')
+    return [ read_string(f) for i in range(count) ]
+
+def read_header(f):
+    if f.read(len(MAGIC)) != MAGIC:
+        raise ValueError('not a Ruby address trace')
+    version, record_size, num_sources = read_fmt(f, '<III')
+    if version != VERSION:
+        raise ValueError('version %d, expected %d' % (version, VERSION))
+    if record_size != RECORD.size:
+        raise ValueError('records of %d bytes, expected %d' %
+                         (record_size, RECORD.size))
+
+    sources = []
+    for i in range(num_sources):
+        name = read_string(f)
+        types = read_strings(f)
+        states = read_strings(f)
+        sources.append(Source(name, types, states))
+    return sources
+
+def records(f, sources):
+    """Yield (source, record) for every record of the trace, in the
+    order the chunks were written."""
+    while True:
+        chunk = read_fmt(f, '<II')
+        if chunk is None:
+            return
+        source_id, count = chunk
+        data = f.read(count * RECORD.size)
+        if len(data) != count * RECORD.size:
+            print >>sys.stderr, 'Warning: truncated trace'
+            return
+        source = sources[source_id]
+        for i in range(count):
+            yield source, RECORD.unpack_from(data, i * RECORD.size)
+
+class AccessTrace(object):
+    """Mirrors AccessTraceForAddress: accesses per type and requestor."""
+    def __init__(self):
+        self.total = 0
+        self.loads = 0
+        self.stores = 0
+        self.ifetches = 0
+        self.requestors = set()
+
+    def update(self, type_name, requestor):
+        self.total += 1
+        if type_name == 'IFETCH':
+            self.ifetches += 1
+        elif type_name in ('ST', 'ATOMIC', 'RMW_Write', 'Locked_RMW_Write'):
+            self.stores += 1
+        else:
+            self.loads += 1
+        self.requestors.add(requestor)
+
+def print_sorted(title, label, traces, options):
+    total = sum(t.total for t in traces.itervalues())
+    print title
+    print '-' * len(title)
+    print '%s_total: %d' % (label, total)
+    print 'unique_entries: %d' % len(traces)
+    print
+
+    hot = sorted(traces.iteritems(), key=lambda x: (-x[1].total, x[0]))
+    print '%-20s %12s %8s %10s %10s %10s %10s' % \
+        (label, 'accesses', '%', 'loads', 'stores', 'ifetches', 'sharers')
+    for addr, t in hot[:options.num]:
+        print '%#-20x %12d %8.3f %10d %10d %10d %10d' % \
+            (addr, t.total, 100.0 * t.total / total if total else 0,
+             t.loads, t.stores, t.ifetches, len(t.requestors))
+    print
+
+def main():
+    parser = optparse.OptionParser(usage='%prog [options] trace.gz')
+    parser.add_option('-n', '--num', type='int', default=20,
+                      help='number of entries printed per profile')
+    parser.add_option('--block-size', type='int', default=64,
+                      help='cache line size in bytes')
+    parser.add_option('--macro-block-size', type='int', default=1024,
+                      help='macro block size in bytes')
+    parser.add_option('--start', type='int', default=0,
+                      help='ignore the records before this tick')
+    parser.add_option('--end', type='int', default=None,
+                      help='ignore the records after this tick')
+    parser.add_option('--no-transitions', action='store_true',
+                      help='skip the controller transition profile')
+
+    (options, args) = parser.parse_args()
+    if len(args) != 1:
+        parser.error('expected a single trace file')
+
+    f = gzip.open(args[0], 'rb')
+    try:
+        sources = read_header(f)
+    except (ValueError, TypeError), e:
+        print >>sys.stderr, 'Error: %s: %s' % (args[0], e)
+        sys.exit(1)
+
+    block_mask = ~(options.block_size - 1)
+    macro_mask = ~(options.macro_block_size - 1)
+
+    data_blocks = defaultdict(AccessTrace)
+    macro_blocks = defaultdict(AccessTrace)
+    pcs = defaultdict(AccessTrace)
+    transitions = defaultdict(lambda: defaultdict(int))
+    request_types = defaultdict(int)
+    num_records = 0
+
+    for source, rec in records(f, sources):
+        tick, addr, pc, kind, type_id, state, next_state = rec
+        if tick < options.start or \
+           (options.end is not None and tick > options.end):
+            continue
+        num_records += 1
+
+        if kind == KIND_REQUEST:
+            type_name = source.types[type_id]
+            request_types[type_name] += 1
+            data_blocks[addr & block_mask].update(type_name, source.name)
+            macro_blocks[addr & macro_mask].update(type_name, source.name)
+            if pc:
+                pcs[pc].update(type_name, source.name)
+        elif kind == KIND_TRANSITION and not options.no_transitions:
+            key = (source.states[state], source.types[type_id],
+                   source.states[next_state])
+            transitions[source.group][key] += 1
+
+    print 'records: %d' % num_records
+    print
+    print 'Request types'
+    print '-------------'
+    for name, count in sorted(request_types.iteritems(),
+                              key=lambda x: -x[1]):
+        print '%-30s %12d' % (name, count)
+    print
+
+    print_sorted('Hot Data Blocks', 'block_address', data_blocks, options)
+    print_sorted('Hot MacroData Blocks', 'macroblock_address', macro_blocks,
+                 options)
+    print_sorted('Hot Instructions', 'pc_address', pcs, options)
+
+    for group in sorted(transitions):
+        title = 'Transitions of %s' % group
+        print title
+        print '-' * len(title)
+        for (state, event, next_state), count in \
+                sorted(transitions[group].iteritems(), key=lambda x: -x[1]):
+            print '%-12s %-24s -> %-12s %12d' % \
+                (state, event, next_state, count)
+        print
+
+if __name__ == '__main__':
+    main()